@@ -1,16 +1,432 @@
 
 #include "src/symbolic4.h"
 
+#ifdef HAS_PTHREADS
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define BATCH_LINE_LENGTH 4096
+#define BATCH_BUFFER_LENGTH 4096
+#define BATCH_OUTPUT_BUFFER_LENGTH 65536
+#define PARALLEL_CHUNK_LENGTH 1048576
+#define PARALLEL_CHUNKS_PER_THREAD 8
+
+/**
+ 
+ @brief Evaluates newline-delimited queries and writes one result line
+ per query
+ 
+ @details
+ All queries are evaluated in the same context, so the allocator is
+ reused between lines. The output is fully buffered and written in
+ blocks. Queries that fail, that don't fit into
+ @c BATCH_LINE_LENGTH or whose result doesn't fit into
+ @c BATCH_BUFFER_LENGTH produce the line "ERROR".
+ 
+ @param[in] input The input stream.
+ @param[in] output The output stream.
+ 
+ @return
+ - 0 if all queries succeeded, 1 otherwise.
+ 
+ */
+int run_batch(FILE* input, FILE* output) {
+    
+    int status = 0;
+    size_t length;
+    int character;
+    char* line = malloc(BATCH_LINE_LENGTH);
+    char* buffer = malloc(BATCH_BUFFER_LENGTH);
+    symbolic4_context* context = new_symbolic4_context();
+    
+    if (line == NULL || buffer == NULL || context == NULL) {
+        free(line);
+        free(buffer);
+        free_symbolic4_context(context);
+        return 1;
+    }
+    
+    setvbuf(output, NULL, _IOFBF, BATCH_OUTPUT_BUFFER_LENGTH);
+    
+    while (fgets(line, BATCH_LINE_LENGTH, input) != NULL) {
+        
+        length = strlen(line);
+        
+        if (length > 0 && line[length - 1] != '\n' && !feof(input)) {
+            while ((character = fgetc(input)) != EOF && character != '\n');
+            fputs("ERROR\n", output);
+            status = 1;
+            continue;
+        }
+        
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        
+        if (symbolic4_ctx_n(context, buffer, BATCH_BUFFER_LENGTH, line) == RETS_SUCCESS) {
+            fputs(buffer, output);
+            fputc('\n', output);
+        } else {
+            fputs("ERROR\n", output);
+            status = 1;
+        }
+        
+    }
+    
+    fflush(output);
+    
+    free_symbolic4_context(context);
+    free(line);
+    free(buffer);
+    
+    return status;
+    
+}
+
+#ifdef HAS_PTHREADS
+
+typedef struct {
+    char* begin;
+    char* end;
+    char* output;
+    size_t output_length;
+    size_t output_capacity;
+    size_t query_count;
+    bool is_done;
+} parallel_chunk;
+
+typedef struct {
+    parallel_chunk* chunks;
+    size_t chunk_count;
+    size_t next_chunk;
+    size_t next_written_chunk;
+    size_t window;
+    size_t running_worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_done;
+    pthread_cond_t chunk_written;
+} parallel_job;
+
+/**
+ 
+ @brief Appends a string to the output of a chunk
+ 
+ @param[in,out] chunk The chunk.
+ @param[in] string The string to append.
+ 
+ */
+void parallel_append(parallel_chunk* chunk, const char* string) {
+    
+    size_t length = strlen(string);
+    
+    if (chunk->output_length + length + 1 > chunk->output_capacity) {
+        chunk->output_capacity = 2 * (chunk->output_length + length + 1);
+        chunk->output = realloc(chunk->output, chunk->output_capacity);
+        if (chunk->output == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    }
+    
+    memcpy(chunk->output + chunk->output_length, string, length);
+    chunk->output_length += length;
+    chunk->output[chunk->output_length++] = '\n';
+    
+}
+
+/**
+ 
+ @brief Evaluates chunks until all chunks have been taken
+ 
+ @details
+ A worker doesn't take a chunk that is more than @c window chunks
+ ahead of the writer, which bounds the memory of the reorder buffer.
+ The lines of a chunk are null-terminated in place in the private
+ mapping of the input file. Results that don't fit into
+ @c BATCH_BUFFER_LENGTH produce the line "ERROR".
+ 
+ @param[in] argument The @c parallel_job.
+ 
+ @return
+ - @c NULL, or the job if the worker couldn't allocate its context. In
+ that case the worker doesn't take any chunks.
+ 
+ */
+void* parallel_run_worker(void* argument) {
+    
+    parallel_job* job = argument;
+    parallel_chunk* chunk;
+    symbolic4_context* context = new_symbolic4_context();
+    char* buffer = malloc(BATCH_BUFFER_LENGTH);
+    char* line;
+    char* line_end;
+    
+    if (context == NULL || buffer == NULL) {
+        free(buffer);
+        free_symbolic4_context(context);
+        pthread_mutex_lock(&job->lock);
+        job->running_worker_count--;
+        pthread_cond_broadcast(&job->chunk_done);
+        pthread_mutex_unlock(&job->lock);
+        return job;
+    }
+    
+    while (true) {
+        
+        pthread_mutex_lock(&job->lock);
+        
+        while (job->next_chunk < job->chunk_count && job->next_chunk >= job->next_written_chunk + job->window) {
+            pthread_cond_wait(&job->chunk_written, &job->lock);
+        }
+        
+        if (job->next_chunk == job->chunk_count) {
+            job->running_worker_count--;
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+        
+        chunk = &job->chunks[job->next_chunk++];
+        pthread_mutex_unlock(&job->lock);
+        
+        for (line = chunk->begin; line < chunk->end; line = line_end + 1) {
+            
+            line_end = memchr(line, '\n', chunk->end - line);
+            if (line_end == NULL) line_end = chunk->end;
+            *line_end = '\0';
+            if (line_end > line && line_end[-1] == '\r') line_end[-1] = '\0';
+            
+            if (symbolic4_ctx_n(context, buffer, BATCH_BUFFER_LENGTH, line) == RETS_SUCCESS) {
+                parallel_append(chunk, buffer);
+            } else {
+                parallel_append(chunk, "ERROR");
+            }
+            
+            chunk->query_count++;
+            
+        }
+        
+        pthread_mutex_lock(&job->lock);
+        chunk->is_done = true;
+        pthread_cond_broadcast(&job->chunk_done);
+        pthread_mutex_unlock(&job->lock);
+        
+    }
+    
+    free(buffer);
+    free_symbolic4_context(context);
+    
+    return NULL;
+    
+}
+
+/**
+ 
+ @brief Reports the throughput of a parallel run on stderr
+ 
+ @param[in] query_count The number of evaluated queries.
+ @param[in] size The size of the query file in bytes.
+ @param[in] start_time The time the run was started at.
+ 
+ */
+void parallel_report(size_t query_count, size_t size, struct timespec start_time) {
+    
+    double seconds;
+    struct timespec end_time;
+    
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+    
+    fprintf(stderr, "%zu queries in %.3f s (%.0f queries/s, %.2f MB/s)\n", query_count, seconds, query_count / seconds, size / seconds / 1e6);
+    
+}
+
+/**
+ 
+ @brief Evaluates a query file on all cores
+ 
+ @details
+ The file is mapped privately into memory and split into line-aligned
+ chunks, which are evaluated by a pool of worker threads. The calling
+ thread writes the results of finished chunks in input order. If the
+ file doesn't end with a newline, the last line is copied, because it
+ can't be null-terminated within the mapping. The throughput is
+ reported on stderr. If no worker could allocate its context, the
+ output stops at the first chunk that wasn't evaluated.
+ 
+ @param[in] path The path of the query file.
+ @param[in] thread_count The number of worker threads.
+ @param[in] output The output stream.
+ 
+ @return
+ - 0 on success, 1 if the file can't be read or a worker couldn't
+ allocate its context.
+ 
+ */
+int run_parallel(const char* path, long thread_count, FILE* output) {
+    
+    int status = 0;
+    int file;
+    struct stat file_stat;
+    size_t i;
+    size_t size;
+    size_t chunk_length;
+    size_t query_count = 0;
+    char* data;
+    char* position;
+    char* end;
+    char* last_line = NULL;
+    struct timespec start_time;
+    pthread_t* threads;
+    void* worker_result;
+    bool is_done;
+    parallel_job job;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    
+    if ((file = open(path, O_RDONLY)) < 0 || fstat(file, &file_stat) != 0) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+    
+    size = file_stat.st_size;
+    
+    if (size == 0) {
+        close(file);
+        parallel_report(0, 0, start_time);
+        return 0;
+    }
+    
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "can't map %s\n", path);
+        return 1;
+    }
+    
+    madvise(data, size, MADV_SEQUENTIAL);
+    
+    end = data + size;
+    
+    if (end[-1] != '\n') {
+        for (position = end; position > data && position[-1] != '\n'; position--);
+        last_line = malloc(end - position + 1);
+        if (last_line == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+        memcpy(last_line, position, end - position);
+        last_line[end - position] = '\0';
+        end = position;
+    }
+    
+    if (thread_count < 1) thread_count = 1;
+    
+    chunk_length = size / (thread_count * PARALLEL_CHUNKS_PER_THREAD) + 1;
+    if (chunk_length > PARALLEL_CHUNK_LENGTH) chunk_length = PARALLEL_CHUNK_LENGTH;
+    
+    job.chunk_count = 0;
+    job.chunks = malloc((size / chunk_length + 2) * sizeof(parallel_chunk));
+    if (job.chunks == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    for (position = data; position < end; job.chunk_count++) {
+        memset(&job.chunks[job.chunk_count], 0, sizeof(parallel_chunk));
+        job.chunks[job.chunk_count].begin = position;
+        position = ((size_t) (end - position) > chunk_length) ? position + chunk_length : end;
+        while (position < end && position[-1] != '\n') position++;
+        job.chunks[job.chunk_count].end = position;
+    }
+    
+    if (last_line != NULL) {
+        memset(&job.chunks[job.chunk_count], 0, sizeof(parallel_chunk));
+        job.chunks[job.chunk_count].begin = last_line;
+        job.chunks[job.chunk_count].end = last_line + strlen(last_line);
+        job.chunk_count++;
+    }
+    
+    job.next_chunk = 0;
+    job.next_written_chunk = 0;
+    job.window = 2 * thread_count * PARALLEL_CHUNKS_PER_THREAD;
+    job.running_worker_count = thread_count;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.chunk_done, NULL);
+    pthread_cond_init(&job.chunk_written, NULL);
+    
+    threads = malloc(thread_count * sizeof(pthread_t));
+    if (threads == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    for (i = 0; i < (size_t) thread_count; i++) {
+        if (pthread_create(&threads[i], NULL, parallel_run_worker, &job) != 0) {
+            pthread_mutex_lock(&job.lock);
+            job.running_worker_count -= thread_count - i;
+            pthread_mutex_unlock(&job.lock);
+            break;
+        }
+    }
+    
+    thread_count = i;
+    
+    if (thread_count == 0) {
+        job.window = job.chunk_count;
+        job.running_worker_count = 1;
+        if (parallel_run_worker(&job) != NULL) status = 1;
+    }
+    
+    for (i = 0; i < job.chunk_count; i++) {
+        
+        pthread_mutex_lock(&job.lock);
+        while (!job.chunks[i].is_done && job.running_worker_count > 0) pthread_cond_wait(&job.chunk_done, &job.lock);
+        is_done = job.chunks[i].is_done;
+        pthread_mutex_unlock(&job.lock);
+        
+        if (!is_done) {
+            fprintf(stderr, "can't allocate a worker context\n");
+            status = 1;
+            break;
+        }
+        
+        fwrite(job.chunks[i].output, 1, job.chunks[i].output_length, output);
+        query_count += job.chunks[i].query_count;
+        free(job.chunks[i].output);
+        
+        pthread_mutex_lock(&job.lock);
+        job.next_written_chunk = i + 1;
+        pthread_cond_broadcast(&job.chunk_written);
+        pthread_mutex_unlock(&job.lock);
+        
+    }
+    
+    fflush(output);
+    
+    for (i = 0; i < (size_t) thread_count; i++) {
+        pthread_join(threads[i], &worker_result);
+        if (worker_result != NULL) status = 1;
+    }
+    
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.chunk_done);
+    pthread_cond_destroy(&job.chunk_written);
+    munmap(data, size);
+    free(last_line);
+    free(job.chunks);
+    free(threads);
+    
+    parallel_report(query_count, size, start_time);
+    
+    return status;
+    
+}
+
+#endif
+
 int main(int argc, const char * argv[]) {
     
     char query[150];
-    char buffer[500];
+    char buffer[BATCH_BUFFER_LENGTH];
 
-    memset(buffer, 0, 500);
+    memset(buffer, 0, BATCH_BUFFER_LENGTH);
     memset(query, 0, 150);
     
 #ifdef DEBUG_MODE
-    if (symbolic4(buffer, "Deriv(x)") == RETS_SUCCESS) {
+    if (symbolic4_n(buffer, BATCH_BUFFER_LENGTH, "Deriv(x)") == RETS_SUCCESS) {
         printf("%s\n\n", buffer);
         return 0;
     } else {
@@ -19,20 +435,44 @@ int main(int argc, const char * argv[]) {
     }
 #endif
     
+    if (argc >= 2 && strcmp(argv[1], "--batch") == 0) {
+        
+        FILE* input = stdin;
+        int status;
+        
+        if (argc == 3 && (input = fopen(argv[2], "r")) == NULL) {
+            fprintf(stderr, "can't open %s\n", argv[2]);
+            return 1;
+        }
+        
+        status = run_batch(input, stdout);
+        
+        if (input != stdin) fclose(input);
+        
+        return status;
+        
+    }
+    
+#ifdef HAS_PTHREADS
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "--parallel") == 0) {
+        return run_parallel(argv[2], (argc == 4) ? atol(argv[3]) : sysconf(_SC_NPROCESSORS_ONLN), stdout);
+    }
+#endif
+    
     if (argc == 1) {
         while (true) {
-            memset(buffer, 0, 500);
+            memset(buffer, 0, BATCH_BUFFER_LENGTH);
             memset(query, 0, 150);
             printf("Query:\n");
             scanf("%s", query);
-            if (symbolic4(buffer, query) == RETS_SUCCESS) {
+            if (symbolic4_n(buffer, BATCH_BUFFER_LENGTH, query) == RETS_SUCCESS) {
                 printf("%s\n\n", buffer);
             } else {
                 printf("ERROR\n\n");
             }
         }
     } else if (argc == 2) {
-        if (symbolic4(buffer, (char*) argv[1]) == RETS_SUCCESS) {
+        if (symbolic4_n(buffer, BATCH_BUFFER_LENGTH, (char*) argv[1]) == RETS_SUCCESS) {
             printf("%s", buffer);
             return 0;
         } else {
@@ -0,0 +1,291 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief The range of query indices a worker still has to evaluate
+ 
+ @details
+ The owner takes queries from the front, other workers steal the back
+ half of the range when they run out of work.
+ 
+ */
+typedef struct {
+    
+    size_t begin;
+    size_t end;
+    
+#ifdef HAS_PTHREADS
+    pthread_mutex_t lock;
+    pthread_t thread;
+    bool is_running;
+#endif
+    
+} batch_worker;
+
+typedef struct {
+    const char** queries;
+    symbolic4_result* results;
+    batch_worker* workers;
+    size_t worker_count;
+    symbolic4_cache* cache;
+} batch_job;
+
+typedef struct {
+    batch_job* job;
+    size_t index;
+} batch_worker_argument;
+
+bool batch_take(batch_worker* worker, size_t* index);
+bool batch_steal(batch_job* job, size_t thief);
+void* batch_run_worker(void* argument);
+
+/**
+ 
+ @brief Takes the next query index from the front of a worker's range
+ 
+ @param[in,out] worker The worker.
+ @param[out] index The taken index.
+ 
+ @return
+ - @c true if an index was taken, @c false if the range is empty.
+ 
+ */
+bool batch_take(batch_worker* worker, size_t* index) {
+    
+    bool result = false;
+    
+#ifdef HAS_PTHREADS
+    pthread_mutex_lock(&worker->lock);
+#endif
+    
+    if (worker->begin < worker->end) {
+        *index = worker->begin;
+        worker->begin++;
+        result = true;
+    }
+    
+#ifdef HAS_PTHREADS
+    pthread_mutex_unlock(&worker->lock);
+#endif
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Moves the back half of another worker's range to the thief
+ 
+ @details
+ The victims are visited round-robin, starting after the thief.
+ 
+ @param[in,out] job The batch job.
+ @param[in] thief The index of the idle worker.
+ 
+ @return
+ - @c true if work was stolen, @c false if all workers are empty.
+ 
+ */
+bool batch_steal(batch_job* job, size_t thief) {
+    
+    size_t i;
+    size_t middle;
+    size_t end;
+    batch_worker* victim;
+    batch_worker* worker = &job->workers[thief];
+    
+    for (i = 1; i < job->worker_count; i++) {
+        
+        victim = &job->workers[(thief + i) % job->worker_count];
+        
+#ifdef HAS_PTHREADS
+        pthread_mutex_lock(&victim->lock);
+#endif
+        
+        end = victim->end;
+        middle = victim->begin + (victim->end - victim->begin) / 2;
+        
+        if (victim->begin < victim->end) {
+            if (middle == victim->begin) middle = victim->end - 1;
+            victim->end = middle;
+        }
+        
+#ifdef HAS_PTHREADS
+        pthread_mutex_unlock(&victim->lock);
+#endif
+        
+        if (middle < end) {
+            
+#ifdef HAS_PTHREADS
+            pthread_mutex_lock(&worker->lock);
+#endif
+            
+            worker->begin = middle;
+            worker->end = end;
+            
+#ifdef HAS_PTHREADS
+            pthread_mutex_unlock(&worker->lock);
+#endif
+            
+            return true;
+            
+        }
+        
+    }
+    
+    return false;
+    
+}
+
+/**
+ 
+ @brief Evaluates queries until all ranges are empty
+ 
+ @details
+ Each worker evaluates its queries in its own context, so that the
+ allocator is reused across all queries of the worker. The contexts of
+ all workers share the cache of the job.
+ 
+ @param[in] argument A @c batch_worker_argument.
+ 
+ @return
+ - @c NULL
+ 
+ */
+void* batch_run_worker(void* argument) {
+    
+    size_t index;
+    batch_job* job = ((batch_worker_argument*) argument)->job;
+    size_t worker_index = ((batch_worker_argument*) argument)->index;
+    symbolic4_context* context = new_symbolic4_context();
+    
+    if (context != NULL) context->cache = job->cache;
+    
+    do {
+        while (batch_take(&job->workers[worker_index], &index)) {
+            job->results[index].status = symbolic4_ctx_n(context, job->results[index].buffer, job->results[index].buffer_length, job->queries[index]);
+        }
+    } while (batch_steal(job, worker_index));
+    
+    free_symbolic4_context(context);
+    
+    return NULL;
+    
+}
+
+/**
+ 
+ @brief Evaluates a batch of independent queries
+ 
+ @details
+ The queries are split evenly among the workers. A worker that runs
+ out of queries steals the back half of the range of another worker.
+ The calling thread acts as the first worker. If threads aren't
+ supported on the platform, or a thread can't be created, the
+ remaining workers evaluate its queries.
+ 
+ The results are stored in input order.
+ 
+ @param[in] queries The query strings.
+ @param[in,out] results The results. The @c buffer of each result has
+ to point to a buffer provided by the caller, whose size is given by
+ @c buffer_length.
+ @param[in] count The number of queries.
+ @param[in] threads The number of worker threads (including the
+ calling thread). It is limited to the number of queries.
+ @param[in,out] cache A result cache shared by all workers (see
+ @c new_symbolic4_cache()), or @c NULL.
+ 
+ @return
+ - @c RETS_SUCCESS if all queries were evaluated successfully,
+ @c RETS_ERROR otherwise (see the status of the individual results).
+ 
+ */
+uint8_t symbolic4_batch(const char* queries[], symbolic4_result results[], size_t count, size_t threads, symbolic4_cache* cache) {
+    
+    size_t i;
+    batch_job job;
+    batch_worker_argument* arguments;
+    
+    if (threads == 0) threads = 1;
+    if (count < threads) threads = (count == 0) ? 1 : count;
+#ifndef HAS_PTHREADS
+    threads = 1;
+#endif
+    
+    job.queries = queries;
+    job.results = results;
+    job.worker_count = threads;
+    job.cache = cache;
+    job.workers = calloc(threads, sizeof(batch_worker));
+    arguments = calloc(threads, sizeof(batch_worker_argument));
+    
+    if (job.workers == NULL || arguments == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    for (i = 0; i < threads; i++) {
+        job.workers[i].begin = count / threads * i + count % threads * i / threads;
+        job.workers[i].end = count / threads * (i + 1) + count % threads * (i + 1) / threads;
+        arguments[i].job = &job;
+        arguments[i].index = i;
+#ifdef HAS_PTHREADS
+        pthread_mutex_init(&job.workers[i].lock, NULL);
+#endif
+    }
+    
+#ifdef HAS_PTHREADS
+    
+    for (i = 1; i < threads; i++) {
+        job.workers[i].is_running = (pthread_create(&job.workers[i].thread, NULL, batch_run_worker, &arguments[i]) == 0);
+    }
+    
+    batch_run_worker(&arguments[0]);
+    
+    for (i = 1; i < threads; i++) {
+        if (job.workers[i].is_running) pthread_join(job.workers[i].thread, NULL);
+    }
+    
+    for (i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&job.workers[i].lock);
+    }
+    
+#else
+    
+    batch_run_worker(&arguments[0]);
+    
+#endif
+    
+    free(job.workers);
+    free(arguments);
+    
+    for (i = 0; i < count; i++) {
+        if (results[i].status != RETS_SUCCESS) return RETS_ERROR;
+    }
+    
+    return RETS_SUCCESS;
+    
+}
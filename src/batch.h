@@ -0,0 +1,39 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef batch_h
+#define batch_h
+
+#include "symbolic4.h"
+
+typedef struct {
+    char* buffer; ///< The buffer where the result is written into. It has to be provided by the caller.
+    size_t buffer_length; ///< The size of @c buffer in bytes. Results that don't fit fail with @c ERRI_BUFFER_OVERFLOW.
+    uint8_t status; ///< The return status of the query (@c RETS_SUCCESS or @c RETS_ERROR).
+} symbolic4_result;
+
+uint8_t symbolic4_batch(const char* queries[], symbolic4_result results[], size_t count, size_t threads, struct symbolic4_cache* cache);
+
+#endif /* batch_h */
@@ -0,0 +1,768 @@
+
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+bignum* new_bignum_with_length(size_t length);
+void bignum_trim(bignum* source);
+bignum_limb add_limbs(bignum_limb* result, const bignum_limb* a, size_t a_length, const bignum_limb* b, size_t b_length);
+void subtract_limbs(bignum_limb* a, size_t a_length, const bignum_limb* b, size_t b_length);
+void multiply_limbs(bignum_limb* result, const bignum_limb* a, size_t a_length, const bignum_limb* b, size_t b_length);
+void karatsuba_limbs(bignum_limb* result, const bignum_limb* a, const bignum_limb* b, size_t length);
+bignum_limb divide_limbs_by_limb(bignum_limb* quotient, const bignum_limb* a, size_t length, bignum_limb divisor);
+
+bignum* new_bignum_with_length(size_t length) {
+    bignum* result = smart_alloc(1, sizeof(bignum) + length * sizeof(bignum_limb));
+    result->length = length;
+    return result;
+}
+
+void bignum_trim(bignum* source) {
+    while (source->length > 0 && source->limbs[source->length - 1] == 0) source->length--;
+}
+
+uint32_t bignum_bit_length(const bignum* source) {
+    
+    uint32_t result;
+    bignum_limb top;
+    
+    if (source->length == 0) return 0;
+    
+    result = (source->length - 1) * BIGNUM_LIMB_BITS;
+    
+    for (top = source->limbs[source->length - 1]; top != 0; top >>= 1) {
+        result++;
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Creates a bignum from a native integer
+ 
+ @param[in] value The value.
+ 
+ @return
+ - The new bignum.
+ 
+ */
+bignum* new_bignum(uintmax_t value) {
+    
+    uint8_t i;
+    bignum* result = new_bignum_with_length((sizeof(uintmax_t) + sizeof(bignum_limb) - 1) / sizeof(bignum_limb));
+    
+    for (i = 0; value != 0; i++) {
+        result->limbs[i] = (bignum_limb) value;
+        value /= (bignum_double_limb) 1 << BIGNUM_LIMB_BITS;
+    }
+    
+    bignum_trim(result);
+    
+    return result;
+    
+}
+
+bignum* copy_bignum(const bignum* source) {
+    
+    bignum* result;
+    
+    if (source == NULL) return NULL;
+    
+    result = new_bignum_with_length(source->length);
+    memcpy(result->limbs, source->limbs, source->length * sizeof(bignum_limb));
+    
+    return result;
+    
+}
+
+void free_bignum(bignum* source) {
+    if (source != NULL) smart_free(source);
+}
+
+bool bignum_fits_uintmax(const bignum* source) {
+    return source->length * sizeof(bignum_limb) <= sizeof(uintmax_t);
+}
+
+/**
+ 
+ @brief Converts a bignum to a native integer
+ 
+ @warning
+ - The bignum has to fit (see @c bignum_fits_uintmax()).
+ 
+ */
+uintmax_t bignum_to_uintmax(const bignum* source) {
+    
+    uint16_t i;
+    uintmax_t result = 0;
+    
+    for (i = source->length; i > 0; i--) {
+        result = result * ((bignum_double_limb) 1 << BIGNUM_LIMB_BITS) + source->limbs[i - 1];
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Converts a bignum to a floating point number
+ 
+ @details
+ Only the three most significant limbs are taken into account. If
+ @c exponent isn't @c NULL, the result is scaled down by
+ 2^@c exponent, so that quotients of bignums beyond the range of a
+ double can still be computed.
+ 
+ @param[in] source The bignum.
+ @param[out] exponent The binary exponent of the result, or @c NULL.
+ 
+ @return
+ - The value of the bignum, or its mantissa.
+ 
+ */
+double bignum_to_double(const bignum* source, int32_t* exponent) {
+    
+    uint16_t i;
+    uint16_t start = (source->length > 3) ? source->length - 3 : 0;
+    double result = 0;
+    
+    for (i = source->length; i > start; i--) {
+        result = ldexp(result, BIGNUM_LIMB_BITS) + source->limbs[i - 1];
+    }
+    
+    if (exponent != NULL) {
+        *exponent = start * BIGNUM_LIMB_BITS;
+        return result;
+    }
+    
+    return ldexp(result, start * BIGNUM_LIMB_BITS);
+    
+}
+
+int8_t bignum_compare(const bignum* a, const bignum* b) {
+    
+    uint16_t i;
+    
+    if (a->length != b->length) return (a->length < b->length) ? -1 : 1;
+    
+    for (i = a->length; i > 0; i--) {
+        if (a->limbs[i - 1] != b->limbs[i - 1]) return (a->limbs[i - 1] < b->limbs[i - 1]) ? -1 : 1;
+    }
+    
+    return 0;
+    
+}
+
+/**
+ 
+ @brief Adds two limb arrays
+ 
+ @details
+ @c a_length has to be at least @c b_length. @c result may alias
+ @c a and receives @c a_length limbs.
+ 
+ @return
+ - The carry.
+ 
+ */
+bignum_limb add_limbs(bignum_limb* result, const bignum_limb* a, size_t a_length, const bignum_limb* b, size_t b_length) {
+    
+    size_t i;
+    bignum_double_limb temp = 0;
+    
+    for (i = 0; i < a_length; i++) {
+        temp += (bignum_double_limb) a[i] + ((i < b_length) ? b[i] : 0);
+        result[i] = (bignum_limb) temp;
+        temp >>= BIGNUM_LIMB_BITS;
+    }
+    
+    return (bignum_limb) temp;
+    
+}
+
+/**
+ 
+ @brief Subtracts a limb array from another one in place
+ 
+ @details
+ @c a has to be at least as large as @c b.
+ 
+ */
+void subtract_limbs(bignum_limb* a, size_t a_length, const bignum_limb* b, size_t b_length) {
+    
+    size_t i;
+    bignum_limb borrow = 0;
+    bignum_limb subtrahend;
+    
+    for (i = 0; i < a_length && (i < b_length || borrow != 0); i++) {
+        subtrahend = (i < b_length) ? b[i] : 0;
+        if (borrow != 0) {
+            borrow = (a[i] <= subtrahend) ? 1 : 0;
+            a[i] -= subtrahend + 1;
+        } else {
+            borrow = (a[i] < subtrahend) ? 1 : 0;
+            a[i] -= subtrahend;
+        }
+    }
+    
+}
+
+/**
+ 
+ @brief Multiplies two limb arrays
+ 
+ @details
+ @c result has to hold @c a_length + @c b_length zeroed limbs. Operands
+ with fewer than @c BIGNUM_KARATSUBA_THRESHOLD limbs are multiplied
+ with the schoolbook method. Otherwise the longer operand is split
+ into chunks of the length of the shorter one, which are multiplied
+ with @c karatsuba_limbs().
+ 
+ */
+void multiply_limbs(bignum_limb* result, const bignum_limb* a, size_t a_length, const bignum_limb* b, size_t b_length) {
+    
+    size_t i, j;
+    size_t chunk_length;
+    bignum_double_limb temp;
+    bignum_limb* chunk;
+    bignum_limb* product;
+    
+    if (a_length < b_length) {
+        multiply_limbs(result, b, b_length, a, a_length);
+        return;
+    }
+    
+    if (b_length < BIGNUM_KARATSUBA_THRESHOLD) {
+        
+        for (i = 0; i < b_length; i++) {
+            
+            temp = 0;
+            
+            for (j = 0; j < a_length; j++) {
+                temp += (bignum_double_limb) a[j] * b[i] + result[i + j];
+                result[i + j] = (bignum_limb) temp;
+                temp >>= BIGNUM_LIMB_BITS;
+            }
+            
+            result[i + a_length] = (bignum_limb) temp;
+            
+        }
+        
+        return;
+        
+    }
+    
+    chunk = smart_alloc(b_length, sizeof(bignum_limb));
+    product = smart_alloc(2 * b_length, sizeof(bignum_limb));
+    
+    for (i = 0; i < a_length; i += b_length) {
+        chunk_length = min(b_length, a_length - i);
+        memset(chunk, 0, b_length * sizeof(bignum_limb));
+        memcpy(chunk, a + i, chunk_length * sizeof(bignum_limb));
+        karatsuba_limbs(product, chunk, b, b_length);
+        add_limbs(result + i, result + i, chunk_length + b_length, product, chunk_length + b_length);
+    }
+    
+    smart_free(chunk);
+    smart_free(product);
+    
+}
+
+/**
+ 
+ @brief Multiplies two limb arrays of equal length with the Karatsuba
+ algorithm
+ 
+ @details
+ With a = a1 * B^m + a0 and b = b1 * B^m + b0, the product is
+ z2 * B^2m + z1 * B^m + z0, where z0 = a0 * b0, z2 = a1 * b1 and
+ z1 = (a0 + a1) * (b0 + b1) - z0 - z2, so only three half-size
+ products are needed.
+ 
+ @param[out] result The product, @c 2 * @c length limbs.
+ @param[in] a The first factor.
+ @param[in] b The second factor.
+ @param[in] length The number of limbs of both factors.
+ 
+ */
+void karatsuba_limbs(bignum_limb* result, const bignum_limb* a, const bignum_limb* b, size_t length) {
+    
+    size_t low = length / 2;
+    size_t high = length - low;
+    bignum_limb* a_sum;
+    bignum_limb* b_sum;
+    bignum_limb* middle;
+    
+    if (length < BIGNUM_KARATSUBA_THRESHOLD) {
+        memset(result, 0, 2 * length * sizeof(bignum_limb));
+        multiply_limbs(result, a, length, b, length);
+        return;
+    }
+    
+    a_sum = smart_alloc(high + 1, sizeof(bignum_limb));
+    b_sum = smart_alloc(high + 1, sizeof(bignum_limb));
+    middle = smart_alloc(2 * (high + 1), sizeof(bignum_limb));
+    
+    karatsuba_limbs(result, a, b, low);
+    karatsuba_limbs(result + 2 * low, a + low, b + low, high);
+    
+    a_sum[high] = add_limbs(a_sum, a + low, high, a, low);
+    b_sum[high] = add_limbs(b_sum, b + low, high, b, low);
+    karatsuba_limbs(middle, a_sum, b_sum, high + 1);
+    
+    subtract_limbs(middle, 2 * (high + 1), result, 2 * low);
+    subtract_limbs(middle, 2 * (high + 1), result + 2 * low, 2 * high);
+    add_limbs(result + low, result + low, low + 2 * high, middle, low + high + 1);
+    
+    smart_free(a_sum);
+    smart_free(b_sum);
+    smart_free(middle);
+    
+}
+
+bignum_limb divide_limbs_by_limb(bignum_limb* quotient, const bignum_limb* a, size_t length, bignum_limb divisor) {
+    
+    size_t i;
+    bignum_double_limb temp = 0;
+    
+    for (i = length; i > 0; i--) {
+        temp = (temp << BIGNUM_LIMB_BITS) | a[i - 1];
+        quotient[i - 1] = (bignum_limb) (temp / divisor);
+        temp %= divisor;
+    }
+    
+    return (bignum_limb) temp;
+    
+}
+
+/**
+ 
+ @brief Computes the remainder of a bignum divided by a single limb
+ 
+ @details
+ Unlike @c bignum_divide(), this function doesn't allocate, so it is
+ suited for trial division.
+ 
+ @param[in] a The dividend.
+ @param[in] divisor The divisor, which must not be zero.
+ 
+ @return
+ - The remainder.
+ 
+ */
+bignum_limb bignum_remainder_by_limb(const bignum* a, bignum_limb divisor) {
+    
+    uint16_t i;
+    bignum_double_limb temp = 0;
+    
+    for (i = a->length; i > 0; i--) {
+        temp = ((temp << BIGNUM_LIMB_BITS) | a->limbs[i - 1]) % divisor;
+    }
+    
+    return (bignum_limb) temp;
+    
+}
+
+bignum* bignum_add(const bignum* a, const bignum* b) {
+    
+    bignum* result;
+    
+    if (a->length < b->length) return bignum_add(b, a);
+    if (a->length >= BIGNUM_MAX_LIMBS) return NULL;
+    
+    result = new_bignum_with_length(a->length + 1);
+    result->limbs[a->length] = add_limbs(result->limbs, a->limbs, a->length, b->limbs, b->length);
+    bignum_trim(result);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Subtracts two bignums
+ 
+ @warning
+ - @c a has to be at least as large as @c b.
+ 
+ */
+bignum* bignum_subtract(const bignum* a, const bignum* b) {
+    
+    bignum* result = copy_bignum(a);
+    
+    subtract_limbs(result->limbs, result->length, b->limbs, b->length);
+    bignum_trim(result);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Multiplies two bignums
+ 
+ @return
+ - The product, or @c NULL if it would have more than
+ @c BIGNUM_MAX_LIMBS limbs.
+ 
+ */
+bignum* bignum_multiply(const bignum* a, const bignum* b) {
+    
+    bignum* result;
+    
+    if (a->length + b->length > BIGNUM_MAX_LIMBS + 1) return NULL;
+    
+    result = new_bignum_with_length(a->length + b->length);
+    multiply_limbs(result->limbs, a->limbs, a->length, b->limbs, b->length);
+    bignum_trim(result);
+    
+    if (result->length > BIGNUM_MAX_LIMBS) {
+        free_bignum(result);
+        return NULL;
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Computes @c a * @c factor + @c summand
+ 
+ @return
+ - The result, or @c NULL if it would have more than
+ @c BIGNUM_MAX_LIMBS limbs.
+ 
+ */
+bignum* bignum_multiply_add(const bignum* a, bignum_limb factor, bignum_limb summand) {
+    
+    uint16_t i;
+    bignum_double_limb temp = summand;
+    bignum* result;
+    
+    if (a->length >= BIGNUM_MAX_LIMBS) return NULL;
+    
+    result = new_bignum_with_length(a->length + 1);
+    
+    for (i = 0; i < a->length; i++) {
+        temp += (bignum_double_limb) a->limbs[i] * factor;
+        result->limbs[i] = (bignum_limb) temp;
+        temp >>= BIGNUM_LIMB_BITS;
+    }
+    
+    result->limbs[a->length] = (bignum_limb) temp;
+    bignum_trim(result);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Divides two bignums
+ 
+ @details
+ Divisors with more than one limb are handled with Knuth's algorithm D
+ (The Art of Computer Programming, Vol. 2, 4.3.1): the operands are
+ normalized so that the divisor has its top bit set, which makes the
+ estimate of every quotient limb off by at most two.
+ 
+ @param[out] quotient The quotient, or @c NULL if not needed.
+ @param[out] remainder The remainder, or @c NULL if not needed.
+ @param[in] a The dividend.
+ @param[in] b The divisor, which must not be zero.
+ 
+ */
+void bignum_divide(bignum** quotient, bignum** remainder, const bignum* a, const bignum* b) {
+    
+    size_t i, j;
+    size_t n = b->length;
+    size_t m = a->length;
+    uint8_t shift = 0;
+    bignum_limb top;
+    bignum_limb* u;
+    bignum_limb* v;
+    bignum_double_limb base = (bignum_double_limb) 1 << BIGNUM_LIMB_BITS;
+    bignum_double_limb numerator, estimate, rest, product;
+    bignum_signed_double_limb temp, borrow;
+    bignum* q;
+    bignum* r;
+    
+    if (bignum_compare(a, b) < 0) {
+        if (quotient != NULL) *quotient = new_bignum(0);
+        if (remainder != NULL) *remainder = copy_bignum(a);
+        return;
+    }
+    
+    q = new_bignum_with_length(m - n + 1);
+    
+    if (n == 1) {
+        r = new_bignum(divide_limbs_by_limb(q->limbs, a->limbs, m, b->limbs[0]));
+        q->length = m;
+    } else {
+        
+        for (top = b->limbs[n - 1]; (top & ((bignum_limb) 1 << (BIGNUM_LIMB_BITS - 1))) == 0; top <<= 1) {
+            shift++;
+        }
+        
+        u = smart_alloc(m + 1, sizeof(bignum_limb));
+        v = smart_alloc(n, sizeof(bignum_limb));
+        
+        for (i = n - 1; i > 0; i--) {
+            v[i] = (bignum_limb) ((b->limbs[i] << shift) | ((bignum_double_limb) b->limbs[i - 1] >> (BIGNUM_LIMB_BITS - shift)));
+        }
+        v[0] = (bignum_limb) (b->limbs[0] << shift);
+        
+        u[m] = (bignum_limb) ((bignum_double_limb) a->limbs[m - 1] >> (BIGNUM_LIMB_BITS - shift));
+        for (i = m - 1; i > 0; i--) {
+            u[i] = (bignum_limb) ((a->limbs[i] << shift) | ((bignum_double_limb) a->limbs[i - 1] >> (BIGNUM_LIMB_BITS - shift)));
+        }
+        u[0] = (bignum_limb) (a->limbs[0] << shift);
+        
+        for (j = m - n + 1; j > 0; j--) {
+            
+            numerator = ((bignum_double_limb) u[j - 1 + n] << BIGNUM_LIMB_BITS) | u[j - 2 + n];
+            estimate = numerator / v[n - 1];
+            rest = numerator % v[n - 1];
+            
+            while (estimate >= base || estimate * v[n - 2] > ((rest << BIGNUM_LIMB_BITS) | u[j - 3 + n])) {
+                estimate--;
+                rest += v[n - 1];
+                if (rest >= base) break;
+            }
+            
+            borrow = 0;
+            
+            for (i = 0; i < n; i++) {
+                product = estimate * v[i];
+                temp = (bignum_signed_double_limb) u[i + j - 1] - borrow - (bignum_signed_double_limb) (bignum_limb) product;
+                u[i + j - 1] = (bignum_limb) temp;
+                borrow = (bignum_signed_double_limb) (product >> BIGNUM_LIMB_BITS) - (temp >> BIGNUM_LIMB_BITS);
+            }
+            
+            temp = (bignum_signed_double_limb) u[j - 1 + n] - borrow;
+            u[j - 1 + n] = (bignum_limb) temp;
+            q->limbs[j - 1] = (bignum_limb) estimate;
+            
+            if (temp < 0) {
+                q->limbs[j - 1]--;
+                u[j - 1 + n] += add_limbs(u + j - 1, u + j - 1, n, v, n);
+            }
+            
+        }
+        
+        r = new_bignum_with_length(n);
+        
+        for (i = 0; i < n; i++) {
+            r->limbs[i] = (bignum_limb) ((u[i] >> shift) | ((bignum_double_limb) u[i + 1] << (BIGNUM_LIMB_BITS - shift)));
+        }
+        
+        smart_free(u);
+        smart_free(v);
+        
+    }
+    
+    bignum_trim(q);
+    bignum_trim(r);
+    
+    if (quotient != NULL) *quotient = q; else free_bignum(q);
+    if (remainder != NULL) *remainder = r; else free_bignum(r);
+    
+}
+
+/**
+ 
+ @brief Computes the GCD of two bignums
+ 
+ @details
+ Uses the Euclidean algorithm and switches to @c binary_gcd() as
+ soon as both operands fit into native integers.
+ 
+ */
+bignum* bignum_gcd(const bignum* a, const bignum* b) {
+    
+    bignum* x = copy_bignum(a);
+    bignum* y = copy_bignum(b);
+    bignum* temp;
+    
+    while (y->length != 0) {
+        
+        if (bignum_fits_uintmax(x) && bignum_fits_uintmax(y)) {
+            temp = new_bignum(binary_gcd(bignum_to_uintmax(x), bignum_to_uintmax(y)));
+            free_bignum(x);
+            free_bignum(y);
+            return temp;
+        }
+        
+        bignum_divide(NULL, &temp, x, y);
+        free_bignum(x);
+        x = y;
+        y = temp;
+        
+    }
+    
+    free_bignum(y);
+    
+    return x;
+    
+}
+
+/**
+ 
+ @brief Raises a bignum to a native power by repeated squaring
+ 
+ @return
+ - The power, or @c NULL if it would have more than
+ @c BIGNUM_MAX_LIMBS limbs.
+ 
+ */
+bignum* bignum_power(const bignum* base, uintmax_t exponent) {
+    
+    uint32_t bit_length = bignum_bit_length(base);
+    bignum* result = new_bignum(1);
+    bignum* square = copy_bignum(base);
+    bignum* temp;
+    
+    if (bit_length > 1 && exponent > (uintmax_t) BIGNUM_MAX_LIMBS * BIGNUM_LIMB_BITS / (bit_length - 1)) {
+        free_bignum(result);
+        free_bignum(square);
+        return NULL;
+    }
+    
+    while (true) {
+        
+        if (exponent & 1) {
+            temp = bignum_multiply(result, square);
+            free_bignum(result);
+            if ((result = temp) == NULL) break;
+        }
+        
+        if ((exponent >>= 1) == 0) break;
+        
+        temp = bignum_multiply(square, square);
+        free_bignum(square);
+        
+        if ((square = temp) == NULL) {
+            free_bignum(result);
+            return NULL;
+        }
+        
+    }
+    
+    free_bignum(square);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Writes the decimal representation of a bignum
+ 
+ @param[out] buffer The destination, which needs room for about
+ 2.5 digits per byte of the bignum.
+ @param[in] source The bignum.
+ 
+ */
+void bignum_to_string(char* buffer, const bignum* source) {
+    
+    uint8_t i;
+    size_t j;
+    size_t length = 0;
+    char temp;
+    bignum_limb chunk;
+    bignum* rest = copy_bignum(source);
+    
+    do {
+        
+        chunk = divide_limbs_by_limb(rest->limbs, rest->limbs, rest->length, BIGNUM_DECIMAL_CHUNK);
+        bignum_trim(rest);
+        
+        for (i = 0; i < BIGNUM_DECIMAL_CHUNK_DIGITS && (chunk != 0 || rest->length != 0); i++) {
+            buffer[length++] = '0' + chunk % 10;
+            chunk /= 10;
+        }
+        
+    } while (rest->length != 0);
+    
+    if (length == 0) buffer[length++] = '0';
+    buffer[length] = '\0';
+    
+    for (j = 0; 2 * j + 1 < length; j++) {
+        temp = buffer[j];
+        buffer[j] = buffer[length - 1 - j];
+        buffer[length - 1 - j] = temp;
+    }
+    
+    free_bignum(rest);
+    
+}
+
+uint32_t bignum_hash(uint32_t hash, const bignum* source) {
+    
+    uint16_t i;
+    
+    for (i = 0; i < source->length; i++) {
+        hash = (hash ^ source->limbs[i]) * 16777619u;
+    }
+    
+    return hash;
+    
+}
+
+/**
+ 
+ @brief Returns a numerator or denominator as a bignum
+ 
+ @param[in] value The native value.
+ @param[in] big_value The bignum value, or @c NULL if @c value is valid.
+ 
+ @return
+ - A new bignum.
+ 
+ */
+bignum* numeric_part_to_bignum(uintmax_t value, const bignum* big_value) {
+    return (big_value != NULL) ? copy_bignum(big_value) : new_bignum(value);
+}
+
+/**
+ 
+ @brief Compares two numerators or denominators
+ 
+ @details
+ Bignum values are only used if the value doesn't fit into a native
+ integer, so they are larger than any native value.
+ 
+ */
+int8_t compare_numeric_parts(uintmax_t a, const bignum* a_big, uintmax_t b, const bignum* b_big) {
+    if (a_big == NULL && b_big == NULL) return (a == b) ? 0 : ((a < b) ? -1 : 1);
+    if (a_big == NULL) return -1;
+    if (b_big == NULL) return 1;
+    return bignum_compare(a_big, b_big);
+}
@@ -0,0 +1,85 @@
+
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef bignum_h
+#define bignum_h
+
+#include "symbolic4.h"
+
+#ifdef _EZ80
+typedef uint16_t bignum_limb;
+typedef uint32_t bignum_double_limb;
+typedef int32_t bignum_signed_double_limb;
+#define BIGNUM_DECIMAL_CHUNK 10000
+#define BIGNUM_DECIMAL_CHUNK_DIGITS 4
+#else
+typedef uint32_t bignum_limb;
+typedef uint64_t bignum_double_limb;
+typedef int64_t bignum_signed_double_limb;
+#define BIGNUM_DECIMAL_CHUNK 1000000000
+#define BIGNUM_DECIMAL_CHUNK_DIGITS 9
+#endif
+
+#define BIGNUM_LIMB_BITS (sizeof(bignum_limb) * 8)
+#define BIGNUM_BIT(source, index) (((source)->limbs[(index) / BIGNUM_LIMB_BITS] >> ((index) % BIGNUM_LIMB_BITS)) & 1)
+
+/**
+ 
+ @brief An immutable arbitrary-precision unsigned integer
+ 
+ @details
+ Bignums are allocated with @c smart_alloc() and never modified after
+ they have been returned, so they may be shared freely until they are
+ freed with @c free_bignum().
+ 
+ */
+typedef struct bignum {
+    uint16_t length; ///< The number of limbs without leading zero limbs (0 for the number 0)
+    bignum_limb limbs[]; ///< The limbs, least significant first
+} bignum;
+
+bignum* new_bignum(uintmax_t value);
+bignum* copy_bignum(const bignum* source);
+void free_bignum(bignum* source);
+bool bignum_fits_uintmax(const bignum* source);
+uintmax_t bignum_to_uintmax(const bignum* source);
+double bignum_to_double(const bignum* source, int32_t* exponent);
+uint32_t bignum_bit_length(const bignum* source);
+int8_t bignum_compare(const bignum* a, const bignum* b);
+bignum* bignum_add(const bignum* a, const bignum* b);
+bignum* bignum_subtract(const bignum* a, const bignum* b);
+bignum* bignum_multiply(const bignum* a, const bignum* b);
+bignum* bignum_multiply_add(const bignum* a, bignum_limb factor, bignum_limb summand);
+void bignum_divide(bignum** quotient, bignum** remainder, const bignum* a, const bignum* b);
+bignum_limb bignum_remainder_by_limb(const bignum* a, bignum_limb divisor);
+bignum* bignum_gcd(const bignum* a, const bignum* b);
+bignum* bignum_power(const bignum* base, uintmax_t exponent);
+void bignum_to_string(char* buffer, const bignum* source);
+uint32_t bignum_hash(uint32_t hash, const bignum* source);
+bignum* numeric_part_to_bignum(uintmax_t value, const bignum* big_value);
+int8_t compare_numeric_parts(uintmax_t a, const bignum* a_big, uintmax_t b, const bignum* b_big);
+
+#endif /* bignum_h */
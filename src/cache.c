@@ -0,0 +1,380 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+#ifdef HAS_PTHREADS
+#define CACHE_READ_LOCK(shard) pthread_rwlock_rdlock(&(shard)->lock)
+#define CACHE_WRITE_LOCK(shard) pthread_rwlock_wrlock(&(shard)->lock)
+#define CACHE_UNLOCK(shard) pthread_rwlock_unlock(&(shard)->lock)
+#define CACHE_INCREMENT(counter) __atomic_fetch_add(&(counter), 1, __ATOMIC_RELAXED)
+#define CACHE_LOAD(variable) __atomic_load_n(&(variable), __ATOMIC_RELAXED)
+#define CACHE_STORE(variable, value) __atomic_store_n(&(variable), (value), __ATOMIC_RELAXED)
+#else
+#define CACHE_READ_LOCK(shard)
+#define CACHE_WRITE_LOCK(shard)
+#define CACHE_UNLOCK(shard)
+#define CACHE_INCREMENT(counter) ((counter)++)
+#define CACHE_LOAD(variable) (variable)
+#define CACHE_STORE(variable, value) ((variable) = (value))
+#endif
+
+uint32_t cache_hash(const char* key);
+void cache_evict(cache_shard* shard, size_t budget);
+
+/**
+ 
+ @brief Allocates and initializes a new result cache
+ 
+ @details
+ The cache may be shared by any number of contexts (see
+ @c symbolic4_context) and threads. It is split into
+ @c CACHE_SHARD_COUNT shards, each with its own lock and an equal
+ share of the byte budget. Lookups only take the shard lock for
+ reading, so concurrent hits don't block each other.
+ 
+ @param[in] budget The maximum number of bytes of all entries.
+ 
+ @return
+ - The initialized cache.
+ 
+ @see
+ - free_symbolic4_cache()
+ 
+ */
+symbolic4_cache* new_symbolic4_cache(size_t budget) {
+    
+    uint8_t i;
+    symbolic4_cache* cache = calloc(1, sizeof(symbolic4_cache));
+    
+    if (cache == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    cache->shard_budget = budget / CACHE_SHARD_COUNT;
+    
+#ifdef HAS_PTHREADS
+    for (i = 0; i < CACHE_SHARD_COUNT; i++) {
+        pthread_rwlock_init(&cache->shards[i].lock, NULL);
+    }
+#endif
+    
+    return cache;
+    
+}
+
+void free_symbolic4_cache(symbolic4_cache* cache) {
+    
+    uint8_t i;
+    size_t j;
+    
+    if (cache == NULL) return;
+    
+    for (i = 0; i < CACHE_SHARD_COUNT; i++) {
+        for (j = 0; j < cache->shards[i].ring_length; j++) {
+            free(cache->shards[i].ring[j]);
+        }
+        free(cache->shards[i].ring);
+#ifdef HAS_PTHREADS
+        pthread_rwlock_destroy(&cache->shards[i].lock);
+#endif
+    }
+    
+    free(cache);
+    
+}
+
+/**
+ 
+ @brief Serializes a token array into a cache key
+ 
+ @details
+ The key consists of the options of the current context (including
+ the contents of the symbol priorities) and the identifier and value
+ of every token. Since the tokenizer drops
+ whitespace and matches keywords case-insensitively, queries which
+ only differ in those respects get the same key.
+ 
+ @param[in] tokens The tokens returned by @c tokenize().
+ 
+ @return
+ - The key, allocated with @c smart_alloc().
+ 
+ */
+char* cache_key_from_tokens(const expression* tokens) {
+    
+    uint16_t i;
+    size_t length = 48 * tokens->child_count + strlen(current_context->default_priorities) + 48;
+    char* key;
+    
+    for (i = 0; i < tokens->child_count; i++) {
+        if (literal_is_big(tokens->children[i])) length += 2 * 3 * BIGNUM_MAX_LIMBS * sizeof(bignum_limb);
+    }
+    
+    key = smart_alloc(length, sizeof(char));
+    
+    length = sprintf(key, "%d%d%lu:%s|", current_context->use_spaces, current_context->use_abbrevations, (unsigned long) strlen(current_context->default_priorities), current_context->default_priorities);
+    
+    for (i = 0; i < tokens->child_count; i++) {
+        switch (tokens->children[i]->identifier) {
+            case EXPI_LITERAL:
+                if (literal_is_big(tokens->children[i])) {
+                    length += sprintf(key + length, "%d:", tokens->children[i]->sign);
+                    numeric_part_to_string(key + length, tokens->children[i]->value.numeric.numerator, tokens->children[i]->value.numeric.big_numerator);
+                    strcat(key + length, "/");
+                    numeric_part_to_string(key + length, tokens->children[i]->value.numeric.denominator, tokens->children[i]->value.numeric.big_denominator);
+                    strcat(key + length, ",");
+                    length += strlen(key + length);
+                } else {
+                    length += sprintf(key + length, "%d:%lu/%lu,", tokens->children[i]->sign, (unsigned long) tokens->children[i]->value.numeric.numerator, (unsigned long) tokens->children[i]->value.numeric.denominator);
+                }
+                break;
+            case EXPI_SYMBOL:
+            case EXPI_VARIABLE:
+                length += sprintf(key + length, "%d'%s,", tokens->children[i]->identifier, get_symbol_name(tokens->children[i]->value.symbol));
+                break;
+            default:
+                length += sprintf(key + length, "%d,", tokens->children[i]->identifier);
+                break;
+        }
+    }
+    
+    return key;
+    
+}
+
+/**
+ 
+ @brief Returns the 32-bit FNV-1a hash of a key
+ 
+ @param[in] key The key.
+ 
+ @return
+ - The hash.
+ 
+ */
+uint32_t cache_hash(const char* key) {
+    
+    uint32_t hash = 2166136261u;
+    
+    for ( ; *key != '\0'; key++) {
+        hash ^= (unsigned char) *key;
+        hash *= 16777619u;
+    }
+    
+    return hash;
+    
+}
+
+/**
+ 
+ @brief Looks up the result of a query
+ 
+ @details
+ On a hit, the entry is marked as referenced, so that the CLOCK
+ eviction gives it another round.
+ 
+ @param[in,out] cache The cache.
+ @param[in] key The key returned by @c cache_key_from_tokens().
+ @param[out] buffer The buffer where the cached result is written into.
+ @param[in] buffer_length The size of @c buffer in bytes.
+ @param[out] status The cached return status.
+ 
+ @return
+ - @c true on a hit, @c false on a miss. On a hit of a failed query,
+ the cached error is restored into the current context. A hit whose
+ result doesn't fit into the buffer is returned with the status
+ @c RETS_ERROR and the error @c ERRI_BUFFER_OVERFLOW.
+ 
+ */
+bool cache_lookup(symbolic4_cache* cache, const char* key, char* buffer, size_t buffer_length, uint8_t* status) {
+    
+    uint32_t hash = cache_hash(key);
+    cache_shard* shard = &cache->shards[hash % CACHE_SHARD_COUNT];
+    cache_entry* entry;
+    
+    CACHE_READ_LOCK(shard);
+    
+    for (entry = shard->buckets[(hash / CACHE_SHARD_COUNT) % CACHE_BUCKET_COUNT]; entry != NULL; entry = entry->next) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
+            if (strlen(entry->result) < buffer_length) {
+                strcpy(buffer, entry->result);
+                *status = entry->status;
+                if (entry->status == RETS_ERROR) current_context->error = entry->error;
+            } else {
+                *status = set_error(ERRD_SYSTEM, ERRI_BUFFER_OVERFLOW, "");
+            }
+            if (!CACHE_LOAD(entry->is_referenced)) CACHE_STORE(entry->is_referenced, true);
+            CACHE_UNLOCK(shard);
+            CACHE_INCREMENT(shard->hits);
+            return true;
+        }
+    }
+    
+    CACHE_UNLOCK(shard);
+    CACHE_INCREMENT(shard->misses);
+    
+    return false;
+    
+}
+
+/**
+ 
+ @brief Evicts entries until the shard fits into its budget
+ 
+ @details
+ The CLOCK hand sweeps the ring of entries: referenced entries lose
+ their reference bit, unreferenced entries are evicted. The shard has
+ to be locked for writing.
+ 
+ @param[in,out] shard The shard.
+ @param[in] budget The byte budget of the shard.
+ 
+ */
+void cache_evict(cache_shard* shard, size_t budget) {
+    
+    cache_entry* entry;
+    cache_entry** link;
+    
+    while (shard->bytes > budget && shard->ring_length > 0) {
+        
+        if (shard->hand >= shard->ring_length) shard->hand = 0;
+        entry = shard->ring[shard->hand];
+        
+        if (CACHE_LOAD(entry->is_referenced)) {
+            CACHE_STORE(entry->is_referenced, false);
+            shard->hand++;
+            continue;
+        }
+        
+        for (link = &shard->buckets[(entry->hash / CACHE_SHARD_COUNT) % CACHE_BUCKET_COUNT]; *link != entry; link = &(*link)->next);
+        *link = entry->next;
+        
+        shard->bytes -= entry->size;
+        shard->ring[shard->hand] = shard->ring[--shard->ring_length];
+        shard->evictions++;
+        free(entry);
+        
+    }
+    
+}
+
+/**
+ 
+ @brief Inserts the result of a query
+ 
+ @details
+ If the key is already present, nothing happens. Results larger than
+ the budget of a shard aren't cached.
+ 
+ @param[in,out] cache The cache.
+ @param[in] key The key returned by @c cache_key_from_tokens().
+ @param[in] result The result string.
+ @param[in] status The return status of the query.
+ @param[in] query_error The error of the query, which is restored on
+ a hit if @c status is @c RETS_ERROR.
+ 
+ */
+void cache_insert(symbolic4_cache* cache, const char* key, const char* result, uint8_t status, const error* query_error) {
+    
+    uint32_t hash = cache_hash(key);
+    cache_shard* shard = &cache->shards[hash % CACHE_SHARD_COUNT];
+    cache_entry** bucket = &shard->buckets[(hash / CACHE_SHARD_COUNT) % CACHE_BUCKET_COUNT];
+    cache_entry* entry;
+    size_t key_length = strlen(key) + 1;
+    size_t result_length = strlen(result) + 1;
+    size_t size = sizeof(cache_entry) + key_length + result_length;
+    
+    if (size > cache->shard_budget) return;
+    
+    CACHE_WRITE_LOCK(shard);
+    
+    for (entry = *bucket; entry != NULL; entry = entry->next) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
+            CACHE_UNLOCK(shard);
+            return;
+        }
+    }
+    
+    cache_evict(shard, cache->shard_budget - size);
+    
+    if (shard->ring_length == shard->ring_capacity) {
+        shard->ring_capacity = (shard->ring_capacity == 0) ? 16 : 2 * shard->ring_capacity;
+        shard->ring = realloc(shard->ring, shard->ring_capacity * sizeof(cache_entry*));
+        if (shard->ring == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    }
+    
+    entry = malloc(size);
+    if (entry == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    entry->hash = hash;
+    entry->status = status;
+    entry->error = *query_error;
+    entry->is_referenced = false;
+    entry->size = size;
+    entry->key = (char*) (entry + 1);
+    entry->result = entry->key + key_length;
+    memcpy(entry->key, key, key_length);
+    memcpy(entry->result, result, result_length);
+    
+    entry->next = *bucket;
+    *bucket = entry;
+    shard->ring[shard->ring_length++] = entry;
+    shard->bytes += size;
+    shard->insertions++;
+    
+    CACHE_UNLOCK(shard);
+    
+}
+
+/**
+ 
+ @brief Returns the summed statistics of all shards
+ 
+ @param[in] cache The cache.
+ 
+ @return
+ - The statistics.
+ 
+ */
+symbolic4_cache_statistics get_cache_statistics(symbolic4_cache* cache) {
+    
+    uint8_t i;
+    symbolic4_cache_statistics statistics;
+    
+    memset(&statistics, 0, sizeof(symbolic4_cache_statistics));
+    
+    for (i = 0; i < CACHE_SHARD_COUNT; i++) {
+        CACHE_READ_LOCK(&cache->shards[i]);
+        statistics.hits += CACHE_LOAD(cache->shards[i].hits);
+        statistics.misses += CACHE_LOAD(cache->shards[i].misses);
+        statistics.insertions += cache->shards[i].insertions;
+        statistics.evictions += cache->shards[i].evictions;
+        statistics.entry_count += cache->shards[i].ring_length;
+        statistics.bytes += cache->shards[i].bytes;
+        CACHE_UNLOCK(&cache->shards[i]);
+    }
+    
+    return statistics;
+    
+}
@@ -0,0 +1,83 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef cache_h
+#define cache_h
+
+#include "symbolic4.h"
+
+typedef struct cache_entry {
+    struct cache_entry* next;
+    uint32_t hash;
+    uint8_t status;
+    error error; ///< The error of the query if @c status is @c RETS_ERROR
+    bool is_referenced;
+    size_t size;
+    char* key;
+    char* result;
+} cache_entry;
+
+typedef struct {
+    uintmax_t hits;
+    uintmax_t misses;
+    uintmax_t insertions;
+    uintmax_t evictions;
+    size_t entry_count;
+    size_t bytes;
+} symbolic4_cache_statistics;
+
+typedef struct {
+    
+#ifdef HAS_PTHREADS
+    pthread_rwlock_t lock;
+#endif
+    
+    cache_entry* buckets[CACHE_BUCKET_COUNT];
+    cache_entry** ring; ///< All entries of the shard in CLOCK order.
+    size_t ring_length;
+    size_t ring_capacity;
+    size_t hand;
+    size_t bytes;
+    
+    uintmax_t hits;
+    uintmax_t misses;
+    uintmax_t insertions;
+    uintmax_t evictions;
+    
+} cache_shard;
+
+typedef struct symbolic4_cache {
+    cache_shard shards[CACHE_SHARD_COUNT];
+    size_t shard_budget;
+} symbolic4_cache;
+
+symbolic4_cache* new_symbolic4_cache(size_t budget);
+void free_symbolic4_cache(symbolic4_cache* cache);
+char* cache_key_from_tokens(const expression* tokens);
+bool cache_lookup(symbolic4_cache* cache, const char* key, char* buffer, size_t buffer_length, uint8_t* status);
+void cache_insert(symbolic4_cache* cache, const char* key, const char* result, uint8_t status, const error* query_error);
+symbolic4_cache_statistics get_cache_statistics(symbolic4_cache* cache);
+
+#endif /* cache_h */
@@ -0,0 +1,172 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+THREAD_LOCAL symbolic4_context* current_context = NULL; ///< The context of the query being evaluated on this thread.
+THREAD_LOCAL symbolic4_context* default_context = NULL;
+
+#ifdef HAS_PTHREADS
+pthread_key_t default_context_key;
+pthread_once_t default_context_key_once = PTHREAD_ONCE_INIT;
+
+void release_default_context(void* context);
+void create_default_context_key(void);
+
+void release_default_context(void* context) {
+    free_symbolic4_context(context);
+}
+
+void create_default_context_key(void) {
+    pthread_key_create(&default_context_key, release_default_context);
+}
+#endif
+
+/**
+ 
+ @brief Allocates and initializes a new context with the default
+ options
+ 
+ @return
+ - The initialized context, or @c NULL if the context can't be
+ allocated.
+ 
+ @see
+ - free_symbolic4_context()
+ - symbolic4_ctx()
+ 
+ */
+symbolic4_context* new_symbolic4_context(void) {
+    
+    symbolic4_context* context = calloc(1, sizeof(symbolic4_context));
+    
+    if (context == NULL) return NULL;
+    
+    context->allocator.is_recording = true;
+    context->use_abbrevations = true;
+    context->use_spaces = true;
+    context->default_priorities = "XYZABCDUVWSTPQRJKLMNOFGHEIxyzabcduvwstpqrjklmnofghei";
+    context->summary_epoch = 1;
+    context->symbol_table = new_symbol_table();
+    context->expression_table = new_expression_table();
+    context->simplify_memo = new_simplify_memo();
+    context->factorization_cache = new_factorization_cache();
+    context->rewrite_index = new_rewrite_index();
+    
+    return context;
+    
+}
+
+/**
+ 
+ @brief Frees a context and all memory of its allocator
+ 
+ @param[in] context The context to be freed.
+ 
+ */
+void free_symbolic4_context(symbolic4_context* context) {
+    
+    symbolic4_context* previous_context = current_context;
+    
+    if (context == NULL) return;
+    
+    current_context = context;
+    free_simplify_memo(context->simplify_memo);
+    free_factorization_cache(context->factorization_cache);
+    free_rewrite_index(context->rewrite_index);
+    free_expression_table(context->expression_table);
+    free_symbol_table(context->symbol_table);
+    smart_release_blocks();
+    free(context->priorities_snapshot);
+    current_context = (previous_context == context) ? NULL : previous_context;
+    
+    if (default_context == context) {
+        default_context = NULL;
+#ifdef HAS_PTHREADS
+        pthread_setspecific(default_context_key, NULL);
+#endif
+    }
+    
+    free(context);
+    
+}
+
+/**
+ 
+ @brief Returns the default context of the calling thread
+ 
+ @details
+ The default context is used by @c symbolic4() and is created on
+ first use. It is freed automatically when a thread created with
+ pthreads exits. On other platforms, and on the main thread, it lives
+ until it is released with @c free_symbolic4_context().
+ 
+ @return
+ - The default context, or @c NULL if it can't be allocated.
+ 
+ */
+symbolic4_context* get_default_context(void) {
+    
+    if (default_context == NULL && (default_context = new_symbolic4_context()) != NULL) {
+#ifdef HAS_PTHREADS
+        pthread_once(&default_context_key_once, create_default_context_key);
+        pthread_setspecific(default_context_key, default_context);
+#endif
+    }
+    
+    return default_context;
+    
+}
+
+/**
+ 
+ @brief Advances the priorities epoch if the contents of the default
+ priorities have changed since the last query
+ 
+ @details
+ The default priorities may be changed in place between queries, so
+ they are compared with a copy rather than by address. Tables derived
+ from them (see @c get_symbol_priority() and @c simplify_memo_lookup())
+ only need to compare the epoch.
+ 
+ @param[in,out] context The context.
+ 
+ */
+void update_priorities_epoch(symbolic4_context* context) {
+    
+    size_t length;
+    
+    if (context->priorities_snapshot != NULL && strcmp(context->priorities_snapshot, context->default_priorities) == 0) return;
+    
+    free(context->priorities_snapshot);
+    length = strlen(context->default_priorities) + 1;
+    
+    if ((context->priorities_snapshot = malloc(length)) != NULL) {
+        memcpy(context->priorities_snapshot, context->default_priorities, length);
+    }
+    
+    if (++context->priorities_epoch == 0) context->priorities_epoch = 1;
+    
+}
@@ -0,0 +1,74 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef context_h
+#define context_h
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief The state of one symbolic4 instance
+ 
+ @details
+ Each thread evaluating queries needs its own context. The options
+ may be changed between queries.
+ 
+ */
+typedef struct symbolic4_context {
+    
+    smart_alloc_state allocator;
+    error error;
+    
+    bool use_abbrevations; ///< Determines if abbrevations should be used in the result string (such as "Deriv" instead of "Derivative")
+    bool use_spaces; ///< Determines if spaces should be used in the result string (such as "x + y * z" instead of "x+y*z")
+    const char* default_priorities;
+    char* priorities_snapshot; ///< A copy of @c default_priorities as of the current query
+    uint32_t priorities_epoch; ///< Advanced whenever the contents of @c default_priorities change (see @c update_priorities_epoch())
+    
+    bool changed; ///< Set by a simplification rule when it rewrote the expression it was applied to
+    bool isolation_changed;
+    
+    uint32_t simplify_epoch; ///< Expressions simplified in an earlier epoch aren't trusted to be normalized anymore
+    uint32_t simplify_depth;
+    uint32_t summary_epoch; ///< Cached summaries of an earlier epoch are stale (see @c get_expression_summary())
+    
+    struct symbol_table* symbol_table; ///< Interned symbol names (see @c intern_symbol())
+    struct expression_table* expression_table; ///< Hash-consed expressions (see @c intern_expression())
+    struct simplify_memo* simplify_memo; ///< Memoized simplifications, kept across queries (@c NULL to disable)
+    struct factorization_cache* factorization_cache; ///< Small primes and recent factorizations (see @c factor_integer())
+    struct rewrite_index* rewrite_index; ///< The compiled rewrite rules (see @c apply_rewrite_rules())
+    struct symbolic4_cache* cache; ///< An optional result cache, which may be shared with other contexts (see @c new_symbolic4_cache())
+    
+} symbolic4_context;
+
+extern THREAD_LOCAL symbolic4_context* current_context;
+
+symbolic4_context* new_symbolic4_context(void);
+void free_symbolic4_context(symbolic4_context* context);
+symbolic4_context* get_default_context(void);
+void update_priorities_epoch(symbolic4_context* context);
+
+#endif /* context_h */
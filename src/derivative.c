@@ -34,7 +34,7 @@ uint8_t trigonometric_derivative(expression** result, const expression* source,
 
 uint8_t addition_derivative(expression** result, const expression* source, const expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp_result;
     
     *result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
@@ -51,7 +51,7 @@ uint8_t addition_derivative(expression** result, const expression* source, const
 
 uint8_t multiplication_derivative(expression** result, const expression* source, const expression* variable) {
     
-    uint8_t i, j;
+    uint16_t i, j;
     expression* temp_result;
     
     *result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
@@ -93,7 +93,7 @@ uint8_t exponentation_derivative(expression** result, const expression* source,
                                                  new_expression(EXPT_OPERATION, EXPI_DIVISION, 2,
                                                                 copy_expression(source->children[1]),
                                                                 copy_expression(source->children[0]))));
-        } else if (expressions_are_identical(source->children[0], new_symbol(EXPI_SYMBOL, "e"), false)) {
+        } else if (is_symbol(source->children[0], SYMBOL_E)) {
         } else {
             append_child(*result, new_expression(EXPT_FUNCTION, EXPI_LN, 1, copy_expression(source->children[0])));
         }
@@ -190,6 +190,7 @@ uint8_t trigonometric_derivative(expression** result, const expression* source,
             break;
         case EXPI_ARCTAN:
             append_child(*result, new_expression(EXPT_OPERATION, EXPI_DIVISION, 2,
+                                                 new_literal(1, 1, 1),
                                                  new_expression(EXPT_OPERATION, EXPI_ADDITION, 2,
                                                                 new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
                                                                                copy_expression(source->children[0]),
@@ -258,7 +259,7 @@ uint8_t derivative(expression** result, expression* source, expression* variable
 
 uint8_t stationary_points(expression* source, expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     expression* first_derivative;
     expression* second_derivative;
     expression* first_derivatives_roots;
@@ -294,7 +295,7 @@ uint8_t stationary_points(expression* source, expression* variable) {
         second_derivative_value = copy_expression(second_derivative);
         replace_occurences(second_derivative_value, variable, first_derivatives_roots->children[i]->children[1]);
         
-        if (expressions_are_equivalent(second_derivative_value, new_literal(1, 0, 1), false)) {
+        if (is_equivalent(second_derivative_value, &literal_zero)) {
             append_child(result, new_expression(EXPT_STRUCTURE, EXPI_LIST, 3,
                                                 copy_expression(first_derivatives_roots->children[i]->children[1]),
                                                 copy_expression(function_value),
@@ -406,7 +407,7 @@ uint8_t function_normal(expression** result, expression* source, expression* var
 
 uint8_t function_intersection_angle(expression** result, expression* g, expression* h){
     
-    uint8_t i;
+    uint16_t i;
     expression* equation = new_expression(EXPT_OPERATION, EXPI_EQUATION, 2,
                                           copy_expression(g),
                                           copy_expression(h));
@@ -151,6 +151,12 @@ expression_identifier keyword_identifiers[] = {
     EXPI_NULL
 };
 
+/* Shared, immutable constants which may be compared against (see @c is_equivalent()) or copied, but never modified or freed */
+const expression literal_zero = {.type = EXPT_VALUE, .identifier = EXPI_LITERAL, .sign = 1, .value.numeric = {0, 1}};
+const expression literal_one = {.type = EXPT_VALUE, .identifier = EXPI_LITERAL, .sign = 1, .value.numeric = {1, 1}};
+const expression literal_minus_one = {.type = EXPT_VALUE, .identifier = EXPI_LITERAL, .sign = -1, .value.numeric = {1, 1}};
+
+size_t expression_string_length_bound(const expression* source);
 void expression_to_infix(char* buffer, const expression* souce);
 void expression_to_tikz(char* buffer, const expression* source);
 
@@ -182,13 +188,9 @@ void expression_to_tikz(char* buffer, const expression* source);
  */
 expression* new_expression(expression_type type, expression_identifier identifier, uint8_t child_count, ...) {
     
-    uint8_t i;
+    uint16_t i;
     va_list arguments;
-    expression* result = smart_alloc(1, sizeof(expression));
-    
-    result->type = type;
-    result->identifier = identifier;
-    result->sign = 1;
+    expression* result = new_expression_with_capacity(type, identifier, child_count);
     
     va_start(arguments, child_count);
     
@@ -202,6 +204,47 @@ expression* new_expression(expression_type type, expression_identifier identifie
     
 }
 
+/**
+ 
+ @brief Allocates and initializes a new expression without children
+ 
+ @details
+ The children array is presized to hold at least @c capacity
+ children, so that appending up to @c capacity children doesn't
+ reallocate. Up to @c EXPRESSION_INLINE_CHILDREN children are stored
+ in the expression itself.
+ 
+ @param[in] type The expression type.
+ @param[in] identifier The expression identifier.
+ @param[in] capacity The expected number of children.
+ 
+ @return
+ - The initialized expression.
+ 
+ @see
+ - new_expression()
+ 
+ */
+expression* new_expression_with_capacity(expression_type type, expression_identifier identifier, uint16_t capacity) {
+    
+    expression* result = smart_alloc(1, sizeof(expression));
+    
+    result->type = type;
+    result->identifier = identifier;
+    result->sign = 1;
+    
+    if (capacity > EXPRESSION_INLINE_CHILDREN) {
+        result->children = smart_alloc(capacity, sizeof(expression*));
+        result->child_capacity = capacity;
+    } else {
+        result->children = result->inline_children;
+        result->child_capacity = EXPRESSION_INLINE_CHILDREN;
+    }
+    
+    return result;
+    
+}
+
 /**
  
  @brief Allocates and initializes a new literal expression
@@ -230,6 +273,103 @@ expression* new_literal(int8_t sign, uintmax_t numerator, uintmax_t denominator)
     return result;
 }
 
+/**
+ 
+ @brief Sets a numeric value from bignums
+ 
+ @details
+ The fraction is reduced to lowest terms. Numerators and denominators
+ which fit into a @c uintmax_t are stored natively, so that a value
+ only keeps bignums as long as it needs them.
+ 
+ @param[out] result The numeric value.
+ @param[in] numerator The numerator, which is taken over.
+ @param[in] denominator The denominator, which is taken over.
+ 
+ @return
+ - @c false if one of the arguments is @c NULL (e.g. because a bignum
+ operation exceeded @c BIGNUM_MAX_LIMBS), @c true otherwise.
+ 
+ */
+bool set_big_numeric_value(numeric_value* result, bignum* numerator, bignum* denominator) {
+    
+    bignum* gcd;
+    bignum* temp;
+    
+    if (numerator == NULL || denominator == NULL) {
+        free_bignum(numerator);
+        free_bignum(denominator);
+        return false;
+    }
+    
+    gcd = bignum_gcd(numerator, denominator);
+    
+    if (gcd->length != 0 && (gcd->length != 1 || gcd->limbs[0] != 1)) {
+        bignum_divide(&temp, NULL, numerator, gcd);
+        free_bignum(numerator);
+        numerator = temp;
+        bignum_divide(&temp, NULL, denominator, gcd);
+        free_bignum(denominator);
+        denominator = temp;
+    }
+    
+    free_bignum(gcd);
+    
+    result->numerator = UINTMAX_MAX;
+    result->denominator = UINTMAX_MAX;
+    result->big_numerator = NULL;
+    result->big_denominator = NULL;
+    
+    if (bignum_fits_uintmax(numerator)) {
+        result->numerator = bignum_to_uintmax(numerator);
+        free_bignum(numerator);
+    } else {
+        result->big_numerator = numerator;
+    }
+    
+    if (bignum_fits_uintmax(denominator)) {
+        result->denominator = bignum_to_uintmax(denominator);
+        free_bignum(denominator);
+    } else {
+        result->big_denominator = denominator;
+    }
+    
+    return true;
+    
+}
+
+/**
+ 
+ @brief Allocates and initializes a new literal from bignums
+ 
+ @details
+ The fraction is reduced to lowest terms (see
+ @c set_big_numeric_value()).
+ 
+ @param[in] sign (either 1 or -1)
+ @param[in] numerator The numerator, which is taken over.
+ @param[in] denominator The denominator, which is taken over.
+ 
+ @return
+ - The initialized literal, or @c NULL if one of the arguments is
+ @c NULL (e.g. because a bignum operation exceeded
+ @c BIGNUM_MAX_LIMBS).
+ 
+ */
+expression* new_big_literal(int8_t sign, bignum* numerator, bignum* denominator) {
+    
+    numeric_value value;
+    expression* result;
+    
+    if (!set_big_numeric_value(&value, numerator, denominator)) return NULL;
+    
+    result = new_literal(sign, value.numerator, value.denominator);
+    result->value.numeric = value;
+    
+    return result;
+    
+}
+
 /**
  
  @brief Allocates and initializes a new symbol/variable expression
@@ -251,7 +391,7 @@ expression* new_literal(int8_t sign, uintmax_t numerator, uintmax_t denominator)
  */
 expression* new_symbol(expression_identifier identifier, const char* value) {
     expression* result = new_expression(EXPT_VALUE, (identifier == EXPI_VARIABLE) ? EXPI_VARIABLE : EXPI_SYMBOL, 0);
-    strcpy(result->value.symbolic, value);
+    result->value.symbol = intern_symbol(value);
     return result;
 }
 
@@ -285,11 +425,13 @@ expression* new_trigonometic_periodicity(uint8_t period) {
  */
 expression* copy_expression(const expression* source) {
     
-    uint8_t i;
-    expression* result = new_expression(EXPT_NULL, EXPI_NULL, 0);
+    uint16_t i;
+    expression* result;
     
     if (source == NULL) return NULL;
     
+    result = new_expression_with_capacity(EXPT_NULL, EXPI_NULL, source->child_count);
+    
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL) continue;
         append_child(result, copy_expression(source->children[i]));
@@ -298,28 +440,45 @@ expression* copy_expression(const expression* source) {
     result->parent = source->parent;
     result->type = source->type;
     result->identifier = source->identifier;
-    result->child_count = source->child_count;
     result->sign = source->sign;
+    result->normalized = source->normalized;
     result->value = source->value;
     
+    if (source->identifier == EXPI_LITERAL) {
+        result->value.numeric.big_numerator = copy_bignum(source->value.numeric.big_numerator);
+        result->value.numeric.big_denominator = copy_bignum(source->value.numeric.big_denominator);
+    }
+    
     return result;
     
 }
 
 void replace_expression(expression* a, expression* b) {
     free_expression(a, true);
+    if (a->identifier == EXPI_LITERAL) {
+        free_bignum(a->value.numeric.big_numerator);
+        free_bignum(a->value.numeric.big_denominator);
+    }
     *a = *b;
+    if (b->children == b->inline_children) a->children = a->inline_children;
     smart_free(b);
 }
 
 void free_expression(expression* source, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
     
     if (source == NULL) {
         return;
     }
     
+    if (source->interned) {
+        if (!persistent) release_interned_expression(source);
+        return;
+    }
+    
+    invalidate_summary(source);
+    
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL) continue;
         free_expression(source->children[i], false);
@@ -329,6 +488,11 @@ void free_expression(expression* source, bool persistent) {
     source->child_count = 0;
     
     if (!persistent) {
+        if (source->identifier == EXPI_LITERAL) {
+            free_bignum(source->value.numeric.big_numerator);
+            free_bignum(source->value.numeric.big_denominator);
+        }
+        if (source->children != source->inline_children) smart_free(source->children);
         smart_free(source);
         source = NULL;
     }
@@ -350,21 +514,39 @@ void free_expressions(uint8_t expression_count, ...) {
     
 }
 
-void free_all_except(expression* source) {
+/**
+ 
+ @brief Releases everything in the arena except one expression
+ 
+ @details
+ The expression is copied out of the arena, the whole arena is rolled
+ back and the copy is moved back into the (now empty) arena.
+ 
+ @warning
+ - Every other pointer into the arena becomes invalid.
+ 
+ @param[in] source The expression to keep.
+ 
+ @return
+ - The relocated expression.
+ 
+ */
+expression* free_all_except(expression* source) {
     
-    uint16_t i;
     expression* temp;
     
-    for (i = 0; allocated_pointers[i] != source && i < ALLOCATED_POINTERS_LENGTH; i++);
-    allocated_pointers[i] = NULL;
-    
-    smart_alloc_is_recording = false;
+    current_context->allocator.is_recording = false;
     temp = copy_expression(source);
+    current_context->allocator.is_recording = true;
+    
     smart_free_all();
+    source = copy_expression(temp);
     
-    smart_alloc_is_recording = true;
-    *source = *copy_expression(temp);
+    current_context->allocator.is_recording = false;
     free_expression(temp, false);
+    current_context->allocator.is_recording = true;
+    
+    return source;
     
 }
 
@@ -373,28 +555,61 @@ void free_all_except(expression* source) {
  @brief Appends a child to an expression
  
  @details
- When @c DEBUG_MODE is set to 0 (production mode),
- the children pointer is resized to hold the new child.
+ The first @c EXPRESSION_INLINE_CHILDREN children are stored in the
+ expression itself. Beyond that, the children array is moved out of
+ line and its capacity is doubled whenever it is full, so that
+ appending n children takes O(n) time.
+ 
+ An expression holds at most @c EXPRESSION_MAX_CHILDREN children. If
+ the parent is full, the child is freed instead and the error
+ @c ERRI_MAX_CHILD_COUNT_EXCEEDED is set, which fails the query (see
+ @c symbolic4_evaluate()).
  
  @param[in,out] parent The destination parent.
  @param[in] child The child to be appended.
  
  */
 void append_child(expression* parent, expression* child) {
-    uint16_t i;
-#ifdef DEBUG_MODE
-    parent->children[parent->child_count] = child;
-    parent->child_count++;
-#else
-    for (i = 0; allocated_pointers[i] != parent->children && i < ALLOCATED_POINTERS_LENGTH; i++);
-    allocated_pointers[i] = NULL;
-    parent->children = smart_realloc(parent->children, parent->child_count + 1, sizeof(expression));
+    
+    uint16_t capacity;
+    expression** children;
+    
+    invalidate_summary(parent);
+    
+    if (parent->child_capacity == 0) {
+        parent->children = parent->inline_children;
+        parent->child_capacity = EXPRESSION_INLINE_CHILDREN;
+    }
+    
+    if (parent->child_count == EXPRESSION_MAX_CHILDREN) {
+        free_expression(child, false);
+        set_error(ERRD_EXPRESSION, ERRI_MAX_CHILD_COUNT_EXCEEDED, "");
+        return;
+    }
+    
+    if (parent->child_count == parent->child_capacity) {
+        
+        capacity = (parent->child_capacity > EXPRESSION_MAX_CHILDREN / 2) ? EXPRESSION_MAX_CHILDREN : 2 * parent->child_capacity;
+        
+        if (parent->children == parent->inline_children) {
+            children = smart_alloc(capacity, sizeof(expression*));
+            memcpy(children, parent->inline_children, parent->child_count * sizeof(expression*));
+        } else {
+            children = smart_realloc(parent->children, capacity, sizeof(expression*));
+        }
+        
+        parent->children = children;
+        parent->child_capacity = capacity;
+        
+    }
+    
     parent->children[parent->child_count] = child;
     parent->child_count++;
-#endif
+    
 }
 
-void remove_child_at_index(expression* source, uint8_t index) {
+void remove_child_at_index(expression* source, uint16_t index) {
+    invalidate_summary(source);
     free_expression(source->children[index], false);
     source->children[index] = NULL;
     remove_null_children(source);
@@ -402,7 +617,7 @@ void remove_child_at_index(expression* source, uint8_t index) {
 
 void remove_null_children(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result = new_expression(source->type, source->identifier, 0);
     
     for (i = 0; i < source->child_count; i++) {
@@ -417,13 +632,13 @@ void remove_null_children(expression* source) {
 void embed_in_list_if_necessary(expression* source) {
     if (source->identifier != EXPI_LIST) {
         replace_expression(source, new_expression(EXPT_STRUCTURE, EXPI_LIST, 1,
-                                                  source));
+                                                  copy_expression(source)));
     }
 }
 
 void merge_nested_lists(expression* source, bool recursive) {
     
-    uint8_t i, j;
+    uint16_t i, j;
     expression* result;
     
     for (i = 0; i < source->child_count && recursive; i++) {
@@ -454,7 +669,7 @@ void merge_nested_lists(expression* source, bool recursive) {
 
 void set_parents(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL) continue;
@@ -464,14 +679,213 @@ void set_parents(expression* source) {
     
 }
 
+/**
+ 
+ @brief Returns the summary of an expression
+ 
+ @details
+ The summary holds the size, the structural hash and bitsets of the
+ symbols and identifiers of the subtree. It is computed on first use
+ and cached in the nodes until any node with a valid summary is
+ mutated (see @c invalidate_summary()), which makes all summaries of
+ the context stale at once. Since the summary of a node is only ever
+ computed together with the ones of its children, a valid summary
+ implies valid summaries in the whole subtree.
+ 
+ @param[in] source The expression.
+ 
+ @return
+ - The summary.
+ 
+ */
+expression_summary get_expression_summary(const expression* source) {
+    
+    uint16_t i;
+    expression_summary result, child;
+    
+    if (source->summary.epoch == current_context->summary_epoch) return source->summary;
+    
+    result.epoch = current_context->summary_epoch;
+    result.size = 1;
+    result.symbols = (source->identifier == EXPI_SYMBOL) ? SUMMARY_SYMBOL_BIT(source->value.symbol) : 0;
+    result.operators = SUMMARY_OPERATOR_BIT(source->identifier);
+    
+    result.hash = 2166136261u;
+    result.hash = (result.hash ^ source->type) * 16777619u;
+    result.hash = (result.hash ^ source->identifier) * 16777619u;
+    result.hash = (result.hash ^ (uint8_t) source->sign) * 16777619u;
+    
+    if (source->identifier == EXPI_LITERAL) {
+        result.hash = hash_numeric_value(result.hash, &source->value.numeric);
+    } else if (source->identifier == EXPI_SYMBOL || source->identifier == EXPI_VARIABLE) {
+        result.hash = (result.hash ^ source->value.symbol) * 16777619u;
+    }
+    
+    for (i = 0; i < source->child_count; i++) {
+        
+        if (source->children[i] == NULL) {
+            result.hash = (result.hash ^ 0x9e3779b9u) * 16777619u;
+        } else {
+            child = get_expression_summary(source->children[i]);
+            result.size += child.size;
+            result.symbols |= child.symbols;
+            result.operators |= child.operators;
+            result.hash = (result.hash ^ child.hash) * 16777619u;
+        }
+        
+        result.hash ^= result.hash >> 15;
+        
+    }
+    
+    if (source != &literal_zero && source != &literal_one && source != &literal_minus_one) {
+        ((expression*) source)->summary = result;
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Marks the summaries as stale before an expression is mutated
+ 
+ @details
+ Must be called before a node which may have a valid summary is
+ modified in place. Nothing happens if the summary of the node isn't
+ valid anyway, so freshly built expressions are cheap to mutate.
+ 
+ @param[in] source The expression to be mutated.
+ 
+ */
+void invalidate_summary(expression* source) {
+    
+    if (source == NULL || source->summary.epoch != current_context->summary_epoch) return;
+    
+    if (++current_context->summary_epoch == 0) current_context->summary_epoch = 1;
+    
+}
+
+/**
+ 
+ @brief Computes a structural hash of an expression
+ 
+ @details
+ The hash covers the type, identifier, sign and value of every node
+ and the order of the children, but not the parents. Structurally
+ equal expressions (see @c expressions_are_structurally_equal()) have
+ equal hashes.
+ 
+ @param[in] source The expression to hash.
+ 
+ @return
+ - The 32-bit hash.
+ 
+ */
+uint32_t expression_hash(const expression* source) {
+    
+    if (source == NULL) return 0x9e3779b9u;
+    
+    return get_expression_summary(source).hash;
+    
+}
+
+uint32_t hash_numeric_value(uint32_t hash, const numeric_value* value) {
+    
+    if (value->big_numerator != NULL) {
+        hash = bignum_hash(hash, value->big_numerator);
+    } else {
+        hash = (hash ^ (uint32_t) value->numerator) * 16777619u;
+    }
+    
+    if (value->big_denominator != NULL) {
+        hash = bignum_hash(hash, value->big_denominator);
+    } else {
+        hash = (hash ^ (uint32_t) value->denominator) * 16777619u;
+    }
+    
+    return hash;
+    
+}
+
+bool numeric_values_are_equal(const numeric_value* a, const numeric_value* b) {
+    return compare_numeric_parts(a->numerator, a->big_numerator, b->numerator, b->big_numerator) == 0 &&
+           compare_numeric_parts(a->denominator, a->big_denominator, b->denominator, b->big_denominator) == 0;
+}
+
+/**
+ 
+ @brief Checks if two expressions are structurally equal
+ 
+ @details
+ Unlike @c expressions_are_identical(), this function compares the
+ type and the value of every node (including variables) and never
+ frees anything. Two interned expressions are compared by address.
+ 
+ @param[in] a The first expression.
+ @param[in] b The second expression.
+ 
+ @return
+ - @c true if the expressions are structurally equal, @c false
+ otherwise.
+ 
+ */
+bool expressions_are_structurally_equal(const expression* a, const expression* b) {
+    
+    uint16_t i;
+    
+    if (a == NULL || b == NULL) return a == b;
+    
+    if (a->interned && b->interned) return a == b;
+    
+    if (a->type != b->type || a->identifier != b->identifier || a->sign != b->sign || a->child_count != b->child_count) return false;
+    
+    if (a->identifier == EXPI_LITERAL && !numeric_values_are_equal(&a->value.numeric, &b->value.numeric)) return false;
+    
+    if ((a->identifier == EXPI_SYMBOL || a->identifier == EXPI_VARIABLE) && a->value.symbol != b->value.symbol) return false;
+    
+    for (i = 0; i < a->child_count; i++) {
+        if (!expressions_are_structurally_equal(a->children[i], b->children[i])) return false;
+    }
+    
+    return true;
+    
+}
+
+/**
+ 
+ @brief Checks if two expressions are identical
+ 
+ @details
+ Two interned expressions (see @c intern_expression()) are identical
+ if and only if they are the same node, which takes O(1). Otherwise
+ both trees are walked.
+ 
+ @param[in] a The first expression.
+ @param[in] b The second expression.
+ @param[in] persistent Determines if @c b should be kept. Otherwise
+ it is freed (or released if it is interned).
+ 
+ @return
+ - @c true if the expressions are identical, @c false otherwise.
+ 
+ */
 bool expressions_are_identical(const expression* a, expression* b, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
     
     if (a == NULL || b == NULL) {
         return false;
     }
     
+    if (a == b) {
+        return true;
+    }
+    
+    if (a->interned && b->interned) {
+        if (!persistent) free_expression(b, false);
+        return false;
+    }
+    
     if (a->identifier != b->identifier) {
         if (!persistent) free_expression(b, false);
         return false;
@@ -482,12 +896,12 @@ bool expressions_are_identical(const expression* a, expression* b, bool persiste
         return false;
     }
     
-    if (a->identifier == EXPI_LITERAL && (a->value.numeric.numerator != b->value.numeric.numerator || a->value.numeric.denominator != b->value.numeric.denominator)) {
+    if (a->identifier == EXPI_LITERAL && !numeric_values_are_equal(&a->value.numeric, &b->value.numeric)) {
         if (!persistent) free_expression(b, false);
         return false;
     }
     
-    if (a->identifier == EXPI_SYMBOL && strcmp(a->value.symbolic, b->value.symbolic) != 0) {
+    if (a->identifier == EXPI_SYMBOL && a->value.symbol != b->value.symbol) {
         if (!persistent) free_expression(b, false);
         return false;
     }
@@ -517,102 +931,271 @@ bool expressions_are_identical(const expression* a, expression* b, bool persiste
         
     }
     
-    if (!persistent) free_expression(b, false);
+    if (!persistent) free_expression(b, false);
+    
+    return true;
+    
+}
+
+bool expressions_are_equivalent(const expression* a, expression* b, bool persistent) {
+    
+    bool result = is_equivalent(a, b);
+    
+    if (!persistent) free_expression(b, false);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Checks if two expressions are mathematically equivalent
+ 
+ @details
+ Two literals are compared directly. Rational functions with different
+ fingerprints (see @c fingerprints_differ()) are rejected without
+ simplifying. Otherwise the difference of the expressions is
+ simplified and compared with zero; everything
+ allocated for that is rolled back afterwards. Neither argument is
+ modified or freed, so the shared constants (e.g. @c literal_zero) may
+ be passed.
+ 
+ @param[in] a The first expression.
+ @param[in] b The second expression.
+ 
+ @return
+ - @c true if the expressions are equivalent, @c false otherwise.
+ 
+ */
+bool is_equivalent(const expression* a, const expression* b) {
+    
+    bool result;
+    uintmax_t a_cross, b_cross;
+    smart_alloc_checkpoint checkpoint;
+    expression* temp;
+    
+    if (a == NULL || b == NULL) return false;
+    
+    if (a->identifier == EXPI_LITERAL && b->identifier == EXPI_LITERAL &&
+        !literal_is_big(a) && !literal_is_big(b) &&
+        a->value.numeric.denominator != 0 && b->value.numeric.denominator != 0 &&
+        multiplication(&a_cross, a->value.numeric.numerator, b->value.numeric.denominator) == RETS_SUCCESS &&
+        multiplication(&b_cross, b->value.numeric.numerator, a->value.numeric.denominator) == RETS_SUCCESS) {
+        return a_cross == b_cross && (a->sign == b->sign || a_cross == 0);
+    }
+    
+    if (fingerprints_differ(a, b)) return false;
     
-    return true;
+    checkpoint = smart_checkpoint();
+    temp = new_expression(EXPT_OPERATION, EXPI_SUBTRACTION, 2,
+                          copy_expression(a),
+                          copy_expression(b));
+    
+    simplify(temp, true);
+    
+    result = is_zero(temp);
+    smart_rollback(checkpoint);
+    
+    return result;
     
 }
 
-bool expressions_are_equivalent(const expression* a, expression* b, bool persistent) {
-    
-    expression* temp = new_expression(EXPT_OPERATION, EXPI_SUBTRACTION, 2,
-                                      copy_expression(a),
-                                      copy_expression(b));
+/**
+ 
+ @brief Checks if an expression is a given literal
+ 
+ @details
+ Like @c expressions_are_identical(), but without allocating the
+ literal. The literal isn't reduced, so 2/4 is not equal to 1/2.
+ 
+ @param[in] source The expression to check.
+ @param[in] sign The sign of the literal.
+ @param[in] numerator The numerator of the literal.
+ @param[in] denominator The denominator of the literal.
+ 
+ @return
+ - @c true if @c source is the literal, @c false otherwise.
+ 
+ */
+bool is_literal_equal(const expression* source, int8_t sign, uintmax_t numerator, uintmax_t denominator) {
+    return source != NULL &&
+           source->identifier == EXPI_LITERAL &&
+           source->sign == sign &&
+           !literal_is_big(source) &&
+           source->value.numeric.numerator == numerator &&
+           source->value.numeric.denominator == denominator;
+}
+
+/**
+ 
+ @brief Checks if a literal needs a bignum for its numerator or
+ denominator
+ 
+ */
+bool literal_is_big(const expression* source) {
+    return source->identifier == EXPI_LITERAL && (source->value.numeric.big_numerator != NULL || source->value.numeric.big_denominator != NULL);
+}
+
+/**
+ 
+ @brief Checks if an expression is the literal zero (with either sign)
+ 
+ */
+bool is_zero(const expression* source) {
+    return source != NULL && source->identifier == EXPI_LITERAL && source->value.numeric.numerator == 0 && source->value.numeric.denominator == 1;
+}
+
+bool is_one(const expression* source) {
+    return is_literal_equal(source, 1, 1, 1);
+}
+
+bool is_minus_one(const expression* source) {
+    return is_literal_equal(source, -1, 1, 1);
+}
+
+/**
+ 
+ @brief Checks if an expression is a literal with the value of an
+ integer
+ 
+ @details
+ Unlike @c is_literal_equal(), the literal doesn't need to be reduced,
+ and unlike comparing @c literal_to_double(), the check is exact.
+ 
+ @param[in] source The expression to check.
+ @param[in] value The integer.
+ 
+ @return
+ - @c true if @c source is a literal equal to @c value.
+ 
+ */
+bool literal_equals(const expression* source, intmax_t value) {
     
-    simplify(temp, true);
-    temp->sign = 1;
+    uintmax_t magnitude = (value < 0) ? -(uintmax_t) value : (uintmax_t) value;
     
-    if (!persistent) free_expression(b, false);
+    if (source == NULL || source->identifier != EXPI_LITERAL || literal_is_big(source) || source->value.numeric.denominator == 0) return false;
+    if (value == 0) return source->value.numeric.numerator == 0;
     
-    if (expressions_are_identical(temp, new_literal(1, 0, 1), false)) {
-        free_expression(temp, false);
-        return true;
-    } else {
-        free_expression(temp, false);
-        return false;
-    }
+    return source->sign == ((value < 0) ? -1 : 1) &&
+           source->value.numeric.numerator % source->value.numeric.denominator == 0 &&
+           source->value.numeric.numerator / source->value.numeric.denominator == magnitude;
     
 }
 
+/**
+ 
+ @brief Checks if an expression is a given (positive) symbol
+ 
+ @param[in] source The expression to check.
+ @param[in] symbol The id of the symbol (e.g. @c SYMBOL_PI).
+ 
+ @return
+ - @c true if @c source is the symbol, @c false otherwise.
+ 
+ */
+bool is_symbol(const expression* source, uint32_t symbol) {
+    return source != NULL && source->identifier == EXPI_SYMBOL && source->sign == 1 && source->value.symbol == symbol;
+}
+
+/**
+ 
+ @brief Checks if @c a is greater than @c b
+ 
+ @details
+ Constant expressions are first compared numerically (see
+ @c compare_by_intervals()). If their enclosures overlap, the
+ difference is simplified and has to collapse to a literal.
+ 
+ @param[in] a The first expression.
+ @param[in] b The second expression.
+ @param[in] persistent If @c false, @c b is freed.
+ 
+ @return
+ - @c true if @c a is certainly greater than @c b, @c false otherwise.
+ 
+ */
 bool expression_is_greater_than(const expression* a, expression* b, bool persistent) {
     
-    expression* temp_a = copy_expression(a);
-    expression* temp_b = copy_expression(b);
+    bool result;
+    smart_alloc_checkpoint checkpoint;
+    expression* test;
+    int8_t order = compare_by_intervals(a, b);
+    
+    if (order != 0) {
+        if (!persistent) free_expression(b, false);
+        return order > 0;
+    }
     
-    expression* test = new_expression(EXPT_OPERATION, EXPI_SUBTRACTION, 2,
-                                      temp_a,
-                                      temp_b);
+    checkpoint = smart_checkpoint();
+    test = new_expression(EXPT_OPERATION, EXPI_SUBTRACTION, 2,
+                          copy_expression(a),
+                          copy_expression(b));
     
     simplify(test, true);
     
+    result = (test->identifier == EXPI_LITERAL && test->sign == 1 && !literal_equals(test, 0));
+    smart_rollback(checkpoint);
+    
     if (!persistent) free_expression(b, false);
     
-    if (test->identifier == EXPI_LITERAL && test->sign == 1 && literal_to_double(test) != 0) {
-        free_expression(test, false);
-        return true;
-    } else {
-        free_expression(test, false);
-        return false;
-    }
+    return result;
     
 }
 
+/**
+ 
+ @brief Checks if @c a is smaller than @c b
+ 
+ @details
+ Constant expressions are first compared numerically (see
+ @c compare_by_intervals()). If their enclosures overlap, the
+ difference is simplified and has to collapse to a literal.
+ 
+ @param[in] a The first expression.
+ @param[in] b The second expression.
+ @param[in] persistent If @c false, @c b is freed.
+ 
+ @return
+ - @c true if @c a is certainly smaller than @c b, @c false otherwise.
+ 
+ */
 bool expression_is_smaller_than(const expression* a, expression* b, bool persistent) {
     
-    expression* temp_a = copy_expression(a);
-    expression* temp_b = copy_expression(b);
+    bool result;
+    smart_alloc_checkpoint checkpoint;
+    expression* test;
+    int8_t order = compare_by_intervals(a, b);
     
-    expression* test = new_expression(EXPT_OPERATION, EXPI_SUBTRACTION, 2,
-                                      temp_a,
-                                      temp_b);
+    if (order != 0) {
+        if (!persistent) free_expression(b, false);
+        return order < 0;
+    }
+    
+    checkpoint = smart_checkpoint();
+    test = new_expression(EXPT_OPERATION, EXPI_SUBTRACTION, 2,
+                          copy_expression(a),
+                          copy_expression(b));
     
     simplify(test, true);
     
+    result = (test->identifier == EXPI_LITERAL && test->sign == -1);
+    smart_rollback(checkpoint);
+    
     if (!persistent) free_expression(b, false);
     
-    if (test->identifier == EXPI_LITERAL && test->sign == -1) {
-        free_expression(test, false);
-        return true;
-    } else {
-        free_expression(test, false);
-        return false;
-    }
+    return result;
     
 }
 
 bool expression_is_constant(const expression* source) {
-    
-    uint8_t i;
-    
-    for (i = 0; i < source->child_count; i++) {
-        if (!expression_is_constant(source->children[i])) {
-            return false;
-        }
-    }
-    
-    if (source->identifier == EXPI_SYMBOL && !symbol_is_constant(source)) {
-        return false;
-    } else {
-        return true;
-    }
-    
+    return (get_expression_summary(source).symbols & ~SUMMARY_CONSTANT_SYMBOLS) == 0;
 }
 
 bool symbol_is_constant(const expression* source) {
     if (source->identifier == EXPI_SYMBOL &&
-        (strcmp(source->value.symbolic, "pi") == 0 ||
-         strcmp(source->value.symbolic, "e") == 0 ||
-         strcmp(source->value.symbolic, "i") == 0)) {
+        (source->value.symbol == SYMBOL_PI ||
+         source->value.symbol == SYMBOL_E ||
+         source->value.symbol == SYMBOL_I)) {
         return true;
     } else {
         return false;
@@ -621,7 +1204,7 @@ bool symbol_is_constant(const expression* source) {
 
 int8_t expression_contains_division(const expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     
     for (i = 0; i < source->child_count && source->identifier == EXPI_MULTIPLICATION; i++) {
         if (source->children[i]->identifier == EXPI_EXPONENTATION && source->children[i]->children[1]->sign == -1) {
@@ -644,28 +1227,29 @@ bool expression_is_reziprocal(const expression* source) {
 }
 
 bool expression_is_numerical(const expression* source) {
+    return (get_expression_summary(source).operators & SUMMARY_OPERATOR_BIT(EXPI_SYMBOL)) == 0;
+}
+
+uint32_t count_occurrences(const expression* haystack, expression* needle, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
+    uint32_t count = 0;
+    expression_summary haystack_summary, needle_summary;
     
-    for (i = 0; i < source->child_count; i++) {
-        if (!expression_is_numerical(source->children[i])) {
-            return false;
+    if (needle != NULL) {
+        
+        haystack_summary = get_expression_summary(haystack);
+        needle_summary = get_expression_summary(needle);
+        
+        if (needle_summary.size > haystack_summary.size ||
+            (needle_summary.symbols & ~haystack_summary.symbols) != 0 ||
+            (needle_summary.operators & ~haystack_summary.operators) != 0) {
+            if (!persistent) free_expression(needle, false);
+            return 0;
         }
+        
     }
     
-    if (source->identifier == EXPI_SYMBOL) {
-        return false;
-    } else {
-        return true;
-    }
-    
-}
-
-uint8_t count_occurrences(const expression* haystack, expression* needle, bool persistent) {
-    
-    uint8_t i;
-    uint8_t count = 0;
-    
     if (expressions_are_identical(haystack, needle, true)) {
         
         if (!persistent) free_expression(needle, false);
@@ -687,7 +1271,7 @@ uint8_t count_occurrences(const expression* haystack, expression* needle, bool p
 
 void replace_occurences(expression* source, const expression* child, const expression* replacement) {
     
-    uint8_t i;
+    uint16_t i;
     
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL) continue;
@@ -702,11 +1286,12 @@ void replace_occurences(expression* source, const expression* child, const expre
 
 void replace_null_with_zero(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL ||
             (source->children[i]->type == EXPT_STRUCTURE && source->children[i]->child_count == 0)) {
+            invalidate_summary(source);
             source->children[i] = new_literal(1, 0, 1);
         } else {
             replace_null_with_zero(source->children[i]);
@@ -731,21 +1316,17 @@ uint8_t swap_expressions(expression* a, expression* b) {
 
 uint8_t get_symbol_order_score(const expression* source) {
     
-    char* occurance;
-    
-    if (source->identifier != EXPI_SYMBOL || strlen(source->value.symbolic) != 1) return 100;
+    if (source->identifier != EXPI_SYMBOL) return 100;
     
-    if ((occurance = strstr(default_priorities, source->value.symbolic))) {
-        return (uint8_t) (occurance - default_priorities);
-    } else {
-        return 100;
-    }
+    return get_symbol_priority(source->value.symbol);
     
 }
 
+int8_t compare_order_keys(const expression* a, double a_score, const expression* b, double b_score);
+
 double get_order_score(const expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     double score;
     
     if (source->identifier == EXPI_LITERAL) {
@@ -766,55 +1347,160 @@ double get_order_score(const expression* source) {
     
 }
 
+/**
+ 
+ @brief Compares two expressions in a deterministic total order
+ 
+ @details
+ Expressions are compared by identifier, sign, value (literals
+ numerically, symbols by their position in the default priorities,
+ then by name) and finally by their children, lexicographically. The
+ numeric coefficients of multiplications are compared last, so that
+ like terms are adjacent (e.g. 3 * x ^ 2 comes before 2 * x ^ 3). Two
+ expressions compare equal
+ if and only if they are structurally equal (see
+ @c expressions_are_structurally_equal()).
+ 
+ @param[in] a The first expression.
+ @param[in] b The second expression.
+ 
+ @return
+ - A negative number, zero or a positive number if @c a is smaller
+ than, equal to or greater than @c b.
+ 
+ */
+int8_t compare_expressions(const expression* a, const expression* b) {
+    
+    uint16_t i;
+    int8_t result;
+    int name_order;
+    double a_value, b_value;
+    uint16_t a_start = 0, b_start = 0;
+    
+    if (a == b) return 0;
+    if (a == NULL) return -1;
+    if (b == NULL) return 1;
+    
+    if (a->identifier != b->identifier) return (a->identifier < b->identifier) ? -1 : 1;
+    if (a->type != b->type) return (a->type < b->type) ? -1 : 1;
+    
+    if (a->identifier == EXPI_LITERAL) {
+        a_value = literal_to_double(a);
+        b_value = literal_to_double(b);
+        if (a_value != b_value) return (a_value < b_value) ? -1 : 1;
+    }
+    
+    if (a->sign != b->sign) return (a->sign < b->sign) ? -1 : 1;
+    
+    if (a->identifier == EXPI_LITERAL) {
+        if ((result = compare_numeric_parts(a->value.numeric.numerator, a->value.numeric.big_numerator, b->value.numeric.numerator, b->value.numeric.big_numerator)) != 0) return result;
+        if ((result = compare_numeric_parts(a->value.numeric.denominator, a->value.numeric.big_denominator, b->value.numeric.denominator, b->value.numeric.big_denominator)) != 0) return result;
+    } else if ((a->identifier == EXPI_SYMBOL || a->identifier == EXPI_VARIABLE) && a->value.symbol != b->value.symbol) {
+        if (get_symbol_priority(a->value.symbol) != get_symbol_priority(b->value.symbol)) return (get_symbol_priority(a->value.symbol) < get_symbol_priority(b->value.symbol)) ? -1 : 1;
+        name_order = strcmp(get_symbol_name(a->value.symbol), get_symbol_name(b->value.symbol));
+        return (name_order < 0) ? -1 : 1;
+    }
+    
+    if (a->identifier == EXPI_MULTIPLICATION) {
+        if (a->child_count > 0 && a->children[0] != NULL && a->children[0]->identifier == EXPI_LITERAL) a_start = 1;
+        if (b->child_count > 0 && b->children[0] != NULL && b->children[0]->identifier == EXPI_LITERAL) b_start = 1;
+    }
+    
+    for (i = 0; a_start + i < a->child_count && b_start + i < b->child_count; i++) {
+        if ((result = compare_expressions(a->children[a_start + i], b->children[b_start + i])) != 0) return result;
+    }
+    
+    if (a->child_count - a_start != b->child_count - b_start) return (a->child_count - a_start < b->child_count - b_start) ? -1 : 1;
+    if (a_start != b_start) return (a_start < b_start) ? -1 : 1;
+    if (a_start == 1) return compare_expressions(a->children[0], b->children[0]);
+    
+    return 0;
+    
+}
+
+int8_t compare_order_keys(const expression* a, double a_score, const expression* b, double b_score) {
+    if (a_score != b_score) return (a_score < b_score) ? -1 : 1;
+    return compare_expressions(a, b);
+}
+
+/**
+ 
+ @brief Sorts the children of an addition or multiplication into
+ their canonical order
+ 
+ @details
+ The children are ordered by their order score (see
+ @c get_order_score()), which is computed once per child; ties are
+ broken by @c compare_expressions(), so equal expressions always
+ result in identical trees. The children are sorted in place with a
+ stable merge sort.
+ 
+ @param[in,out] source The expression whose children are sorted.
+ 
+ */
 void order_children(expression* source) {
     
-    uint8_t i;
+    size_t i, j, k;
+    size_t width, middle, end;
     expression** expressions;
+    expression** buffer;
     double* scores;
-    uint8_t min_index;
-    double min_score;
-    expression* result;
+    double* buffer_scores;
     
     if (source->identifier != EXPI_ADDITION && source->identifier != EXPI_MULTIPLICATION) return;
     
-    expressions = smart_alloc(source->child_count, sizeof(expression));
-    scores = smart_alloc(source->child_count, sizeof(double));
+    remove_null_children(source);
     
-    result = new_expression(source->type, source->identifier, 0);
+    if (source->child_count < 2) return;
     
-    remove_null_children(source);
+    invalidate_summary(source);
+    
+    expressions = source->children;
+    buffer = smart_alloc(source->child_count, sizeof(expression*));
+    scores = smart_alloc(source->child_count, sizeof(double));
+    buffer_scores = smart_alloc(source->child_count, sizeof(double));
     
     for (i = 0; i < source->child_count; i++) {
-        expressions[i] = source->children[i];
-        scores[i] = get_order_score(source->children[i]);
+        scores[i] = get_order_score(expressions[i]);
     }
-
-    while (result->child_count != source->child_count) {
-
-        min_index = 0;
-        min_score = uintmax_max_value();
-
-        for (i = 0; i < source->child_count; i++) {
-            if (scores[i] < min_score && scores[i] != 0) {
-                min_index = i;
-                min_score = scores[i];
+    
+    for (width = 1; width < source->child_count; width *= 2) {
+        
+        for (i = 0; i < source->child_count; i += 2 * width) {
+            
+            middle = min(i + width, source->child_count);
+            end = min(i + 2 * width, source->child_count);
+            
+            for (j = i, k = middle; j < middle || k < end; ) {
+                if (k == end || (j < middle && compare_order_keys(expressions[j], scores[j], expressions[k], scores[k]) <= 0)) {
+                    buffer[j + k - middle] = expressions[j];
+                    buffer_scores[j + k - middle] = scores[j];
+                    j++;
+                } else {
+                    buffer[j + k - middle] = expressions[k];
+                    buffer_scores[j + k - middle] = scores[k];
+                    k++;
+                }
             }
+            
         }
-
-        append_child(result, copy_expression(expressions[min_index]));
-        scores[min_index] = 0;
-
+        
+        memcpy(expressions, buffer, source->child_count * sizeof(expression*));
+        memcpy(scores, buffer_scores, source->child_count * sizeof(double));
+        
     }
     
-    smart_free(expressions);
+    smart_free(buffer);
     smart_free(scores);
-    replace_expression(source, result);
+    smart_free(buffer_scores);
     
 }
 
 void collect_symbols(expression* symbols, const expression* source) {
     
-    uint8_t i;
+    uint16_t i;
+    
+    if ((get_expression_summary(source).operators & (SUMMARY_OPERATOR_BIT(EXPI_SYMBOL) | SUMMARY_OPERATOR_BIT(EXPI_VARIABLE))) == 0) return;
     
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL) continue;
@@ -829,7 +1515,8 @@ void collect_symbols(expression* symbols, const expression* source) {
 
 expression* guess_symbol(const expression* source, const char* custom_priorities, uint8_t rank) {
     
-    uint8_t i, j;
+    uint8_t i;
+    uint16_t j;
     expression* symbols = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
     expression* symbol;
     
@@ -837,7 +1524,7 @@ expression* guess_symbol(const expression* source, const char* custom_priorities
     
     for (i = 0; custom_priorities[i] != '\0'; i++) {
         for (j = 0; j < symbols->child_count; j++) {
-            if (strlen(symbols->children[j]->value.symbolic) == 1 && symbols->children[j]->value.symbolic[0] == custom_priorities[i]) {
+            if (get_symbol_letter(symbols->children[j]->value.symbol) == custom_priorities[i]) {
                 if (rank == 0) {
                     symbol = copy_expression(symbols->children[j]);
                     free_expression(symbols, false);
@@ -849,9 +1536,9 @@ expression* guess_symbol(const expression* source, const char* custom_priorities
         }
     }
     
-    for (i = 0; default_priorities[i] != '\0'; i++) {
+    for (i = 0; current_context->default_priorities[i] != '\0'; i++) {
         for (j = 0; j < symbols->child_count; j++) {
-            if (strlen(symbols->children[j]->value.symbolic) == 1 && symbols->children[j]->value.symbolic[0] == default_priorities[i]) {
+            if (get_symbol_letter(symbols->children[j]->value.symbol) == current_context->default_priorities[i]) {
                 if (rank == 0) {
                     symbol = copy_expression(symbols->children[j]);
                     free_expression(symbols, false);
@@ -905,13 +1592,26 @@ expression* double_to_literal(double source) {
     
 }
 
-double literal_to_double(expression* source) {
-    return source->sign * ((double) source->value.numeric.numerator) / ((double) source->value.numeric.denominator);
+double literal_to_double(const expression* source) {
+    
+    int32_t numerator_exponent = 0;
+    int32_t denominator_exponent = 0;
+    double numerator, denominator;
+    
+    if (!literal_is_big(source)) {
+        return source->sign * ((double) source->value.numeric.numerator) / ((double) source->value.numeric.denominator);
+    }
+    
+    numerator = (source->value.numeric.big_numerator != NULL) ? bignum_to_double(source->value.numeric.big_numerator, &numerator_exponent) : source->value.numeric.numerator;
+    denominator = (source->value.numeric.big_denominator != NULL) ? bignum_to_double(source->value.numeric.big_denominator, &denominator_exponent) : source->value.numeric.denominator;
+    
+    return source->sign * ldexp(numerator / denominator, numerator_exponent - denominator_exponent);
+    
 }
 
 void literal_to_double_symbol(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     char* buffer;
     
     for (i = 0; i < source->child_count; i++) {
@@ -935,8 +1635,8 @@ void literal_to_double_symbol(expression* source) {
  The @c keyword_identifiers array is searched for the first occurrence
  of the given identifier. When found, the string from
  @c keyword_strings with the same index is returned. If
- @c use_abbrevations is set to true, the abbrevation (the next string,
- if existent) is returned.
+ @c use_abbrevations of the current context is set to true, the
+ abbrevation (the next string, if existent) is returned.
  
  @param[in] identifier The expression identifier.
  
@@ -953,7 +1653,7 @@ const char* get_expression_string(expression_identifier identifier) {
     
     for (i = 0; keyword_identifiers[i] != EXPI_NULL; i++) {
         if (keyword_identifiers[i] == identifier) {
-            if (use_abbrevations && keyword_identifiers[i + 1] == identifier) {
+            if (current_context->use_abbrevations && keyword_identifiers[i + 1] == identifier) {
                 return keyword_strings[i + 1];
             } else {
                 return keyword_strings[i];
@@ -1015,79 +1715,158 @@ expression_identifier get_expression_identifier(const char* string) {
  @c expression_to_tkiz(), depending on the specified format. It
  automatically converts all polynomials to expressions and sets
  parents. No further simplification is applied. The result can be
- tweaked by changing the bools @c use_abbrevations and @c use_spaces,
- defined in symbolic4.c.
+ tweaked by changing the options @c use_abbrevations and
+ @c use_spaces of the current context (see @c symbolic4_context).
  
- @param[in,out] buffer The buffer where the resulting string shall be
- written into.
+ The string is built in a scratch buffer of the arena, which is sized
+ by @c expression_string_length_bound(), and only copied into
+ @c buffer if it fits.
+ 
+ @param[in,out] buffer The null-terminated buffer the resulting string
+ is appended to.
+ @param[in] buffer_length The size of @c buffer in bytes.
  @param[in] source The expression to be serialized.
  @param[in] format The serialization format.
  
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR (@c ERRI_BUFFER_OVERFLOW) if the
+ string doesn't fit into the buffer. The buffer is left unchanged in
+ that case.
+ 
  @see
  - expression_to_infix()
  - expression_to_tkiz()
  
  */
-void expression_to_string(char* buffer, const expression* source, expression_to_string_format format) {
+uint8_t expression_to_string(char* buffer, size_t buffer_length, const expression* source, expression_to_string_format format) {
     
+    size_t length;
+    char* temp_buffer;
+    smart_alloc_checkpoint checkpoint = smart_checkpoint();
     expression* temp_source = copy_expression(source);
     
     any_expression_to_expression_recursive(temp_source);
     set_parents(temp_source);
     
+    temp_buffer = smart_alloc(expression_string_length_bound(temp_source) + 48, sizeof(char));
+    
     switch (format) {
-        case ETSF_INFIX: expression_to_infix(buffer, temp_source); break;
-        case ETSF_TIKZ: strcat(buffer, "\\begin{tikzpicture}"); expression_to_tikz(buffer, temp_source); strcat(buffer, ";\\end{tikzpicture}"); break;
-        default: expression_to_infix(buffer, temp_source); break;
+        case ETSF_INFIX: expression_to_infix(temp_buffer, temp_source); break;
+        case ETSF_TIKZ: strcat(temp_buffer, "\\begin{tikzpicture}"); expression_to_tikz(temp_buffer, temp_source); strcat(temp_buffer, ";\\end{tikzpicture}"); break;
+        default: expression_to_infix(temp_buffer, temp_source); break;
     }
     
-    free_expression(temp_source, false);
+    length = strlen(temp_buffer);
+    
+    if (buffer_length == 0 || strlen(buffer) + length >= buffer_length) {
+        smart_rollback(checkpoint);
+        return set_error(ERRD_SYSTEM, ERRI_BUFFER_OVERFLOW, "");
+    }
+    
+    memcpy(buffer + strlen(buffer), temp_buffer, length + 1);
+    smart_rollback(checkpoint);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Returns an upper bound of the length of the serialization of an
+ expression
+ 
+ @details
+ Every node is charged for its name, its digits and a constant for the
+ parentheses, signs and markup of both @c expression_to_infix() and
+ @c expression_to_tikz(). Operations and functions are additionally
+ charged for the separators between their children.
+ 
+ @param[in] source The expression.
+ 
+ @return
+ - The upper bound, without the null terminator.
+ 
+ */
+size_t expression_string_length_bound(const expression* source) {
+    
+    uint16_t i;
+    size_t length = 48;
+    const char* name;
+    
+    if (source->identifier == EXPI_LITERAL) {
+        length += (source->value.numeric.big_numerator != NULL) ? source->value.numeric.big_numerator->length * (BIGNUM_LIMB_BITS / 3 + 1) : 3 * sizeof(uintmax_t);
+        length += (source->value.numeric.big_denominator != NULL) ? source->value.numeric.big_denominator->length * (BIGNUM_LIMB_BITS / 3 + 1) : 3 * sizeof(uintmax_t);
+        return length;
+    }
+    
+    if (source->identifier == EXPI_SYMBOL || source->identifier == EXPI_VARIABLE) {
+        return length + strlen(get_symbol_name(source->value.symbol));
+    }
+    
+    name = get_expression_string(source->identifier);
+    length += strlen(name);
+    
+    for (i = 0; i < source->child_count; i++) {
+        if (source->children[i] == NULL) continue;
+        length += 2 + strlen(name) + expression_string_length_bound(source->children[i]);
+    }
+    
+    return length;
     
 }
 
+/**
+ 
+ @brief Appends a numerator or denominator to a string
+ 
+ */
+void numeric_part_to_string(char* buffer, uintmax_t value, const bignum* big_value) {
+    if (big_value != NULL) {
+        bignum_to_string(buffer + strlen(buffer), big_value);
+    } else {
+        itoa(buffer + strlen(buffer), value);
+    }
+}
+
 void expression_to_infix(char* buffer, const expression* source) {
     
-    uint8_t i;
-    char temp_buffer[30];
+    uint16_t i;
     expression* temp_source = copy_expression(source);
     
     if (temp_source->identifier == EXPI_LITERAL) {
         if (temp_source->value.numeric.denominator == 1) {
             if (temp_source->sign == -1) strcat(buffer, "(-");
-            itoa(temp_buffer, temp_source->value.numeric.numerator);
-            strcat(buffer, temp_buffer);
+            numeric_part_to_string(buffer, temp_source->value.numeric.numerator, temp_source->value.numeric.big_numerator);
             if (temp_source->sign == -1) strcat(buffer, ")");
         } else {
             strcat(buffer, "(");
             if (temp_source->sign == -1) strcat(buffer, "-");
-            itoa(temp_buffer, temp_source->value.numeric.numerator);
-            strcat(buffer, temp_buffer);
-            strcat(buffer, (use_spaces) ? " / " : "/");
-            itoa(temp_buffer, temp_source->value.numeric.denominator);
-            strcat(buffer, temp_buffer);
+            numeric_part_to_string(buffer, temp_source->value.numeric.numerator, temp_source->value.numeric.big_numerator);
+            strcat(buffer, (current_context->use_spaces) ? " / " : "/");
+            numeric_part_to_string(buffer, temp_source->value.numeric.denominator, temp_source->value.numeric.big_denominator);
             strcat(buffer, ")");
         }
     }
     
     if (temp_source->identifier == EXPI_SYMBOL || temp_source->identifier == EXPI_VARIABLE) {
-        strcat(buffer, temp_source->value.symbolic);
+        strcat(buffer, get_symbol_name(temp_source->value.symbol));
     }
     
     if (temp_source->type == EXPT_OPERATION) {
         if (temp_source->parent == NULL || (temp_source->identifier >= temp_source->parent->identifier || temp_source->parent->type != EXPT_OPERATION)) {
             for (i = 0; i < temp_source->child_count; i++) {
                 expression_to_infix(buffer, temp_source->children[i]);
-                if (use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
+                if (current_context->use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
                 if (i != temp_source->child_count - 1) strcat(buffer, get_expression_string(temp_source->identifier));
-                if (use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
+                if (current_context->use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
             }
         } else {
             strcat(buffer, "(");
             for (i = 0; i < temp_source->child_count; i++) {
                 expression_to_infix(buffer, temp_source->children[i]);
-                if (use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
+                if (current_context->use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
                 if (i != temp_source->child_count - 1) strcat(buffer, get_expression_string(temp_source->identifier));
-                if (use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
+                if (current_context->use_spaces && i != temp_source->child_count - 1) strcat(buffer, " ");
             }
             strcat(buffer, ")");
         }
@@ -1098,7 +1877,7 @@ void expression_to_infix(char* buffer, const expression* source) {
         strcat(buffer, "(");
         for (i = 0; i < temp_source->child_count; i++) {
             expression_to_infix(buffer, temp_source->children[i]);
-            if (i != temp_source->child_count - 1) strcat(buffer, (use_spaces) ? ", " : ",");
+            if (i != temp_source->child_count - 1) strcat(buffer, (current_context->use_spaces) ? ", " : ",");
         }
         strcat(buffer, ")");
     }
@@ -1121,23 +1900,19 @@ void expression_to_infix(char* buffer, const expression* source) {
  */
 void expression_to_tikz(char* buffer, const expression* source) {
     
-    uint8_t i;
-    char temp_buffer[30];
+    uint16_t i;
     expression* temp_source = copy_expression(source);
     
     if (temp_source->identifier == EXPI_LITERAL) {
         strcat(buffer, "child{node{$");
         if (temp_source->sign == -1) strcat(buffer, "- ");
         if (temp_source->value.numeric.denominator == 1) {
-            itoa(temp_buffer, temp_source->value.numeric.numerator);
-            strcat(buffer, temp_buffer);
+            numeric_part_to_string(buffer, temp_source->value.numeric.numerator, temp_source->value.numeric.big_numerator);
         } else {
             strcat(buffer, "\\frac{");
-            itoa(temp_buffer, temp_source->value.numeric.numerator);
-            strcat(buffer, temp_buffer);
+            numeric_part_to_string(buffer, temp_source->value.numeric.numerator, temp_source->value.numeric.big_numerator);
             strcat(buffer, "}{");
-            itoa(temp_buffer, temp_source->value.numeric.denominator);
-            strcat(buffer, temp_buffer);
+            numeric_part_to_string(buffer, temp_source->value.numeric.denominator, temp_source->value.numeric.big_denominator);
             strcat(buffer, "}");
         }
         strcat(buffer, "$}}");
@@ -1146,7 +1921,7 @@ void expression_to_tikz(char* buffer, const expression* source) {
     if (temp_source->identifier == EXPI_SYMBOL || temp_source->identifier == EXPI_VARIABLE) {
         strcat(buffer, "child{node{$");
         if (temp_source->sign == -1) strcat(buffer, "- ");
-        strcat(buffer, (strcmp(temp_source->value.symbolic, "pi") == 0) ? "\\pi" : temp_source->value.symbolic);
+        strcat(buffer, (temp_source->value.symbol == SYMBOL_PI) ? "\\pi" : get_symbol_name(temp_source->value.symbol));
         strcat(buffer, "$}}");
     }
     
@@ -1176,7 +1951,7 @@ void expression_to_tikz(char* buffer, const expression* source) {
 void print_expression(const expression* source) {
     char buffer[500];
     memset(buffer, '\0', 500);
-    expression_to_string(buffer, source, ETSF_INFIX);
+    expression_to_string(buffer, 500, source, ETSF_INFIX);
     printf("%s\n", buffer);
 }
 #endif
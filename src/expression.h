@@ -104,28 +104,64 @@ typedef enum {
     ETSF_TIKZ
 } expression_to_string_format;
 
+/**
+ 
+ @brief The value of a literal
+ 
+ @details
+ A numerator or denominator which doesn't fit into a @c uintmax_t is
+ stored as a bignum instead; the native field holds @c UINTMAX_MAX
+ then. Literals with bignums are always kept in lowest terms (see
+ @c new_big_literal()).
+ 
+ */
 typedef struct numeric_value {
     uintmax_t numerator;
     uintmax_t denominator;
+    struct bignum* big_numerator;
+    struct bignum* big_denominator;
 } numeric_value;
 
+/**
+ 
+ @brief A lazily computed summary of a subtree
+ 
+ @details
+ The summary is valid if its epoch equals the summary epoch of the
+ current context (see @c get_expression_summary()).
+ 
+ */
+typedef struct expression_summary {
+    uint32_t epoch;
+    uint32_t size; ///< The number of nodes in the subtree
+    uint32_t hash; ///< The structural hash (see @c expression_hash())
+    uint64_t symbols; ///< A bitset of the symbols in the subtree (see @c SUMMARY_SYMBOL_BIT)
+    uint64_t operators; ///< A bitset of the identifiers in the subtree (see @c SUMMARY_OPERATOR_BIT)
+} expression_summary;
+
+/// The constants pi, e and i map to the bits 0 to 2, all other symbols share the remaining 61 bits
+#define SUMMARY_SYMBOL_BIT(symbol) ((uint64_t) 1 << (((symbol) <= SYMBOL_I) ? (symbol) : 3 + ((symbol) - 3) % 61))
+#define SUMMARY_CONSTANT_SYMBOLS ((uint64_t) 7)
+#define SUMMARY_OPERATOR_BIT(identifier) ((uint64_t) 1 << (identifier))
+
 typedef struct expression {
     
     expression_type type;
     expression_identifier identifier;
     
     int8_t sign;
+    bool interned; ///< Owned by the expression table of the context and immutable (see @c intern_expression())
+    uint32_t normalized; ///< The simplify epoch in which the expression was simplified (see @c expression_is_normalized())
+    expression_summary summary; ///< Only cached for nodes with children; not copied by @c copy_expression()
     struct expression* parent;
-    uint8_t child_count;
+    uint16_t child_count;
+    uint16_t child_capacity;
     
-#ifdef DEBUG_MODE
-    struct expression* children[50];
-#else
-    struct expression** children;
-#endif
+    struct expression** children; ///< Points either to @c inline_children or to an out-of-line array.
+    struct expression* inline_children[EXPRESSION_INLINE_CHILDREN];
     
     union {
-        char symbolic[10];
+        uint32_t symbol; ///< An id of the symbol table of the current context (see @c intern_symbol())
         numeric_value numeric;
     } value;
     
@@ -133,20 +169,40 @@ typedef struct expression {
 
 extern char* keyword_strings[];
 extern expression_identifier keyword_identifiers[];
+extern const expression literal_zero;
+extern const expression literal_one;
+extern const expression literal_minus_one;
 
 expression* new_expression(expression_type type, expression_identifier identifier, uint8_t child_count, ...);
+expression* new_expression_with_capacity(expression_type type, expression_identifier identifier, uint16_t capacity);
 expression* new_literal(int8_t sign, uintmax_t numerator, uintmax_t denominator);
+bool set_big_numeric_value(numeric_value* result, bignum* numerator, bignum* denominator);
+expression* new_big_literal(int8_t sign, bignum* numerator, bignum* denominator);
 expression* new_symbol(expression_identifier identifier, const char* value);
 expression* new_trigonometic_periodicity(uint8_t period);
 expression* copy_expression(const expression* source);
 void replace_expression(expression* a, expression* b);
 void free_expression(expression* source, bool persistent);
 void free_expressions(uint8_t expression_count, ...);
-void free_all_except(expression* source);
+expression* free_all_except(expression* source);
 void append_child(expression* parent, expression* child);
 void set_parents(expression* source);
+expression_summary get_expression_summary(const expression* source);
+void invalidate_summary(expression* source);
+uint32_t expression_hash(const expression* source);
+uint32_t hash_numeric_value(uint32_t hash, const numeric_value* value);
+bool numeric_values_are_equal(const numeric_value* a, const numeric_value* b);
+bool expressions_are_structurally_equal(const expression* a, const expression* b);
 bool expressions_are_identical(const expression* a, expression* b, bool persistent);
 bool expressions_are_equivalent(const expression* a, expression* b, bool persistent);
+bool is_equivalent(const expression* a, const expression* b);
+bool is_literal_equal(const expression* source, int8_t sign, uintmax_t numerator, uintmax_t denominator);
+bool literal_is_big(const expression* source);
+bool is_zero(const expression* source);
+bool is_one(const expression* source);
+bool is_minus_one(const expression* source);
+bool literal_equals(const expression* source, intmax_t value);
+bool is_symbol(const expression* source, uint32_t symbol);
 bool expression_is_greater_than(const expression* a, expression* b, bool persistent);
 bool expression_is_smaller_than(const expression* a, expression* b, bool persistent);
 bool expression_is_constant(const expression* source);
@@ -154,24 +210,26 @@ bool symbol_is_constant(const expression* source);
 int8_t expression_contains_division(const expression* source);
 bool expression_is_reziprocal(const expression* source);
 bool expression_is_numerical(const expression* source);
-uint8_t count_occurrences(const expression* haystack, expression* needle, bool persistent);
+uint32_t count_occurrences(const expression* haystack, expression* needle, bool persistent);
 void collect_symbols(expression* symbols, const expression* source);
-void remove_child_at_index(expression* source, uint8_t index);
+void remove_child_at_index(expression* source, uint16_t index);
 void remove_null_children(expression* source);
 void embed_in_list_if_necessary(expression* source);
 void merge_nested_lists(expression* source, bool recursive);
 uint8_t swap_expressions(expression* a, expression* b);
 void replace_occurences(expression* source, const expression* child, const expression* replacement);
 void replace_null_with_zero(expression* source);
+int8_t compare_expressions(const expression* a, const expression* b);
 void order_children(expression* source);
 expression* guess_symbol(const expression* source, const char* custom_priorities, uint8_t rank);
 expression* get_symbol(const expression* source);
 expression* double_to_literal(double source);
-double literal_to_double(expression* source);
+double literal_to_double(const expression* source);
 void literal_to_double_symbol(expression* source);
 const char* get_expression_string(expression_identifier identifier);
 expression_identifier get_expression_identifier(const char* string);
-void expression_to_string(char* buffer, const expression* source, expression_to_string_format format);
+void numeric_part_to_string(char* buffer, uintmax_t value, const bignum* big_value);
+uint8_t expression_to_string(char* buffer, size_t buffer_length, const expression* source, expression_to_string_format format);
 #ifdef DEBUG_MODE
 void print_expression(const expression* source);
 #endif
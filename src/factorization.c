@@ -0,0 +1,882 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+void add_prime_factor(factorization* result, uintmax_t prime, uint8_t exponent);
+void compute_factorization(factorization* result, uintmax_t source);
+void append_factorization(expression* factors, const factorization* source);
+uintmax_t pollard_brent_step(uintmax_t x, uintmax_t increment, uintmax_t modulus);
+bool bignum_is_one(const bignum* source);
+bignum* big_multiply_modulo(const bignum* a, const bignum* b, const bignum* modulus);
+bignum* big_absolute_difference(const bignum* a, const bignum* b);
+bool big_miller_rabin_round(const bignum* source, const bignum* source_minus_one, uint32_t shift, bignum_limb witness);
+bignum* big_pollard_brent_step(const bignum* x, const bignum* increment, const bignum* modulus);
+void add_big_prime_factor(bignum** primes, uintmax_t* exponents, uint8_t* count, bignum* prime, uintmax_t exponent);
+uintmax_t big_cofactor_power_degree(bignum** root, const bignum* source);
+bool factor_big_cofactor(bignum** primes, uintmax_t* exponents, uint8_t* count, bignum* source);
+
+factorization_cache* new_factorization_cache(void) {
+    factorization_cache* cache = calloc(1, sizeof(factorization_cache));
+    if (cache == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    return cache;
+}
+
+void free_factorization_cache(factorization_cache* cache) {
+    if (cache == NULL) return;
+    free(cache->small_primes);
+    free(cache);
+}
+
+/**
+ 
+ @brief Returns all primes below @c FACTORIZATION_SIEVE_LIMIT
+ 
+ @details
+ The primes are computed with the sieve of Eratosthenes on first use
+ and kept in the factorization cache of the current context.
+ 
+ @param[out] count The number of primes.
+ 
+ @return
+ - The primes in ascending order.
+ 
+ */
+const uint16_t* get_small_primes(size_t* count) {
+    
+    uint32_t i, j;
+    uint8_t* is_composite;
+    factorization_cache* cache = current_context->factorization_cache;
+    
+    if (cache->small_primes == NULL) {
+        
+        is_composite = calloc(FACTORIZATION_SIEVE_LIMIT, sizeof(uint8_t));
+        cache->small_primes = malloc(FACTORIZATION_SIEVE_LIMIT / 2 * sizeof(uint16_t));
+        
+        if (is_composite == NULL || cache->small_primes == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+        
+        for (i = 2; i < FACTORIZATION_SIEVE_LIMIT; i++) {
+            if (is_composite[i]) continue;
+            cache->small_primes[cache->small_prime_count++] = (uint16_t) i;
+            for (j = i * i; j < FACTORIZATION_SIEVE_LIMIT; j += i) is_composite[j] = 1;
+        }
+        
+        free(is_composite);
+        
+    }
+    
+    *count = cache->small_prime_count;
+    
+    return cache->small_primes;
+    
+}
+
+/**
+ 
+ @brief Computes <tt>a * b mod modulus</tt> without overflowing
+ 
+ */
+uintmax_t multiply_modulo(uintmax_t a, uintmax_t b, uintmax_t modulus) {
+    
+#ifdef MATH_WIDE_INTERMEDIATES
+    return (uintmax_t) ((uintwide_t) a * b % modulus);
+#else
+    
+    uintmax_t result = 0;
+    
+    a %= modulus;
+    
+    for ( ; b > 0; b >>= 1) {
+        if (b & 1) result = (result >= modulus - a) ? result - (modulus - a) : result + a;
+        a = (a >= modulus - a) ? a - (modulus - a) : a + a;
+    }
+    
+    return result;
+    
+#endif
+    
+}
+
+/**
+ 
+ @brief Computes <tt>base ^ exponent mod modulus</tt> by repeated
+ squaring
+ 
+ */
+uintmax_t power_modulo(uintmax_t base, uintmax_t exponent, uintmax_t modulus) {
+    
+    uintmax_t result = 1 % modulus;
+    
+    for (base %= modulus; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) result = multiply_modulo(result, base, modulus);
+        base = multiply_modulo(base, base, modulus);
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Checks if a native integer is prime
+ 
+ @details
+ This function uses the Miller-Rabin test with a set of seven
+ witnesses that is known to be deterministic for all integers below
+ 2^64.
+ 
+ @param[in] source The integer.
+ 
+ @return
+ - @c true if the integer is prime.
+ 
+ */
+bool is_prime(uintmax_t source) {
+    
+    uint8_t i;
+    uint8_t j;
+    uint8_t shift;
+    uintmax_t exponent;
+    uintmax_t x;
+    const uint8_t small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    const uint32_t witnesses[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    
+    if (source < 2) return false;
+    
+    for (i = 0; i < sizeof(small_primes); i++) {
+        if (source == small_primes[i]) return true;
+        if (source % small_primes[i] == 0) return false;
+    }
+    
+    if (source < 41 * 41) return true;
+    
+    shift = trailing_zeros(source - 1);
+    exponent = (source - 1) >> shift;
+    
+    for (i = 0; i < sizeof(witnesses) / sizeof(witnesses[0]); i++) {
+        
+        x = witnesses[i] % source;
+        if (x == 0) continue;
+        
+        x = power_modulo(x, exponent, source);
+        if (x == 1 || x == source - 1) continue;
+        
+        for (j = 1; j < shift; j++) {
+            x = multiply_modulo(x, x, source);
+            if (x == source - 1) break;
+        }
+        
+        if (j == shift) return false;
+        
+    }
+    
+    return true;
+    
+}
+
+uintmax_t pollard_brent_step(uintmax_t x, uintmax_t increment, uintmax_t modulus) {
+    x = multiply_modulo(x, x, modulus);
+    return (x >= modulus - increment) ? x - (modulus - increment) : x + increment;
+}
+
+/**
+ 
+ @brief Finds a nontrivial divisor of a composite integer
+ 
+ @details
+ This function uses Brent's variant of Pollard's rho algorithm, which
+ accumulates the differences of @c FACTORIZATION_RHO_BATCH steps
+ before computing a GCD. If a batch overshoots, it is repeated step by
+ step. If the cycle doesn't yield a divisor, the next polynomial is
+ tried.
+ 
+ @param[in] source The composite integer.
+ 
+ @return
+ - A nontrivial divisor.
+ 
+ */
+uintmax_t pollard_brent(uintmax_t source) {
+    
+    uintmax_t increment;
+    uintmax_t x, y, saved_y;
+    uintmax_t product, divisor;
+    uintmax_t i, k, length;
+    
+    if (source % 2 == 0) return 2;
+    
+    for (increment = 1; increment < source; increment++) {
+        
+        y = 2 % source;
+        x = y;
+        saved_y = y;
+        product = 1;
+        divisor = 1;
+        
+        for (length = 1; divisor == 1; length *= 2) {
+            
+            x = y;
+            
+            for (i = 0; i < length; i++) {
+                y = pollard_brent_step(y, increment, source);
+            }
+            
+            for (k = 0; k < length && divisor == 1; k += FACTORIZATION_RHO_BATCH) {
+                
+                saved_y = y;
+                
+                for (i = 0; i < FACTORIZATION_RHO_BATCH && i < length - k; i++) {
+                    y = pollard_brent_step(y, increment, source);
+                    product = multiply_modulo(product, (x > y) ? x - y : y - x, source);
+                }
+                
+                divisor = binary_gcd(product, source);
+                
+            }
+            
+        }
+        
+        if (divisor == source) {
+            do {
+                saved_y = pollard_brent_step(saved_y, increment, source);
+                divisor = binary_gcd((x > saved_y) ? x - saved_y : saved_y - x, source);
+            } while (divisor == 1);
+        }
+        
+        if (divisor != source) return divisor;
+        
+    }
+    
+    return source;
+    
+}
+
+/**
+ 
+ @brief Adds a prime to a factorization while keeping the primes
+ sorted
+ 
+ */
+void add_prime_factor(factorization* result, uintmax_t prime, uint8_t exponent) {
+    
+    uint8_t i, j;
+    
+    for (i = 0; i < result->count && result->primes[i] < prime; i++);
+    
+    if (i < result->count && result->primes[i] == prime) {
+        result->exponents[i] += exponent;
+        return;
+    }
+    
+    for (j = result->count; j > i; j--) {
+        result->primes[j] = result->primes[j - 1];
+        result->exponents[j] = result->exponents[j - 1];
+    }
+    
+    result->primes[i] = prime;
+    result->exponents[i] = exponent;
+    result->count++;
+    
+}
+
+/**
+ 
+ @brief Factorizes a native integer
+ 
+ @details
+ Factors below @c FACTORIZATION_SIEVE_LIMIT are found by trial
+ division. A remaining cofactor is split with @c pollard_brent() until
+ all parts pass @c is_prime().
+ 
+ */
+void compute_factorization(factorization* result, uintmax_t source) {
+    
+    size_t i;
+    size_t prime_count;
+    uint8_t exponent;
+    uint8_t stack_count = 0;
+    uintmax_t prime;
+    uintmax_t divisor;
+    uintmax_t stack[FACTORIZATION_MAX_PRIMES];
+    const uint16_t* small_primes = get_small_primes(&prime_count);
+    
+    result->source = source;
+    result->count = 0;
+    
+    if (source < 2) return;
+    
+    for (i = 0; i < prime_count; i++) {
+        
+        prime = small_primes[i];
+        
+        if (prime * prime > source) break;
+        if (source % prime != 0) continue;
+        
+        for (exponent = 0; source % prime == 0; exponent++) {
+            source /= prime;
+        }
+        
+        add_prime_factor(result, prime, exponent);
+        
+    }
+    
+    if (source == 1) return;
+    
+    if (i < prime_count) {
+        add_prime_factor(result, source, 1);
+        return;
+    }
+    
+    stack[stack_count++] = source;
+    
+    while (stack_count > 0) {
+        
+        source = stack[--stack_count];
+        
+        if (is_prime(source)) {
+            add_prime_factor(result, source, 1);
+        } else {
+            divisor = pollard_brent(source);
+            stack[stack_count++] = divisor;
+            stack[stack_count++] = source / divisor;
+        }
+        
+    }
+    
+}
+
+/**
+ 
+ @brief Factorizes a native integer
+ 
+ @details
+ Recent factorizations are looked up in the factorization cache of
+ the current context first.
+ 
+ @param[out] result The factorization. It is empty for 0 and 1.
+ @param[in] source The integer.
+ 
+ */
+void factor_integer(factorization* result, uintmax_t source) {
+    
+    factorization_cache* cache = current_context->factorization_cache;
+    factorization* entry = &cache->entries[source % FACTORIZATION_CACHE_SIZE];
+    
+    if (source >= 2 && entry->source == source) {
+        cache->hits++;
+        *result = *entry;
+        return;
+    }
+    
+    cache->misses++;
+    compute_factorization(result, source);
+    
+    if (source >= 2) *entry = *result;
+    
+}
+
+void append_factorization(expression* factors, const factorization* source) {
+    
+    uint8_t i;
+    
+    for (i = 0; i < source->count; i++) {
+        append_child(factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
+                                             new_literal(1, source->primes[i], 1),
+                                             new_literal(1, source->exponents[i], 1)));
+    }
+    
+}
+
+/**
+ 
+ @brief Computes the prime factors of a native integer
+ 
+ @param[in] source The integer.
+ 
+ @return
+ - A list of lists with a prime and its exponent each, sorted by the
+ primes.
+ 
+ */
+expression* prime_factors(uintmax_t source) {
+    
+    factorization temp;
+    expression* factors = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
+    
+    factor_integer(&temp, source);
+    append_factorization(factors, &temp);
+    
+    return factors;
+    
+}
+
+bool bignum_is_one(const bignum* source) {
+    return source->length == 1 && source->limbs[0] == 1;
+}
+
+bignum* big_multiply_modulo(const bignum* a, const bignum* b, const bignum* modulus) {
+    
+    bignum* product = bignum_multiply(a, b);
+    bignum* result;
+    
+    bignum_divide(NULL, &result, product, modulus);
+    free_bignum(product);
+    
+    return result;
+    
+}
+
+bignum* big_absolute_difference(const bignum* a, const bignum* b) {
+    return (bignum_compare(a, b) > 0) ? bignum_subtract(a, b) : bignum_subtract(b, a);
+}
+
+/**
+ 
+ @brief Performs one round of the Miller-Rabin test on a bignum
+ 
+ @param[in] source The odd bignum to be tested.
+ @param[in] source_minus_one The bignum minus one.
+ @param[in] shift The number of trailing zero bits of
+ @c source_minus_one.
+ @param[in] witness The witness.
+ 
+ @return
+ - @c false if the witness proves that the bignum is composite.
+ 
+ */
+bool big_miller_rabin_round(const bignum* source, const bignum* source_minus_one, uint32_t shift, bignum_limb witness) {
+    
+    uint32_t i;
+    bool result;
+    bignum* base = new_bignum(witness);
+    bignum* x = new_bignum(1);
+    bignum* temp;
+    
+    for (i = bignum_bit_length(source_minus_one); i > shift; i--) {
+        
+        temp = big_multiply_modulo(x, x, source);
+        free_bignum(x);
+        x = temp;
+        
+        if (BIGNUM_BIT(source_minus_one, i - 1)) {
+            temp = big_multiply_modulo(x, base, source);
+            free_bignum(x);
+            x = temp;
+        }
+        
+    }
+    
+    result = bignum_is_one(x) || bignum_compare(x, source_minus_one) == 0;
+    
+    for (i = 1; i < shift && !result; i++) {
+        temp = big_multiply_modulo(x, x, source);
+        free_bignum(x);
+        x = temp;
+        result = bignum_compare(x, source_minus_one) == 0;
+    }
+    
+    free_bignum(base);
+    free_bignum(x);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Checks if an odd bignum is probably prime
+ 
+ @details
+ This function performs the Miller-Rabin test with the twelve smallest
+ primes as witnesses, which is deterministic below 3.3 * 10^24 and
+ has a negligible error probability beyond.
+ 
+ @param[in] source The odd bignum, which must be larger than 37.
+ 
+ @return
+ - @c true if the bignum is probably prime.
+ 
+ */
+bool big_is_probable_prime(const bignum* source) {
+    
+    uint8_t i;
+    uint32_t shift = 0;
+    bool result = true;
+    const uint8_t witnesses[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    bignum* one = new_bignum(1);
+    bignum* source_minus_one = bignum_subtract(source, one);
+    
+    while (BIGNUM_BIT(source_minus_one, shift) == 0) shift++;
+    
+    for (i = 0; i < sizeof(witnesses) && result; i++) {
+        result = big_miller_rabin_round(source, source_minus_one, shift, witnesses[i]);
+    }
+    
+    free_bignum(one);
+    free_bignum(source_minus_one);
+    
+    return result;
+    
+}
+
+bignum* big_pollard_brent_step(const bignum* x, const bignum* increment, const bignum* modulus) {
+    
+    bignum* square = bignum_multiply(x, x);
+    bignum* sum = bignum_add(square, increment);
+    bignum* result;
+    
+    bignum_divide(NULL, &result, sum, modulus);
+    
+    free_bignum(square);
+    free_bignum(sum);
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Tries to find a nontrivial divisor of a composite bignum
+ 
+ @details
+ This is the bignum version of @c pollard_brent(). It gives up after
+ @c FACTORIZATION_BIG_RHO_ITERATIONS steps.
+ 
+ @param[in] source The composite bignum.
+ 
+ @return
+ - A nontrivial divisor, or @c NULL if none was found.
+ 
+ */
+bignum* big_pollard_brent(const bignum* source) {
+    
+    uint32_t iterations = 0;
+    uint32_t i, k, length;
+    bignum_limb c;
+    bignum* increment;
+    bignum* x;
+    bignum* y;
+    bignum* saved_y;
+    bignum* product;
+    bignum* divisor;
+    bignum* difference;
+    bignum* temp;
+    
+    for (c = 1; iterations < FACTORIZATION_BIG_RHO_ITERATIONS; c++) {
+        
+        increment = new_bignum(c);
+        x = new_bignum(2);
+        y = new_bignum(2);
+        saved_y = new_bignum(2);
+        product = new_bignum(1);
+        divisor = new_bignum(1);
+        
+        for (length = 1; bignum_is_one(divisor) && iterations < FACTORIZATION_BIG_RHO_ITERATIONS; length *= 2) {
+            
+            free_bignum(x);
+            x = copy_bignum(y);
+            
+            for (i = 0; i < length; i++, iterations++) {
+                temp = big_pollard_brent_step(y, increment, source);
+                free_bignum(y);
+                y = temp;
+            }
+            
+            for (k = 0; k < length && bignum_is_one(divisor) && iterations < FACTORIZATION_BIG_RHO_ITERATIONS; k += FACTORIZATION_RHO_BATCH) {
+                
+                free_bignum(saved_y);
+                saved_y = copy_bignum(y);
+                
+                for (i = 0; i < FACTORIZATION_RHO_BATCH && i < length - k; i++, iterations++) {
+                    
+                    temp = big_pollard_brent_step(y, increment, source);
+                    free_bignum(y);
+                    y = temp;
+                    
+                    difference = big_absolute_difference(x, y);
+                    temp = big_multiply_modulo(product, difference, source);
+                    free_bignum(difference);
+                    free_bignum(product);
+                    product = temp;
+                    
+                }
+                
+                free_bignum(divisor);
+                divisor = bignum_gcd(product, source);
+                
+            }
+            
+        }
+        
+        if (bignum_compare(divisor, source) == 0) {
+            do {
+                
+                temp = big_pollard_brent_step(saved_y, increment, source);
+                free_bignum(saved_y);
+                saved_y = temp;
+                
+                difference = big_absolute_difference(x, saved_y);
+                free_bignum(divisor);
+                divisor = bignum_gcd(difference, source);
+                free_bignum(difference);
+                
+            } while (bignum_is_one(divisor));
+        }
+        
+        free_bignum(increment);
+        free_bignum(x);
+        free_bignum(y);
+        free_bignum(saved_y);
+        free_bignum(product);
+        
+        if (!bignum_is_one(divisor) && bignum_compare(divisor, source) != 0) return divisor;
+        
+        free_bignum(divisor);
+        
+    }
+    
+    return NULL;
+    
+}
+
+/**
+ 
+ @brief Adds a prime bignum to a sorted array of primes
+ 
+ @details
+ The array takes the ownership of the prime.
+ 
+ */
+void add_big_prime_factor(bignum** primes, uintmax_t* exponents, uint8_t* count, bignum* prime, uintmax_t exponent) {
+    
+    uint8_t i, j;
+    
+    for (i = 0; i < *count && bignum_compare(primes[i], prime) < 0; i++);
+    
+    if (i < *count && bignum_compare(primes[i], prime) == 0) {
+        exponents[i] += exponent;
+        free_bignum(prime);
+        return;
+    }
+    
+    for (j = *count; j > i; j--) {
+        primes[j] = primes[j - 1];
+        exponents[j] = exponents[j - 1];
+    }
+    
+    primes[i] = prime;
+    exponents[i] = exponent;
+    (*count)++;
+    
+}
+
+/**
+ 
+ @brief Checks if a bignum without small factors is a perfect power
+ 
+ @details
+ Only prime degrees are tested, since all prime factors are at least
+ @c FACTORIZATION_SIEVE_LIMIT. Powers of composite degrees are found by
+ testing the root again.
+ 
+ @param[out] root The root, if the bignum is a perfect power.
+ @param[in] source The bignum.
+ 
+ @return
+ - The degree of the power, or 1 if the bignum isn't a perfect power.
+ 
+ */
+uintmax_t big_cofactor_power_degree(bignum** root, const bignum* source) {
+    
+    size_t i;
+    size_t prime_count;
+    uint32_t bit_length = bignum_bit_length(source);
+    const uint16_t* small_primes = get_small_primes(&prime_count);
+    
+    for (i = 0; i < prime_count && small_primes[i] * FACTORIZATION_SIEVE_BITS <= bit_length; i++) {
+        if (big_is_perfect_power(root, source, small_primes[i])) return small_primes[i];
+    }
+    
+    return 1;
+    
+}
+
+/**
+ 
+ @brief Factorizes a bignum without factors below
+ @c FACTORIZATION_SIEVE_LIMIT
+ 
+ @details
+ Perfect powers are reduced to their roots first, since Pollard's rho
+ can't split them efficiently.
+ 
+ @param[in,out] primes The sorted array of primes found so far.
+ @param[in,out] exponents The exponents of the primes.
+ @param[in,out] count The number of primes.
+ @param[in] source The bignum. It is owned by this function.
+ 
+ @return
+ - @c false if the bignum has more than @c FACTORIZATION_BIG_MAX_LIMBS
+ limbs or couldn't be split.
+ 
+ */
+bool factor_big_cofactor(bignum** primes, uintmax_t* exponents, uint8_t* count, bignum* source) {
+    
+    uint8_t i;
+    uint8_t stack_count = 0;
+    bool result = true;
+    uintmax_t exponent;
+    uintmax_t degree;
+    bignum* divisor;
+    bignum* stack[FACTORIZATION_MAX_PRIMES];
+    uintmax_t stack_exponents[FACTORIZATION_MAX_PRIMES];
+    factorization temp;
+    
+    stack[stack_count] = source;
+    stack_exponents[stack_count++] = 1;
+    
+    while (stack_count > 0) {
+        
+        source = stack[--stack_count];
+        exponent = stack_exponents[stack_count];
+        
+        if (!result) {
+            free_bignum(source);
+        } else if (bignum_fits_uintmax(source)) {
+            factor_integer(&temp, bignum_to_uintmax(source));
+            for (i = 0; i < temp.count; i++) {
+                add_big_prime_factor(primes, exponents, count, new_bignum(temp.primes[i]), temp.exponents[i] * exponent);
+            }
+            free_bignum(source);
+        } else if ((degree = big_cofactor_power_degree(&divisor, source)) > 1) {
+            stack[stack_count] = divisor;
+            stack_exponents[stack_count++] = exponent * degree;
+            free_bignum(source);
+        } else if (source->length > FACTORIZATION_BIG_MAX_LIMBS) {
+            free_bignum(source);
+            result = false;
+        } else if (big_is_probable_prime(source)) {
+            add_big_prime_factor(primes, exponents, count, source, exponent);
+        } else if ((divisor = big_pollard_brent(source)) == NULL) {
+            free_bignum(source);
+            result = false;
+        } else {
+            bignum_divide(&stack[stack_count], NULL, source, divisor);
+            stack_exponents[stack_count++] = exponent;
+            stack[stack_count] = divisor;
+            stack_exponents[stack_count++] = exponent;
+            free_bignum(source);
+        }
+        
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Computes the prime factors of the numerator or denominator of
+ a literal
+ 
+ @details
+ Bignums are divided by all primes below @c FACTORIZATION_SIEVE_LIMIT
+ until the cofactor fits into a native integer. A larger cofactor is
+ factorized with @c big_is_probable_prime() and @c big_pollard_brent()
+ if it has at most @c FACTORIZATION_BIG_MAX_LIMBS limbs.
+ 
+ @param[in] value The native value.
+ @param[in] big_value The big value, or @c NULL.
+ 
+ @return
+ - A list of lists with a prime and its exponent each, sorted by the
+ primes (see @c prime_factors()), or @c NULL if the bignum couldn't
+ be factorized completely.
+ 
+ */
+expression* numeric_part_prime_factors(uintmax_t value, const bignum* big_value) {
+    
+    uint8_t i;
+    uint8_t count = 0;
+    size_t j;
+    size_t prime_count;
+    uintmax_t exponent;
+    uintmax_t exponents[FACTORIZATION_MAX_PRIMES];
+    const uint16_t* small_primes;
+    bignum* primes[FACTORIZATION_MAX_PRIMES];
+    bignum* remaining;
+    bignum* divisor;
+    bignum* temp;
+    expression* factors;
+    factorization native;
+    
+    if (big_value == NULL) return prime_factors(value);
+    
+    factors = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
+    remaining = copy_bignum(big_value);
+    small_primes = get_small_primes(&prime_count);
+    
+    for (j = 0; j < prime_count && !bignum_fits_uintmax(remaining); j++) {
+        
+        if (bignum_remainder_by_limb(remaining, small_primes[j]) != 0) continue;
+        
+        divisor = new_bignum(small_primes[j]);
+        
+        for (exponent = 0; bignum_remainder_by_limb(remaining, small_primes[j]) == 0; exponent++) {
+            bignum_divide(&temp, NULL, remaining, divisor);
+            free_bignum(remaining);
+            remaining = temp;
+        }
+        
+        free_bignum(divisor);
+        
+        append_child(factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
+                                             new_literal(1, small_primes[j], 1),
+                                             new_literal(1, exponent, 1)));
+        
+    }
+    
+    if (bignum_fits_uintmax(remaining)) {
+        factor_integer(&native, bignum_to_uintmax(remaining));
+        append_factorization(factors, &native);
+        free_bignum(remaining);
+        return factors;
+    }
+    
+    if (!factor_big_cofactor(primes, exponents, &count, remaining)) {
+        for (i = 0; i < count; i++) free_bignum(primes[i]);
+        free_expression(factors, false);
+        return NULL;
+    }
+    
+    for (i = 0; i < count; i++) {
+        append_child(factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
+                                             new_big_literal(1, primes[i], new_bignum(1)),
+                                             new_literal(1, exponents[i], 1)));
+    }
+    
+    return factors;
+    
+}
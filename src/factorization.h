@@ -0,0 +1,73 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef factorization_h
+#define factorization_h
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief The prime factorization of a native integer
+ 
+ */
+typedef struct factorization {
+    uintmax_t source; ///< The factorized integer (0 for an empty cache entry)
+    uint8_t count; ///< The number of distinct primes
+    uintmax_t primes[FACTORIZATION_MAX_PRIMES]; ///< The primes in ascending order
+    uint8_t exponents[FACTORIZATION_MAX_PRIMES];
+} factorization;
+
+/**
+ 
+ @brief The small primes and the recent factorizations of a context
+ 
+ @details
+ The small primes are sieved on first use. The cache is direct mapped,
+ so a new factorization replaces the one in its slot.
+ 
+ */
+typedef struct factorization_cache {
+    uint16_t* small_primes; ///< All primes below @c FACTORIZATION_SIEVE_LIMIT (@c NULL until sieved)
+    size_t small_prime_count;
+    factorization entries[FACTORIZATION_CACHE_SIZE];
+    uintmax_t hits;
+    uintmax_t misses;
+} factorization_cache;
+
+factorization_cache* new_factorization_cache(void);
+void free_factorization_cache(factorization_cache* cache);
+const uint16_t* get_small_primes(size_t* count);
+uintmax_t multiply_modulo(uintmax_t a, uintmax_t b, uintmax_t modulus);
+uintmax_t power_modulo(uintmax_t base, uintmax_t exponent, uintmax_t modulus);
+bool is_prime(uintmax_t source);
+uintmax_t pollard_brent(uintmax_t source);
+void factor_integer(factorization* result, uintmax_t source);
+expression* prime_factors(uintmax_t source);
+bool big_is_probable_prime(const bignum* source);
+bignum* big_pollard_brent(const bignum* source);
+expression* numeric_part_prime_factors(uintmax_t value, const bignum* big_value);
+
+#endif /* factorization_h */
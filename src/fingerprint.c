@@ -0,0 +1,262 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+uintmax_t get_symbol_fingerprint(uint32_t symbol);
+uintmax_t get_literal_part_fingerprint(uintmax_t value, const bignum* big_value);
+bool get_literal_fingerprint(uintmax_t* result, const expression* source);
+bool get_power_fingerprint(uintmax_t* result, uintmax_t base, const expression* exponent);
+bool get_polynomial_fingerprint(uintmax_t* result, const expression* source);
+
+/**
+ 
+ @brief Returns the point at which a symbol is evaluated
+ 
+ @details
+ The points are pseudo-random (SplitMix64 of the symbol id), but fixed,
+ so results are reproducible.
+ 
+ */
+uintmax_t get_symbol_fingerprint(uint32_t symbol) {
+    
+    uint64_t result = (uint64_t) symbol + 0x9E3779B97F4A7C15ull;
+    
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ull;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EBull;
+    result ^= result >> 31;
+    
+    return (uintmax_t) (result % FINGERPRINT_MODULUS);
+    
+}
+
+uintmax_t get_literal_part_fingerprint(uintmax_t value, const bignum* big_value) {
+    
+    uint16_t i;
+    uintmax_t result = 0;
+    uintmax_t limb_base = ((uintmax_t) 1 << (BIGNUM_LIMB_BITS - 1)) % FINGERPRINT_MODULUS * 2 % FINGERPRINT_MODULUS;
+    
+    if (big_value == NULL) return value % FINGERPRINT_MODULUS;
+    
+    for (i = big_value->length; i > 0; i--) {
+        result = multiply_modulo(result, limb_base, FINGERPRINT_MODULUS);
+        result = (result + big_value->limbs[i - 1]) % FINGERPRINT_MODULUS;
+    }
+    
+    return result;
+    
+}
+
+bool get_literal_fingerprint(uintmax_t* result, const expression* source) {
+    
+    const numeric_value* value = &source->value.numeric;
+    uintmax_t numerator = get_literal_part_fingerprint(value->numerator, value->big_numerator);
+    uintmax_t denominator = get_literal_part_fingerprint(value->denominator, value->big_denominator);
+    
+    if (denominator == 0) return false;
+    
+    if (denominator == 1) {
+        *result = numerator;
+        return true;
+    }
+    
+    *result = multiply_modulo(numerator, power_modulo(denominator, FINGERPRINT_MODULUS - 2, FINGERPRINT_MODULUS), FINGERPRINT_MODULUS);
+    
+    return true;
+    
+}
+
+bool get_power_fingerprint(uintmax_t* result, uintmax_t base, const expression* exponent) {
+    
+    if (exponent->identifier != EXPI_LITERAL || literal_is_big(exponent) || exponent->value.numeric.denominator != 1) return false;
+    
+    if (exponent->sign == -1 && exponent->value.numeric.numerator != 0) {
+        if (base == 0) return false;
+        base = power_modulo(base, FINGERPRINT_MODULUS - 2, FINGERPRINT_MODULUS);
+    }
+    
+    *result = power_modulo(base, exponent->value.numeric.numerator, FINGERPRINT_MODULUS);
+    
+    return true;
+    
+}
+
+/**
+ 
+ @brief Evaluates a sparse or dense polynomial like the sum it
+ represents (see @c any_expression_to_expression())
+ 
+ */
+bool get_polynomial_fingerprint(uintmax_t* result, const expression* source) {
+    
+    uint16_t i;
+    uintmax_t coefficient, symbol, power;
+    const expression* term;
+    
+    *result = 0;
+    
+    if (source->identifier == EXPI_POLYNOMIAL_SPARSE) {
+        
+        for (i = 0; i < source->child_count; i++) {
+            term = source->children[i];
+            if (term == NULL || term->identifier != EXPI_LIST || term->child_count != 3) return false;
+            if (!get_fingerprint(&coefficient, term->children[1]) || !get_fingerprint(&symbol, term->children[2])) return false;
+            if (!get_power_fingerprint(&power, symbol, term->children[0])) return false;
+            *result = (*result + multiply_modulo(coefficient, power, FINGERPRINT_MODULUS)) % FINGERPRINT_MODULUS;
+        }
+        
+        return true;
+        
+    }
+    
+    if (source->child_count != 2 || source->children[1] == NULL || source->children[1]->identifier != EXPI_LIST) return false;
+    if (!get_fingerprint(&symbol, source->children[0])) return false;
+    
+    for (i = source->children[1]->child_count; i > 0; i--) {
+        if (!get_fingerprint(&coefficient, source->children[1]->children[i - 1])) return false;
+        *result = (multiply_modulo(*result, symbol, FINGERPRINT_MODULUS) + coefficient) % FINGERPRINT_MODULUS;
+    }
+    
+    return true;
+    
+}
+
+/**
+ 
+ @brief Evaluates an expression modulo @c FINGERPRINT_MODULUS
+ 
+ @details
+ Each symbol is replaced by a fixed pseudo-random point. Only rational
+ functions and polynomials (see @c FINGERPRINT_OPERATORS) are
+ evaluated; the imaginary
+ unit and fractional exponents are rejected, since they satisfy
+ algebraic relations which the evaluation doesn't know about.
+ 
+ Two expressions with different fingerprints are different rational
+ functions, so they can't be equivalent. Equal fingerprints prove
+ nothing, though.
+ 
+ @param[out] result The fingerprint.
+ @param[in] source The expression.
+ 
+ @return
+ - Whether the fingerprint could be computed (it can't if a
+ denominator vanishes at the point).
+ 
+ */
+bool get_fingerprint(uintmax_t* result, const expression* source) {
+    
+    uint16_t i;
+    uintmax_t child;
+    
+    if (source == NULL) return false;
+    
+    switch (source->identifier) {
+            
+        case EXPI_LITERAL:
+            if (!get_literal_fingerprint(result, source)) return false;
+            break;
+            
+        case EXPI_SYMBOL:
+        case EXPI_VARIABLE:
+            if (source->value.symbol == SYMBOL_I) return false;
+            *result = get_symbol_fingerprint(source->value.symbol);
+            break;
+            
+        case EXPI_ADDITION:
+        case EXPI_MULTIPLICATION:
+            
+            *result = (source->identifier == EXPI_ADDITION) ? 0 : 1;
+            
+            for (i = 0; i < source->child_count; i++) {
+                if (!get_fingerprint(&child, source->children[i])) return false;
+                if (source->identifier == EXPI_ADDITION) {
+                    *result = (*result + child) % FINGERPRINT_MODULUS;
+                } else {
+                    *result = multiply_modulo(*result, child, FINGERPRINT_MODULUS);
+                }
+            }
+            
+            break;
+            
+        case EXPI_SUBTRACTION:
+            if (source->child_count != 2 || !get_fingerprint(result, source->children[0]) || !get_fingerprint(&child, source->children[1])) return false;
+            *result = (*result + FINGERPRINT_MODULUS - child) % FINGERPRINT_MODULUS;
+            break;
+            
+        case EXPI_DIVISION:
+            if (source->child_count != 2 || !get_fingerprint(result, source->children[0]) || !get_fingerprint(&child, source->children[1]) || child == 0) return false;
+            *result = multiply_modulo(*result, power_modulo(child, FINGERPRINT_MODULUS - 2, FINGERPRINT_MODULUS), FINGERPRINT_MODULUS);
+            break;
+            
+        case EXPI_EXPONENTATION:
+            if (source->child_count != 2 || !get_fingerprint(&child, source->children[0])) return false;
+            if (!get_power_fingerprint(result, child, source->children[1])) return false;
+            break;
+            
+        case EXPI_POLYNOMIAL_SPARSE:
+        case EXPI_POLYNOMIAL_DENSE:
+            if (!get_polynomial_fingerprint(result, source)) return false;
+            break;
+            
+        default:
+            return false;
+            
+    }
+    
+    if (source->sign == -1) *result = (FINGERPRINT_MODULUS - *result) % FINGERPRINT_MODULUS;
+    
+    return true;
+    
+}
+
+/**
+ 
+ @brief Checks if two expressions are certainly not equivalent
+ 
+ @details
+ A cheap test (Schwartz–Zippel) which runs before the expressions are
+ compared symbolically. The summaries reject expressions which can't
+ be fingerprinted without traversing them.
+ 
+ @return
+ - @c true if the expressions are different rational functions,
+ @c false if the fingerprints are inconclusive.
+ 
+ */
+bool fingerprints_differ(const expression* a, const expression* b) {
+    
+    uintmax_t a_fingerprint, b_fingerprint;
+    expression_summary a_summary = get_expression_summary(a);
+    expression_summary b_summary = get_expression_summary(b);
+    
+    if (((a_summary.operators | b_summary.operators) & ~FINGERPRINT_OPERATORS) != 0) return false;
+    if (((a_summary.symbols | b_summary.symbols) & SUMMARY_SYMBOL_BIT(SYMBOL_I)) != 0) return false;
+    
+    if (!get_fingerprint(&a_fingerprint, a) || !get_fingerprint(&b_fingerprint, b)) return false;
+    
+    return a_fingerprint != b_fingerprint;
+    
+}
@@ -0,0 +1,40 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef fingerprint_h
+#define fingerprint_h
+
+#include "symbolic4.h"
+
+/// A Mersenne prime which fits into a @c uintmax_t with room for one addition
+#define FINGERPRINT_MODULUS ((sizeof(uintmax_t) >= 8) ? (uintmax_t) 0x1FFFFFFFFFFFFFFFull : (uintmax_t) 0x7FFFFFFF)
+
+/// The identifiers which can be fingerprinted (exponents have to be integer literals, lists may only occur in polynomials)
+#define FINGERPRINT_OPERATORS (SUMMARY_OPERATOR_BIT(EXPI_LITERAL) | SUMMARY_OPERATOR_BIT(EXPI_SYMBOL) | SUMMARY_OPERATOR_BIT(EXPI_VARIABLE) | SUMMARY_OPERATOR_BIT(EXPI_ADDITION) | SUMMARY_OPERATOR_BIT(EXPI_SUBTRACTION) | SUMMARY_OPERATOR_BIT(EXPI_MULTIPLICATION) | SUMMARY_OPERATOR_BIT(EXPI_DIVISION) | SUMMARY_OPERATOR_BIT(EXPI_EXPONENTATION) | SUMMARY_OPERATOR_BIT(EXPI_POLYNOMIAL_SPARSE) | SUMMARY_OPERATOR_BIT(EXPI_POLYNOMIAL_DENSE) | SUMMARY_OPERATOR_BIT(EXPI_LIST))
+
+bool get_fingerprint(uintmax_t* result, const expression* source);
+bool fingerprints_differ(const expression* a, const expression* b);
+
+#endif /* fingerprint_h */
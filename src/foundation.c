@@ -25,21 +25,166 @@
 
 #include "symbolic4.h"
 
-error current_error;
-void** allocated_pointers;
-bool smart_alloc_is_recording = true;
+#define SMART_ALLOC_ROUND(bytes) (((bytes) + sizeof(smart_alloc_alignment) - 1) / sizeof(smart_alloc_alignment) * sizeof(smart_alloc_alignment))
+#define SMART_ALLOC_CLASS(rounded_bytes) ((rounded_bytes) / sizeof(smart_alloc_alignment))
+#define SMART_ALLOC_SIZE(pointer) (*(size_t*) ((char*) (pointer) - SMART_ALLOC_HEADER_SIZE))
+#define SMART_ALLOC_HEADER_SIZE SMART_ALLOC_ROUND(sizeof(size_t))
+#define SMART_ALLOC_BLOCK_DATA(block) ((char*) (block) + SMART_ALLOC_ROUND(sizeof(smart_alloc_block)))
 
 /**
  
- @brief Allocates and keeps track of memory
+ @brief Reserves raw memory in the arena
  
  @details
- The pointer to the allocated memory is stored in the
- @c allocated_pointers array.
+ The memory is taken from the current block. If it doesn't fit, the
+ next retained block is reused or a new block is inserted after the
+ current one, so that all blocks after the current block are always
+ unused. Every allocation is preceded by a header holding its
+ (rounded) size, which is needed by @c smart_realloc() and
+ @c smart_free().
  
- @pre
- - The @c allocated_pointers array must be initialized with @c NULL,
- or else the loop won't work.
+ @param[in] bytes The number of bytes to reserve.
+ 
+ @return
+ - A pointer to the reserved (uninitialized) memory.
+ 
+ */
+void* smart_alloc_bump(size_t bytes) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    size_t rounded_bytes = (bytes == 0) ? sizeof(smart_alloc_alignment) : SMART_ALLOC_ROUND(bytes);
+    size_t block_size;
+    smart_alloc_block* block;
+    char* pointer;
+    
+    if (allocator->current_block == NULL || allocator->current_block->used + SMART_ALLOC_HEADER_SIZE + rounded_bytes > allocator->current_block->size) {
+        
+        if (allocator->current_block != NULL && allocator->current_block->next != NULL && SMART_ALLOC_HEADER_SIZE + rounded_bytes <= allocator->current_block->next->size) {
+            block = allocator->current_block->next;
+        } else {
+            
+            block_size = SMART_ALLOC_BLOCK_SIZE;
+            if (SMART_ALLOC_HEADER_SIZE + rounded_bytes > block_size) block_size = SMART_ALLOC_HEADER_SIZE + rounded_bytes;
+            
+            block = malloc(SMART_ALLOC_ROUND(sizeof(smart_alloc_block)) + block_size);
+            if (block == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+            allocator->statistics.system_allocations++;
+            
+            block->size = block_size;
+            
+            if (allocator->current_block == NULL) {
+                block->next = allocator->first_block;
+                allocator->first_block = block;
+            } else {
+                block->next = allocator->current_block->next;
+                allocator->current_block->next = block;
+            }
+            
+        }
+        
+        block->used = 0;
+        allocator->current_block = block;
+        
+    }
+    
+    pointer = SMART_ALLOC_BLOCK_DATA(allocator->current_block) + allocator->current_block->used;
+    *(size_t*) pointer = rounded_bytes;
+    allocator->current_block->used += SMART_ALLOC_HEADER_SIZE + rounded_bytes;
+    allocator->statistics.bump_allocations++;
+    
+    return pointer + SMART_ALLOC_HEADER_SIZE;
+    
+}
+
+/**
+ 
+ @brief Checks if a pointer is the most recent allocation in the arena
+ 
+ @param[in] pointer The pointer to check.
+ 
+ @return
+ - @c true if the allocation ends exactly at the top of the current
+ block, @c false otherwise.
+ 
+ */
+bool smart_alloc_is_top(const void* pointer) {
+    smart_alloc_state* allocator = &current_context->allocator;
+    return allocator->current_block != NULL && (const char*) pointer + SMART_ALLOC_SIZE(pointer) == SMART_ALLOC_BLOCK_DATA(allocator->current_block) + allocator->current_block->used;
+}
+
+/**
+ 
+ @brief Reserves raw memory from the pool
+ 
+ @details
+ Small requests are served from the free list of their size class
+ (one class per @c smart_alloc_alignment step) if possible. All other
+ requests are bump-allocated.
+ 
+ @param[in] bytes The number of bytes to reserve.
+ 
+ @return
+ - A pointer to the reserved (uninitialized) memory.
+ 
+ */
+void* smart_alloc_take(size_t bytes) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    size_t class = SMART_ALLOC_CLASS((bytes == 0) ? sizeof(smart_alloc_alignment) : SMART_ALLOC_ROUND(bytes));
+    void* pointer;
+    
+    allocator->statistics.allocations++;
+    
+    if (class < SMART_ALLOC_CLASS_COUNT && allocator->free_lists[class] != NULL) {
+        pointer = allocator->free_lists[class];
+        allocator->free_lists[class] = *(void**) pointer;
+        allocator->statistics.pool_hits++;
+        return pointer;
+    }
+    
+    return smart_alloc_bump(bytes);
+    
+}
+
+/**
+ 
+ @brief Hands memory back to the pool
+ 
+ @details
+ The top allocation of the arena is popped, other allocations are
+ pushed onto the free list of their size class. Allocations that are
+ too large for a size class are reclaimed by the next reset.
+ 
+ @param[in] pointer The pointer to release.
+ 
+ */
+void smart_alloc_give(void* pointer) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    size_t class = SMART_ALLOC_CLASS(SMART_ALLOC_SIZE(pointer));
+    
+    if (smart_alloc_is_top(pointer)) {
+        allocator->current_block->used -= SMART_ALLOC_HEADER_SIZE + SMART_ALLOC_SIZE(pointer);
+    } else if (class < SMART_ALLOC_CLASS_COUNT) {
+        *(void**) pointer = allocator->free_lists[class];
+        allocator->free_lists[class] = pointer;
+    }
+    
+}
+
+/**
+ 
+ @brief Allocates zeroed memory in the query arena
+ 
+ @details
+ The memory is bump-allocated from the arena and stays valid until
+ it is released by @c smart_free_all() or by a rollback to a
+ checkpoint that was taken before the allocation. There is no upper
+ limit on the number of live allocations.
+ 
+ If @c current_context->allocator.is_recording is set to @c false, the memory is
+ allocated with @c calloc() instead and has to be released with
+ @c smart_free() while recording is still disabled.
  
  @warning
  - If the memory allocation fails, @c set_handle_unrecoverable_error() is
@@ -54,17 +199,25 @@ bool smart_alloc_is_recording = true;
  @see
  - smart_free()
  - smart_free_all()
+ - smart_checkpoint()
  
  */
-void* smart_alloc(uint8_t length, size_t size) {
-    uint16_t i;
-    void* pointer = calloc(length, size);
-    if (pointer == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
-    if (smart_alloc_is_recording) {
-        for (i = 0; allocated_pointers[i] != NULL && i < ALLOCATED_POINTERS_LENGTH - 1; i++);
-        allocated_pointers[i] = pointer;
+void* smart_alloc(size_t length, size_t size) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    void* pointer;
+    
+    if (!allocator->is_recording) {
+        pointer = calloc(length, size);
+        if (pointer == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+        return pointer;
     }
+    
+    pointer = smart_alloc_take(length * size);
+    memset(pointer, 0, length * size);
+    
     return pointer;
+    
 }
 
 /**
@@ -72,8 +225,9 @@ void* smart_alloc(uint8_t length, size_t size) {
  @brief Resizes a pointer
  
  @details
- The resized pointer to the allocated memory is stored in the
- @c allocated_pointers array.
+ If the pointer is the most recent allocation and the current block
+ has enough space left, it is resized in place. Otherwise new memory
+ is allocated and the old content is copied.
  
  @param[in] source The pointer to be resized.
  @param[in] length The new length/count of the elements.
@@ -83,15 +237,37 @@ void* smart_alloc(uint8_t length, size_t size) {
  - smart_alloc()
  
  */
-void* smart_realloc(void* source, uint8_t length, size_t size) {
-    uint16_t i;
-    void* pointer = realloc(source, length * size);
-    if (pointer == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
-    if (pointer != source && smart_alloc_is_recording) {
-        for (i = 0; allocated_pointers[i] != NULL && i < ALLOCATED_POINTERS_LENGTH; i++);
-        allocated_pointers[i] = pointer;
+void* smart_realloc(void* source, size_t length, size_t size) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    size_t bytes = length * size;
+    size_t old_bytes;
+    void* pointer;
+    
+    if (!allocator->is_recording) {
+        pointer = realloc(source, bytes);
+        if (pointer == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+        return pointer;
     }
+    
+    if (source == NULL) return smart_alloc(length, size);
+    
+    old_bytes = SMART_ALLOC_SIZE(source);
+    
+    if (SMART_ALLOC_ROUND(bytes) <= old_bytes) return source;
+    
+    if (smart_alloc_is_top(source) && allocator->current_block->used + SMART_ALLOC_ROUND(bytes) - old_bytes <= allocator->current_block->size) {
+        allocator->current_block->used += SMART_ALLOC_ROUND(bytes) - old_bytes;
+        SMART_ALLOC_SIZE(source) = SMART_ALLOC_ROUND(bytes);
+        return source;
+    }
+    
+    pointer = smart_alloc_take(bytes);
+    memcpy(pointer, source, old_bytes);
+    smart_alloc_give(source);
+    
     return pointer;
+    
 }
 
 /**
@@ -99,8 +275,10 @@ void* smart_realloc(void* source, uint8_t length, size_t size) {
  @brief Frees a pointer
  
  @details
- This function frees a pointer and sets its corresponding entry in the
- @c allocated_pointers array to @c NULL.
+ Arena memory can't be released individually. If the pointer is the
+ most recent allocation, its memory is handed back to the arena
+ immediately; otherwise it is reclaimed by the next rollback or
+ @c smart_free_all().
  
  @param[in] pointer The pointer to be freed.
  
@@ -110,11 +288,17 @@ void* smart_realloc(void* source, uint8_t length, size_t size) {
  
  */
 void smart_free(void* pointer) {
-    uint16_t i;
+    
+    smart_alloc_state* allocator = &current_context->allocator;
     if (pointer == NULL) return;
-    for (i = 0; allocated_pointers[i] != pointer && i < ALLOCATED_POINTERS_LENGTH; i++);
-    free(pointer);
-    allocated_pointers[i] = NULL;
+    
+    if (!allocator->is_recording) {
+        free(pointer);
+        return;
+    }
+    
+    smart_alloc_give(pointer);
+    
 }
 
 /**
@@ -122,19 +306,117 @@ void smart_free(void* pointer) {
  @brief Frees all pointers
  
  @details
- This function frees all pointers allocated with @c smart_alloc() by
- iteratively calling @c smart_free().
+ This function resets the arena and empties the free lists,
+ invalidating all memory allocated with @c smart_alloc(). The blocks
+ are kept for subsequent queries, so that a steady-state query
+ doesn't need to call @c malloc() at all.
  
  @see
  - smart_alloc()
  - smart_free()
+ - smart_release_blocks()
  
  */
 void smart_free_all(void) {
-    uint16_t i;
-    for (i = 0; i < ALLOCATED_POINTERS_LENGTH; i++) {
-        if (allocated_pointers[i] != NULL) smart_free(allocated_pointers[i]);
+    
+    smart_alloc_checkpoint empty;
+    
+    memset(&empty, 0, sizeof(smart_alloc_checkpoint));
+    smart_rollback(empty);
+    
+}
+
+/**
+ 
+ @brief Returns all blocks of the arena to the system
+ 
+ @details
+ Like @c smart_free_all(), but the blocks are released with @c free().
+ 
+ @see
+ - smart_free_all()
+ 
+ */
+void smart_release_blocks(void) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    smart_alloc_block* block;
+    
+    smart_free_all();
+    
+    while (allocator->first_block != NULL) {
+        block = allocator->first_block;
+        allocator->first_block = block->next;
+        free(block);
     }
+    
+    allocator->current_block = NULL;
+    
+}
+
+/**
+ 
+ @brief Returns the current top of the arena
+ 
+ @details
+ The checkpoint can later be passed to @c smart_rollback() to release
+ everything allocated after it in O(1). The free lists are saved in
+ the checkpoint and emptied, so that memory handed out after the
+ checkpoint always lies above it.
+ 
+ @return
+ - The checkpoint.
+ 
+ @see
+ - smart_rollback()
+ 
+ */
+smart_alloc_checkpoint smart_checkpoint(void) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    smart_alloc_checkpoint checkpoint;
+    
+    checkpoint.block = allocator->current_block;
+    checkpoint.used = (allocator->current_block != NULL) ? allocator->current_block->used : 0;
+    memcpy(checkpoint.free_lists, allocator->free_lists, sizeof(allocator->free_lists));
+    memset(allocator->free_lists, 0, sizeof(allocator->free_lists));
+    
+    return checkpoint;
+    
+}
+
+/**
+ 
+ @brief Releases all memory allocated after a checkpoint
+ 
+ @details
+ The blocks following the checkpoint are kept and reused by
+ subsequent allocations. The free lists are restored to their state
+ at the time of the checkpoint.
+ 
+ @warning
+ - Expressions allocated after the checkpoint must not be referenced
+ afterwards.
+ 
+ @param[in] checkpoint A checkpoint returned by @c smart_checkpoint().
+ 
+ @see
+ - smart_checkpoint()
+ 
+ */
+void smart_rollback(smart_alloc_checkpoint checkpoint) {
+    
+    smart_alloc_state* allocator = &current_context->allocator;
+    if (checkpoint.block == NULL) {
+        allocator->current_block = allocator->first_block;
+        if (allocator->current_block != NULL) allocator->current_block->used = 0;
+    } else {
+        allocator->current_block = checkpoint.block;
+        allocator->current_block->used = checkpoint.used;
+    }
+    
+    memcpy(allocator->free_lists, checkpoint.free_lists, sizeof(allocator->free_lists));
+    
 }
 
 /**
@@ -150,9 +432,9 @@ void smart_free_all(void) {
  
  */
 uint8_t set_error(error_domain domain, error_identifier identifier, const char* body) {
-    current_error.domain = domain;
-    current_error.identifier = identifier;
-    strcpy(current_error.body, body);
+    current_context->error.domain = domain;
+    current_context->error.identifier = identifier;
+    strcpy(current_context->error.body, body);
     return RETS_ERROR;
 }
 
@@ -168,7 +450,8 @@ uint8_t set_error(error_domain domain, error_identifier identifier, const char*
  @code
  while (true);
  @endcode
- loop may be replaced with system-specific error handling.
+ loop may be replaced with system-specific error handling. The error
+ is only recorded if there is a current context.
  
  @warning
  - This function should only be called if everything else has failed.
@@ -179,16 +462,14 @@ uint8_t set_error(error_domain domain, error_identifier identifier, const char*
  
  */
 void set_handle_unrecoverable_error(error_domain domain, error_identifier identifier, const char* body) {
-    current_error.domain = domain;
-    current_error.identifier = identifier;
-    strcpy(current_error.body, body);
+    if (current_context != NULL) {
+        current_context->error.domain = domain;
+        current_context->error.identifier = identifier;
+        strcpy(current_context->error.body, body);
+    }
     while (true);
 }
 
-double uintmax_max_value(void) {
-    return pow(2, sizeof(uintmax_t) * 8) - 1000;
-}
-
 /**
  
  @brief Converts a string to lowercase
@@ -204,7 +485,7 @@ double uintmax_max_value(void) {
  
  */
 char* string_to_lower(const char* string) {
-    uint8_t i;
+    size_t i;
     char* result = smart_alloc(strlen(string) + 1, sizeof(char));
     strcpy(result, string);
     for (i = 0; result[i] != '\0'; i++) {
@@ -218,7 +499,7 @@ void itoa(char* buffer, uintmax_t source) {
     uintmax_t i = 1;
     uint8_t buffer_position = 0;
     
-    while (source >= 10 * i) {
+    while (source / i >= 10) {
         i *= 10;
     }
     
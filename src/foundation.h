@@ -58,7 +58,9 @@ typedef enum {
     ERRI_ARGUMENTS,
     ERRI_VECTOR_DIMENSIONS,
     ERRI_UNDEFINED_VALUE,
-    ERRI_NON_DIFFERENTIABLE
+    ERRI_NON_DIFFERENTIABLE,
+    ERRI_MAX_CHILD_COUNT_EXCEEDED,
+    ERRI_BUFFER_OVERFLOW
 } error_identifier;
 
 typedef enum {
@@ -75,17 +77,48 @@ typedef struct {
     char body[20];
 } error;
 
-extern error current_error;
-extern void** allocated_pointers;
-extern bool smart_alloc_is_recording;
+typedef union {
+    void* pointer;
+    double floating;
+    uintmax_t integer;
+} smart_alloc_alignment;
 
-void* smart_alloc(uint8_t length, size_t size);
-void* smart_realloc(void* source, uint8_t length, size_t size);
+typedef struct smart_alloc_block {
+    struct smart_alloc_block* next;
+    size_t size;
+    size_t used;
+} smart_alloc_block;
+
+typedef struct {
+    smart_alloc_block* block;
+    size_t used;
+    void* free_lists[SMART_ALLOC_CLASS_COUNT];
+} smart_alloc_checkpoint;
+
+typedef struct {
+    uintmax_t allocations; ///< Number of allocations requested from the pool.
+    uintmax_t pool_hits; ///< Number of allocations served from a free list.
+    uintmax_t bump_allocations; ///< Number of allocations served from the arena.
+    uintmax_t system_allocations; ///< Number of blocks requested with @c malloc().
+} smart_alloc_statistics;
+
+typedef struct {
+    bool is_recording;
+    smart_alloc_block* first_block;
+    smart_alloc_block* current_block;
+    void* free_lists[SMART_ALLOC_CLASS_COUNT];
+    smart_alloc_statistics statistics;
+} smart_alloc_state;
+
+void* smart_alloc(size_t length, size_t size);
+void* smart_realloc(void* source, size_t length, size_t size);
 void smart_free(void* pointer);
 void smart_free_all(void);
+void smart_release_blocks(void);
+smart_alloc_checkpoint smart_checkpoint(void);
+void smart_rollback(smart_alloc_checkpoint checkpoint);
 uint8_t set_error(error_domain domain, error_identifier identifier, const char* body);
 void set_handle_unrecoverable_error(error_domain domain, error_identifier identifier, const char* body);
-double uintmax_max_value(void);
 char* string_to_lower(const char* string);
 void itoa(char* buffer, uintmax_t source);
 void dtoa(char* buffer, uint8_t length, double source);
@@ -0,0 +1,368 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+uint32_t hashcons_node_hash(const expression* source, expression** children, uint16_t child_count);
+bool hashcons_nodes_are_equal(const expression* a, const expression* source, expression** children, uint16_t child_count);
+interned_expression* hashcons_lookup(const expression* source, expression** children, uint16_t child_count, uint32_t hash);
+void hashcons_grow(expression_table* table);
+bignum* hashcons_copy_bignum(const bignum* source);
+void hashcons_free_entry(interned_expression* entry);
+
+expression_table* new_expression_table(void) {
+    
+    expression_table* table = calloc(1, sizeof(expression_table));
+    
+    if (table == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    table->bucket_count = HASHCONS_INITIAL_BUCKET_COUNT;
+    table->buckets = calloc(table->bucket_count, sizeof(interned_expression*));
+    
+    if (table->buckets == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    return table;
+    
+}
+
+/**
+ 
+ @brief Frees a table and all of its nodes, regardless of their
+ reference counts
+ 
+ @param[in] table The table to be freed.
+ 
+ */
+void free_expression_table(expression_table* table) {
+    
+    size_t i;
+    interned_expression* entry;
+    
+    if (table == NULL) return;
+    
+    for (i = 0; i < table->bucket_count; i++) {
+        while (table->buckets[i] != NULL) {
+            entry = table->buckets[i];
+            table->buckets[i] = entry->next;
+            hashcons_free_entry(entry);
+        }
+    }
+    
+    free(table->buckets);
+    free(table);
+    
+}
+
+/**
+ 
+ @brief Copies a bignum of an interned literal out of the arena
+ 
+ */
+bignum* hashcons_copy_bignum(const bignum* source) {
+    
+    bignum* result;
+    
+    if (source == NULL) return NULL;
+    
+    result = malloc(sizeof(bignum) + source->length * sizeof(bignum_limb));
+    if (result == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    memcpy(result, source, sizeof(bignum) + source->length * sizeof(bignum_limb));
+    
+    return result;
+    
+}
+
+void hashcons_free_entry(interned_expression* entry) {
+    if (entry->node.identifier == EXPI_LITERAL) {
+        free(entry->node.value.numeric.big_numerator);
+        free(entry->node.value.numeric.big_denominator);
+    }
+    if (entry->node.children != entry->node.inline_children) free(entry->node.children);
+    free(entry);
+}
+
+uint32_t interned_expression_hash(const expression* source) {
+    return ((const interned_expression*) source)->hash;
+}
+
+/**
+ 
+ @brief Computes the hash of a node whose children are already
+ interned
+ 
+ @details
+ Since the hashes of the children are cached, this takes O(1) per
+ child.
+ 
+ */
+uint32_t hashcons_node_hash(const expression* source, expression** children, uint16_t child_count) {
+    
+    uint16_t i;
+    uint32_t hash = 2166136261u;
+    
+    hash = (hash ^ source->type) * 16777619u;
+    hash = (hash ^ source->identifier) * 16777619u;
+    hash = (hash ^ (uint8_t) source->sign) * 16777619u;
+    
+    if (source->identifier == EXPI_LITERAL) {
+        hash = hash_numeric_value(hash, &source->value.numeric);
+    } else if (source->identifier == EXPI_SYMBOL || source->identifier == EXPI_VARIABLE) {
+        hash = (hash ^ source->value.symbol) * 16777619u;
+    }
+    
+    for (i = 0; i < child_count; i++) {
+        hash = (hash ^ interned_expression_hash(children[i])) * 16777619u;
+        hash ^= hash >> 15;
+    }
+    
+    return hash;
+    
+}
+
+/**
+ 
+ @brief Compares an interned node with a node whose children are
+ already interned
+ 
+ @details
+ Children are compared by pointer, since structurally equal interned
+ children are the same node.
+ 
+ */
+bool hashcons_nodes_are_equal(const expression* a, const expression* source, expression** children, uint16_t child_count) {
+    
+    uint16_t i;
+    
+    if (a->type != source->type || a->identifier != source->identifier || a->sign != source->sign || a->child_count != child_count) return false;
+    
+    if (a->identifier == EXPI_LITERAL && !numeric_values_are_equal(&a->value.numeric, &source->value.numeric)) return false;
+    
+    if ((a->identifier == EXPI_SYMBOL || a->identifier == EXPI_VARIABLE) && a->value.symbol != source->value.symbol) return false;
+    
+    for (i = 0; i < child_count; i++) {
+        if (a->children[i] != children[i]) return false;
+    }
+    
+    return true;
+    
+}
+
+interned_expression* hashcons_lookup(const expression* source, expression** children, uint16_t child_count, uint32_t hash) {
+    
+    expression_table* table = current_context->expression_table;
+    interned_expression* entry;
+    
+    for (entry = table->buckets[hash % table->bucket_count]; entry != NULL; entry = entry->next) {
+        if (entry->hash == hash && hashcons_nodes_are_equal(&entry->node, source, children, child_count)) return entry;
+    }
+    
+    return NULL;
+    
+}
+
+void hashcons_grow(expression_table* table) {
+    
+    size_t i;
+    size_t bucket_count = 2 * table->bucket_count;
+    interned_expression** buckets = calloc(bucket_count, sizeof(interned_expression*));
+    interned_expression* entry;
+    
+    if (buckets == NULL) return;
+    
+    for (i = 0; i < table->bucket_count; i++) {
+        while (table->buckets[i] != NULL) {
+            entry = table->buckets[i];
+            table->buckets[i] = entry->next;
+            entry->next = buckets[entry->hash % bucket_count];
+            buckets[entry->hash % bucket_count] = entry;
+        }
+    }
+    
+    free(table->buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+    
+}
+
+/**
+ 
+ @brief Returns the interned node of an expression, creating it (and
+ its children) if necessary
+ 
+ @details
+ Structurally equal subtrees are represented by one shared node, so
+ the result is a DAG. Every call returns a new reference, which has to
+ be released with @c release_interned_expression() or
+ @c free_expression(). Null children are skipped. Subtrees which are
+ already interned are shared in O(1), so only the new nodes of
+ @c source are visited. The interned nodes are allocated outside the
+ arena and must not be modified; @c copy_expression() returns a
+ mutable copy.
+ 
+ @param[in] source The expression to intern.
+ 
+ @return
+ - The interned expression.
+ 
+ */
+expression* intern_expression(const expression* source) {
+    
+    uint16_t i;
+    uint16_t child_count = 0;
+    uint32_t hash;
+    expression** children;
+    expression_table* table = current_context->expression_table;
+    interned_expression* entry;
+    
+    if (source->interned) {
+        retain_interned_expression((expression*) source);
+        return (expression*) source;
+    }
+    
+    children = smart_alloc(source->child_count, sizeof(expression*));
+    
+    for (i = 0; i < source->child_count; i++) {
+        if (source->children[i] == NULL) continue;
+        children[child_count++] = intern_expression(source->children[i]);
+    }
+    
+    hash = hashcons_node_hash(source, children, child_count);
+    
+    if ((entry = hashcons_lookup(source, children, child_count, hash)) != NULL) {
+        for (i = 0; i < child_count; i++) {
+            release_interned_expression(children[i]);
+        }
+        smart_free(children);
+        entry->reference_count++;
+        return &entry->node;
+    }
+    
+    entry = calloc(1, sizeof(interned_expression));
+    if (entry == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    entry->node.type = source->type;
+    entry->node.interned = true;
+    entry->node.identifier = source->identifier;
+    entry->node.sign = source->sign;
+    entry->node.value = source->value;
+    
+    if (source->identifier == EXPI_LITERAL) {
+        entry->node.value.numeric.big_numerator = hashcons_copy_bignum(source->value.numeric.big_numerator);
+        entry->node.value.numeric.big_denominator = hashcons_copy_bignum(source->value.numeric.big_denominator);
+    }
+    entry->node.child_count = child_count;
+    entry->node.child_capacity = (child_count > EXPRESSION_INLINE_CHILDREN) ? child_count : EXPRESSION_INLINE_CHILDREN;
+    entry->node.children = (child_count > EXPRESSION_INLINE_CHILDREN) ? malloc(child_count * sizeof(expression*)) : entry->node.inline_children;
+    
+    if (entry->node.children == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    memcpy(entry->node.children, children, child_count * sizeof(expression*));
+    smart_free(children);
+    entry->hash = hash;
+    entry->reference_count = 1;
+    
+    if (table->count >= table->bucket_count) hashcons_grow(table);
+    
+    entry->next = table->buckets[hash % table->bucket_count];
+    table->buckets[hash % table->bucket_count] = entry;
+    table->count++;
+    
+    return &entry->node;
+    
+}
+
+/**
+ 
+ @brief Returns the interned node of an expression without creating
+ it
+ 
+ @param[in] source The expression to look up.
+ 
+ @return
+ - The interned expression (without a new reference), or @c NULL if
+ the expression hasn't been interned.
+ 
+ */
+expression* find_interned_expression(const expression* source) {
+    
+    uint16_t i;
+    uint16_t child_count = 0;
+    expression** children;
+    interned_expression* entry;
+    
+    if (source->interned) return (expression*) source;
+    
+    children = smart_alloc(source->child_count, sizeof(expression*));
+    
+    for (i = 0; i < source->child_count; i++) {
+        if (source->children[i] == NULL) continue;
+        if ((children[child_count++] = find_interned_expression(source->children[i])) == NULL) {
+            smart_free(children);
+            return NULL;
+        }
+    }
+    
+    entry = hashcons_lookup(source, children, child_count, hashcons_node_hash(source, children, child_count));
+    smart_free(children);
+    
+    return (entry != NULL) ? &entry->node : NULL;
+    
+}
+
+void retain_interned_expression(expression* source) {
+    ((interned_expression*) source)->reference_count++;
+}
+
+/**
+ 
+ @brief Releases a reference to an interned expression
+ 
+ @details
+ When the last reference is released, the node is removed from the
+ table and its references to its children are released.
+ 
+ @param[in] source The interned expression.
+ 
+ */
+void release_interned_expression(expression* source) {
+    
+    uint16_t i;
+    interned_expression* entry = (interned_expression*) source;
+    interned_expression** link;
+    expression_table* table = current_context->expression_table;
+    
+    if (source == NULL || --entry->reference_count > 0) return;
+    
+    for (link = &table->buckets[entry->hash % table->bucket_count]; *link != entry; link = &(*link)->next);
+    *link = entry->next;
+    table->count--;
+    
+    for (i = 0; i < source->child_count; i++) {
+        release_interned_expression(source->children[i]);
+    }
+    
+    hashcons_free_entry(entry);
+    
+}
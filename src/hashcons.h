@@ -0,0 +1,75 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef hashcons_h
+#define hashcons_h
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief An immutable expression node shared by all structurally equal
+ expressions of a table
+ 
+ @details
+ @c node comes first, so that a pointer to an interned expression can
+ be used as an ordinary (read-only) expression.
+ 
+ */
+typedef struct interned_expression {
+    expression node;
+    uint32_t hash; ///< Computed from the node and the cached hashes of the children.
+    uint32_t reference_count;
+    struct interned_expression* next;
+} interned_expression;
+
+/**
+ 
+ @brief A table of hash-consed expressions
+ 
+ @details
+ Interning is opt-in. The simplifier and the other algorithms work on
+ mutable trees in the arena, while expressions which are kept (such
+ as the entries of the simplify memo or large results of
+ @c derivative() held by a caller) can be interned. Structurally equal
+ subtrees are then stored once, and @c expressions_are_identical()
+ compares two interned expressions by address.
+ 
+ */
+typedef struct expression_table {
+    interned_expression** buckets;
+    size_t bucket_count;
+    size_t count;
+} expression_table;
+
+expression_table* new_expression_table(void);
+void free_expression_table(expression_table* table);
+expression* intern_expression(const expression* source);
+expression* find_interned_expression(const expression* source);
+void retain_interned_expression(expression* source);
+void release_interned_expression(expression* source);
+uint32_t interned_expression_hash(const expression* source);
+
+#endif /* hashcons_h */
@@ -0,0 +1,279 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief Computes the integer part of an nth root
+ 
+ @details
+ This function uses Newton's method on integers. It starts with a
+ power of two above the root, from where the iterates decrease
+ monotonically until they reach the floor of the root.
+ 
+ @param[in] source The radicand.
+ @param[in] degree The degree of the root, which must not be zero.
+ 
+ @return
+ - The largest integer whose power doesn't exceed the radicand.
+ 
+ */
+uintmax_t int_nth_root(uintmax_t source, uintmax_t degree) {
+    
+    uint8_t bit_length = 0;
+    uintmax_t x, y, power;
+    
+    if (degree == 1 || source < 2) return source;
+    if (degree >= sizeof(uintmax_t) * 8) return 1;
+    
+    for (x = source; x != 0; x >>= 1) bit_length++;
+    
+    x = (uintmax_t) 1 << ((bit_length + degree - 1) / degree);
+    
+    while (true) {
+        
+        if (int_power(&power, x, degree - 1) == RETS_ERROR) power = 0;
+        
+        y = ((degree - 1) * x + ((power == 0) ? 0 : source / power)) / degree;
+        
+        if (y >= x) return x;
+        
+        x = y;
+        
+    }
+    
+}
+
+/**
+ 
+ @brief Checks if an integer is a perfect power
+ 
+ @param[out] root The root, if the integer is a perfect power.
+ @param[in] source The integer.
+ @param[in] degree The degree of the power.
+ 
+ @return
+ - @c true if the integer is the power of an integer.
+ 
+ */
+bool int_is_perfect_power(uintmax_t* root, uintmax_t source, uintmax_t degree) {
+    
+    uintmax_t power;
+    
+    *root = int_nth_root(source, degree);
+    
+    return int_power(&power, *root, degree) == RETS_SUCCESS && power == source;
+    
+}
+
+/**
+ 
+ @brief Extracts the largest power of a given degree from an integer
+ 
+ @details
+ After dividing by all primes below @c FACTORIZATION_SIEVE_LIMIT, all
+ prime factors of the cofactor are at least that limit. So, unless the
+ cofactor is a perfect power itself, it can only contain a power of the
+ given degree if it is at least the limit raised to the degree plus
+ one. Only in this rare case the cofactor is factorized completely.
+ 
+ @param[in,out] factor The factor, which is multiplied by the extracted
+ root.
+ @param[in,out] remainder The remainder, which is divided by the
+ extracted power.
+ @param[in] base The radicand.
+ @param[in] degree The degree of the root.
+ 
+ */
+void int_root(uintmax_t* factor, uintmax_t* remainder, uintmax_t base, uintmax_t degree) {
+    
+    uint8_t i;
+    uint8_t exponent;
+    size_t j;
+    size_t prime_count;
+    uintmax_t prime;
+    uintmax_t root;
+    uintmax_t bound;
+    uintmax_t temp_result;
+    const uint16_t* small_primes;
+    factorization factors;
+    
+    if (degree < 2 || base < 2) return;
+    
+    if (int_is_perfect_power(&root, base, degree)) {
+        *factor *= root;
+        *remainder /= base;
+        return;
+    }
+    
+    small_primes = get_small_primes(&prime_count);
+    
+    for (j = 0; j < prime_count; j++) {
+        
+        prime = small_primes[j];
+        
+        if (prime * prime > base) break;
+        if (base % prime != 0) continue;
+        
+        for (exponent = 0; base % prime == 0; exponent++) {
+            base /= prime;
+        }
+        
+        if (exponent >= degree && int_power(&temp_result, prime, exponent / degree) == RETS_SUCCESS) {
+            *factor *= temp_result;
+            int_power(&temp_result, temp_result, degree);
+            *remainder /= temp_result;
+        }
+        
+    }
+    
+    if (base == 1 || j < prime_count) return;
+    
+    if (int_is_perfect_power(&root, base, degree)) {
+        *factor *= root;
+        *remainder /= base;
+        return;
+    }
+    
+    if (int_power(&bound, FACTORIZATION_SIEVE_LIMIT, degree + 1) == RETS_ERROR || base < bound) return;
+    
+    factor_integer(&factors, base);
+    
+    for (i = 0; i < factors.count; i++) {
+        for (exponent = factors.exponents[i]; exponent >= degree; exponent -= degree) {
+            *factor *= factors.primes[i];
+            int_power(&temp_result, factors.primes[i], degree);
+            *remainder /= temp_result;
+        }
+    }
+    
+}
+
+/**
+ 
+ @brief Computes the integer part of an nth root of a bignum
+ 
+ @details
+ This is the bignum version of @c int_nth_root().
+ 
+ @param[in] source The radicand.
+ @param[in] degree The degree of the root, which must not be zero.
+ 
+ @return
+ - The largest bignum whose power doesn't exceed the radicand.
+ 
+ */
+bignum* big_nth_root(const bignum* source, uintmax_t degree) {
+    
+    uint32_t bit_length = bignum_bit_length(source);
+    bignum* two = new_bignum(2);
+    bignum* factor = new_bignum(degree - 1);
+    bignum* divisor = new_bignum(degree);
+    bignum* x;
+    bignum* y;
+    bignum* power;
+    bignum* quotient;
+    bignum* temp;
+    
+    if (degree == 1 || bit_length < 2) {
+        x = copy_bignum(source);
+    } else if (degree >= bit_length) {
+        x = new_bignum(1);
+    } else {
+        
+        x = bignum_power(two, (bit_length + degree - 1) / degree);
+        
+        while (true) {
+            
+            power = bignum_power(x, degree - 1);
+            
+            if (power == NULL) {
+                quotient = new_bignum(0);
+            } else {
+                bignum_divide(&quotient, NULL, source, power);
+                free_bignum(power);
+            }
+            
+            temp = bignum_multiply(x, factor);
+            power = bignum_add(temp, quotient);
+            bignum_divide(&y, NULL, power, divisor);
+            
+            free_bignum(temp);
+            free_bignum(power);
+            free_bignum(quotient);
+            
+            if (bignum_compare(y, x) >= 0) {
+                free_bignum(y);
+                break;
+            }
+            
+            free_bignum(x);
+            x = y;
+            
+        }
+        
+    }
+    
+    free_bignum(two);
+    free_bignum(factor);
+    free_bignum(divisor);
+    
+    return x;
+    
+}
+
+/**
+ 
+ @brief Checks if a bignum is a perfect power
+ 
+ @param[out] root The root, if the bignum is a perfect power. It has to
+ be freed by the caller.
+ @param[in] source The bignum.
+ @param[in] degree The degree of the power.
+ 
+ @return
+ - @c true if the bignum is the power of an integer.
+ 
+ */
+bool big_is_perfect_power(bignum** root, const bignum* source, uintmax_t degree) {
+    
+    bool result;
+    bignum* power;
+    
+    *root = big_nth_root(source, degree);
+    power = bignum_power(*root, degree);
+    result = power != NULL && bignum_compare(power, source) == 0;
+    
+    free_bignum(power);
+    
+    if (!result) {
+        free_bignum(*root);
+        *root = NULL;
+    }
+    
+    return result;
+    
+}
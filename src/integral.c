@@ -27,13 +27,15 @@
 
 bool expression_is_risch_integrable(expression* source, expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
+    
+    if ((get_expression_summary(source).operators & (SUMMARY_OPERATOR_BIT(EXPI_EXPONENTATION) | SUMMARY_OPERATOR_BIT(EXPI_LOG))) == 0) return true;
     
     for (i = 0; i < source->child_count; i++) {
         if (!expression_is_risch_integrable(source->children[i], variable)) return false;
     }
     
-    if (source->identifier == EXPI_EXPONENTATION && source->children[0]->value.symbolic[0] != 'e' && count_occurrences(source->children[1], variable, true) != 0) {
+    if (source->identifier == EXPI_EXPONENTATION && !(source->children[0]->identifier == EXPI_SYMBOL && source->children[0]->value.symbol == SYMBOL_E) && count_occurrences(source->children[1], variable, true) != 0) {
         return false;
     } else if (source->identifier == EXPI_EXPONENTATION && count_occurrences(source->children[0], variable, true) != 0 && source->children[1]->identifier != EXPI_LITERAL) {
         return false;
@@ -49,7 +51,8 @@ bool expression_is_risch_integrable(expression* source, expression* variable) {
 
 void risch_get_extensions(expression* extensions, expression* source, expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
+    char name[16];
     expression* extension;
     
     if (count_occurrences(source, variable, true) == 0) {
@@ -61,20 +64,20 @@ void risch_get_extensions(expression* extensions, expression* source, expression
         risch_get_extensions(extensions, source->children[i], variable);
     }
     
-    if (source->identifier == EXPI_EXPONENTATION && source->children[0]->value.symbolic[0] == 'e') {
+    if (source->identifier == EXPI_EXPONENTATION && source->children[0]->identifier == EXPI_SYMBOL && source->children[0]->value.symbol == SYMBOL_E) {
+        sprintf(name, "EE%u_", extensions->child_count);
         extension = new_expression(EXPT_STRUCTURE, EXPI_EXTENSION, 2,
-                                   new_symbol(EXPI_SYMBOL, "EE____"),
+                                   new_symbol(EXPI_SYMBOL, name),
                                    copy_expression(source->children[1]));
     } else if (source->identifier == EXPI_LN) {
+        sprintf(name, "LE%u_", extensions->child_count);
         extension = new_expression(EXPT_STRUCTURE, EXPI_EXTENSION, 2,
-                                   new_symbol(EXPI_SYMBOL, "LE____"),
+                                   new_symbol(EXPI_SYMBOL, name),
                                    copy_expression(source->children[1]));
     } else {
         return;
     }
     
-    itoa(extension->children[0]->value.symbolic + 2, extensions->child_count);
-    extension->children[0]->value.symbolic[strlen(extension->children[0]->value.symbolic)] = '_';
     append_child(extensions, extension);
     
     replace_expression(source, copy_expression(extension->children[0]));
@@ -83,7 +86,7 @@ void risch_get_extensions(expression* extensions, expression* source, expression
 
 uint8_t risch_determine_parts(expression** polynominal_part, expression** rational_part, const expression* source, const expression* variable, const expression* extensions) {
     
-    uint8_t i;
+    uint16_t i;
     expression* quotient;
     expression* remainder;
     expression* temp;
@@ -131,7 +134,7 @@ uint8_t risch_determine_parts(expression** polynominal_part, expression** ration
         
         *polynominal_part = quotient;
         
-        if (expressions_are_identical(remainder, new_literal(1, 0, 1), false)) {
+        if (is_zero(remainder)) {
             *rational_part = NULL;
         } else {
             *rational_part = new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
@@ -154,7 +157,7 @@ uint8_t risch_determine_parts(expression** polynominal_part, expression** ration
 
 void risch_integrate_polynominal_part(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* exponent;
     expression* result;
     
@@ -188,7 +191,7 @@ void risch_integrate_polynominal_part(expression* source) {
 
 void rothstein_trager_method(expression* source) {
     
-    uint8_t i, j;
+    uint16_t i, j;
     expression* a = copy_expression(source->children[0]);
     uint8_t a_degree;
     expression* b = copy_expression(source->children[1]);
@@ -268,7 +271,7 @@ void rothstein_trager_method(expression* source) {
         
         factor = primitive_part_factors->children[0];
         
-        if (literal_to_double(factor->children[0]) == 1) {
+        if (literal_equals(factor->children[0], 1)) {
             continue;
         }
         
@@ -372,7 +375,7 @@ uint8_t risch_integrate(expression* source, expression* variable) {
 
 uint8_t antiderivative(expression** result, expression* source, expression* variable, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp_source = copy_expression(source);
     
     if (variable == NULL) {
@@ -0,0 +1,460 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+void widen_interval(interval* source, uint8_t ulps);
+bool interval_is_valid(const interval* source);
+void get_point_interval(interval* result, double value, uint8_t ulps);
+void get_numeric_part_interval(interval* result, uintmax_t value, const bignum* big_value);
+bool get_literal_interval(interval* result, const expression* source);
+void add_intervals(interval* result, const interval* a, const interval* b);
+void multiply_intervals(interval* result, const interval* a, const interval* b);
+bool divide_intervals(interval* result, const interval* a, const interval* b);
+bool get_power_interval(interval* result, const interval* base, const expression* exponent);
+bool interval_contains_point(const interval* source, double offset, double period);
+bool get_function_interval(interval* result, expression_identifier identifier, const interval* argument);
+
+/**
+ 
+ @brief Moves the bounds of an interval outwards by a number of units
+ in the last place
+ 
+ @details
+ One ulp covers a correctly rounded operation; the elementary
+ functions of the C library are widened by two.
+ 
+ */
+void widen_interval(interval* source, uint8_t ulps) {
+    
+    uint8_t i;
+    
+    for (i = 0; i < ulps; i++) {
+        source->lower = nextafter(source->lower, -INFINITY);
+        source->upper = nextafter(source->upper, INFINITY);
+    }
+    
+}
+
+bool interval_is_valid(const interval* source) {
+    return !isnan(source->lower) && !isnan(source->upper) && source->lower <= source->upper;
+}
+
+void get_point_interval(interval* result, double value, uint8_t ulps) {
+    result->lower = value;
+    result->upper = value;
+    widen_interval(result, ulps);
+}
+
+/**
+ 
+ @brief Encloses a numerator or denominator
+ 
+ @details
+ Bignums are converted from their three most significant limbs (see
+ @c bignum_to_double()), which is accurate to a few ulps.
+ 
+ */
+void get_numeric_part_interval(interval* result, uintmax_t value, const bignum* big_value) {
+    
+    int32_t exponent;
+    double mantissa;
+    
+    if (big_value == NULL) {
+        get_point_interval(result, (double) value, 1);
+    } else {
+        mantissa = bignum_to_double(big_value, &exponent);
+        get_point_interval(result, ldexp(mantissa, exponent), 4);
+    }
+    
+}
+
+bool get_literal_interval(interval* result, const expression* source) {
+    
+    interval numerator, denominator;
+    const numeric_value* value = &source->value.numeric;
+    
+    if (value->denominator == 0 && value->big_denominator == NULL) return false;
+    
+    get_numeric_part_interval(&numerator, value->numerator, value->big_numerator);
+    get_numeric_part_interval(&denominator, value->denominator, value->big_denominator);
+    
+    return divide_intervals(result, &numerator, &denominator);
+    
+}
+
+void add_intervals(interval* result, const interval* a, const interval* b) {
+    result->lower = a->lower + b->lower;
+    result->upper = a->upper + b->upper;
+    widen_interval(result, 1);
+}
+
+void multiply_intervals(interval* result, const interval* a, const interval* b) {
+    
+    double products[4];
+    uint8_t i;
+    
+    products[0] = a->lower * b->lower;
+    products[1] = a->lower * b->upper;
+    products[2] = a->upper * b->lower;
+    products[3] = a->upper * b->upper;
+    
+    result->lower = products[0];
+    result->upper = products[0];
+    
+    for (i = 1; i < 4; i++) {
+        result->lower = fmin(result->lower, products[i]);
+        result->upper = fmax(result->upper, products[i]);
+    }
+    
+    if (isnan(products[0]) || isnan(products[1]) || isnan(products[2]) || isnan(products[3])) result->lower = NAN;
+    
+    widen_interval(result, 1);
+    
+}
+
+bool divide_intervals(interval* result, const interval* a, const interval* b) {
+    
+    interval reciprocal;
+    
+    if (b->lower <= 0 && b->upper >= 0) return false;
+    
+    reciprocal.lower = 1 / b->upper;
+    reciprocal.upper = 1 / b->lower;
+    widen_interval(&reciprocal, 1);
+    
+    multiply_intervals(result, a, &reciprocal);
+    
+    return interval_is_valid(result);
+    
+}
+
+/**
+ 
+ @brief Encloses a power
+ 
+ @details
+ Integer exponents are evaluated by repeated squaring, so the base may
+ be negative. Any other exponent requires a positive base and is
+ evaluated as <tt>exp(exponent * ln(base))</tt>.
+ 
+ */
+bool get_power_interval(interval* result, const interval* base, const expression* exponent) {
+    
+    uintmax_t n;
+    interval factor, logarithm, exponent_interval;
+    
+    if (exponent->identifier == EXPI_LITERAL && !literal_is_big(exponent) &&
+        exponent->value.numeric.denominator == 1 && exponent->value.numeric.numerator <= INTERVAL_MAX_INTEGER_EXPONENT) {
+        
+        get_point_interval(result, 1, 0);
+        factor = *base;
+        
+        for (n = exponent->value.numeric.numerator; n > 0; n >>= 1) {
+            if (n & 1) multiply_intervals(result, result, &factor);
+            if (n > 1) multiply_intervals(&factor, &factor, &factor);
+        }
+        
+        if (exponent->sign == -1) {
+            factor = *result;
+            get_point_interval(result, 1, 0);
+            return divide_intervals(result, result, &factor);
+        }
+        
+        return interval_is_valid(result);
+        
+    }
+    
+    if (base->lower <= 0 || !get_interval(&exponent_interval, exponent)) return false;
+    if (!get_function_interval(&logarithm, EXPI_LN, base)) return false;
+    
+    multiply_intervals(&logarithm, &logarithm, &exponent_interval);
+    
+    result->lower = exp(logarithm.lower);
+    result->upper = exp(logarithm.upper);
+    widen_interval(result, 2);
+    
+    return interval_is_valid(result);
+    
+}
+
+/**
+ 
+ @brief Checks if an interval may contain a point of
+ <tt>offset + k * period</tt>
+ 
+ @details
+ The test errs on the side of reporting a point, which only makes
+ the enclosures of periodic functions wider.
+ 
+ */
+bool interval_contains_point(const interval* source, double offset, double period) {
+    double k = ceil((source->lower - offset) / period - 1e-9);
+    return offset + k * period <= source->upper + 1e-9;
+}
+
+/**
+ 
+ @brief Encloses the value of a function of one argument
+ 
+ @return
+ - @c false if the argument isn't (entirely) in the domain of the
+ function.
+ 
+ */
+bool get_function_interval(interval* result, expression_identifier identifier, const interval* argument) {
+    
+    interval cosine;
+    double shift = (identifier == EXPI_COS) ? M_PI / 2 : 0;
+    
+    switch (identifier) {
+            
+        case EXPI_ABS:
+            if (argument->lower >= 0) {
+                *result = *argument;
+            } else if (argument->upper <= 0) {
+                result->lower = -argument->upper;
+                result->upper = -argument->lower;
+            } else {
+                result->lower = 0;
+                result->upper = fmax(-argument->lower, argument->upper);
+            }
+            return true;
+            
+        case EXPI_LN:
+            if (argument->lower <= 0) return false;
+            result->lower = log(argument->lower);
+            result->upper = log(argument->upper);
+            break;
+            
+        case EXPI_LOG:
+            if (argument->lower <= 0) return false;
+            result->lower = log10(argument->lower);
+            result->upper = log10(argument->upper);
+            break;
+            
+        case EXPI_SIN:
+        case EXPI_COS:
+            
+            if (fabs(argument->lower) > 1e6 || fabs(argument->upper) > 1e6 || argument->upper - argument->lower >= 2 * M_PI) {
+                result->lower = -1;
+                result->upper = 1;
+                return true;
+            }
+            
+            if (identifier == EXPI_SIN) {
+                result->lower = fmin(sin(argument->lower), sin(argument->upper));
+                result->upper = fmax(sin(argument->lower), sin(argument->upper));
+            } else {
+                result->lower = fmin(cos(argument->lower), cos(argument->upper));
+                result->upper = fmax(cos(argument->lower), cos(argument->upper));
+            }
+            
+            widen_interval(result, 2);
+            
+            if (interval_contains_point(argument, M_PI / 2 - shift, 2 * M_PI)) result->upper = 1;
+            if (interval_contains_point(argument, -M_PI / 2 - shift, 2 * M_PI)) result->lower = -1;
+            
+            result->lower = fmax(result->lower, -1);
+            result->upper = fmin(result->upper, 1);
+            
+            return true;
+            
+        case EXPI_TAN:
+            if (fabs(argument->lower) > 1e6 || fabs(argument->upper) > 1e6) return false;
+            if (argument->upper - argument->lower >= M_PI || interval_contains_point(argument, M_PI / 2, M_PI)) return false;
+            get_function_interval(&cosine, EXPI_COS, argument);
+            if (cosine.lower <= 0 && cosine.upper >= 0) return false;
+            result->lower = tan(argument->lower);
+            result->upper = tan(argument->upper);
+            break;
+            
+        case EXPI_ARCSIN:
+            if (argument->lower < -1 || argument->upper > 1) return false;
+            result->lower = asin(argument->lower);
+            result->upper = asin(argument->upper);
+            break;
+            
+        case EXPI_ARCCOS:
+            if (argument->lower < -1 || argument->upper > 1) return false;
+            result->lower = acos(argument->upper);
+            result->upper = acos(argument->lower);
+            break;
+            
+        case EXPI_ARCTAN:
+            result->lower = atan(argument->lower);
+            result->upper = atan(argument->upper);
+            break;
+            
+        default:
+            return false;
+            
+    }
+    
+    widen_interval(result, 2);
+    
+    return interval_is_valid(result);
+    
+}
+
+/**
+ 
+ @brief Encloses the value of a constant expression in an interval
+ 
+ @details
+ Every operation rounds outwards, so the interval is guaranteed to
+ contain the exact value. Expressions with symbols other than pi and
+ e, the imaginary unit or values outside the real domain of a
+ function can't be enclosed.
+ 
+ @param[out] result The interval.
+ @param[in] source The expression.
+ 
+ @return
+ - Whether the expression could be enclosed.
+ 
+ */
+bool get_interval(interval* result, const expression* source) {
+    
+    uint16_t i;
+    interval child;
+    
+    if (source == NULL) return false;
+    
+    switch (source->identifier) {
+            
+        case EXPI_LITERAL:
+            if (!get_literal_interval(result, source)) return false;
+            break;
+            
+        case EXPI_SYMBOL:
+            if (source->value.symbol == SYMBOL_PI) {
+                get_point_interval(result, M_PI, 1);
+            } else if (source->value.symbol == SYMBOL_E) {
+                get_point_interval(result, M_E, 1);
+            } else {
+                return false;
+            }
+            break;
+            
+        case EXPI_ADDITION:
+        case EXPI_MULTIPLICATION:
+            
+            get_point_interval(result, (source->identifier == EXPI_ADDITION) ? 0 : 1, 0);
+            
+            for (i = 0; i < source->child_count; i++) {
+                if (!get_interval(&child, source->children[i])) return false;
+                if (source->identifier == EXPI_ADDITION) {
+                    add_intervals(result, result, &child);
+                } else {
+                    multiply_intervals(result, result, &child);
+                }
+            }
+            
+            break;
+            
+        case EXPI_SUBTRACTION:
+            if (source->child_count != 2 || !get_interval(result, source->children[0]) || !get_interval(&child, source->children[1])) return false;
+            result->lower -= child.upper;
+            result->upper -= child.lower;
+            widen_interval(result, 1);
+            break;
+            
+        case EXPI_DIVISION:
+            if (source->child_count != 2 || !get_interval(result, source->children[0]) || !get_interval(&child, source->children[1])) return false;
+            if (!divide_intervals(result, result, &child)) return false;
+            break;
+            
+        case EXPI_EXPONENTATION:
+            if (source->child_count != 2 || !get_interval(&child, source->children[0])) return false;
+            if (!get_power_interval(result, &child, source->children[1])) return false;
+            break;
+            
+        case EXPI_ABS:
+        case EXPI_LN:
+        case EXPI_LOG:
+        case EXPI_SIN:
+        case EXPI_COS:
+        case EXPI_TAN:
+        case EXPI_ARCSIN:
+        case EXPI_ARCCOS:
+        case EXPI_ARCTAN:
+            if (source->identifier == EXPI_LOG && source->child_count == 2) {
+                if (!get_interval(&child, source->children[0]) || !get_function_interval(result, EXPI_LN, &child)) return false;
+                if (!get_interval(&child, source->children[1]) || !get_function_interval(&child, EXPI_LN, &child)) return false;
+                if (!divide_intervals(result, result, &child)) return false;
+                break;
+            }
+            if (source->child_count != 1 || !get_interval(&child, source->children[0])) return false;
+            if (!get_function_interval(result, source->identifier, &child)) return false;
+            break;
+            
+        default:
+            return false;
+            
+    }
+    
+    if (source->sign == -1) {
+        child = *result;
+        result->lower = -child.upper;
+        result->upper = -child.lower;
+    }
+    
+    return interval_is_valid(result);
+    
+}
+
+/**
+ 
+ @brief Compares two constant expressions numerically
+ 
+ @details
+ The expressions are enclosed in intervals (see @c get_interval()). If
+ the intervals are disjoint, the order is certain. The summaries reject
+ expressions with unsupported operators or symbols without traversing
+ them.
+ 
+ @return
+ - 1 if @c a is greater than @c b, -1 if it is smaller, and 0 if the
+ intervals overlap or can't be computed.
+ 
+ */
+int8_t compare_by_intervals(const expression* a, const expression* b) {
+    
+    interval a_interval, b_interval;
+    expression_summary a_summary = get_expression_summary(a);
+    expression_summary b_summary = get_expression_summary(b);
+    
+    if (((a_summary.operators | b_summary.operators) & ~INTERVAL_OPERATORS) != 0) return 0;
+    if (((a_summary.symbols | b_summary.symbols) & ~(SUMMARY_SYMBOL_BIT(SYMBOL_PI) | SUMMARY_SYMBOL_BIT(SYMBOL_E))) != 0) return 0;
+    
+    if (!get_interval(&a_interval, a) || !get_interval(&b_interval, b)) return 0;
+    
+    if (a_interval.lower > b_interval.upper) return 1;
+    if (a_interval.upper < b_interval.lower) return -1;
+    
+    return 0;
+    
+}
@@ -0,0 +1,51 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef interval_h
+#define interval_h
+
+#include "symbolic4.h"
+
+/// The identifiers which can be enclosed in an interval
+#define INTERVAL_OPERATORS (SUMMARY_OPERATOR_BIT(EXPI_LITERAL) | SUMMARY_OPERATOR_BIT(EXPI_SYMBOL) | SUMMARY_OPERATOR_BIT(EXPI_ADDITION) | SUMMARY_OPERATOR_BIT(EXPI_SUBTRACTION) | SUMMARY_OPERATOR_BIT(EXPI_MULTIPLICATION) | SUMMARY_OPERATOR_BIT(EXPI_DIVISION) | SUMMARY_OPERATOR_BIT(EXPI_EXPONENTATION) | SUMMARY_OPERATOR_BIT(EXPI_ABS) | SUMMARY_OPERATOR_BIT(EXPI_LN) | SUMMARY_OPERATOR_BIT(EXPI_LOG) | SUMMARY_OPERATOR_BIT(EXPI_SIN) | SUMMARY_OPERATOR_BIT(EXPI_COS) | SUMMARY_OPERATOR_BIT(EXPI_TAN) | SUMMARY_OPERATOR_BIT(EXPI_ARCSIN) | SUMMARY_OPERATOR_BIT(EXPI_ARCCOS) | SUMMARY_OPERATOR_BIT(EXPI_ARCTAN))
+
+/// The largest integer exponent which is evaluated by repeated multiplication
+#define INTERVAL_MAX_INTEGER_EXPONENT 1024
+
+/**
+ 
+ @brief A closed interval of doubles which is known to contain a real
+ number
+ 
+ */
+typedef struct interval {
+    double lower;
+    double upper;
+} interval;
+
+bool get_interval(interval* result, const expression* source);
+int8_t compare_by_intervals(const expression* a, const expression* b);
+
+#endif /* interval_h */
@@ -33,13 +33,36 @@ uintmax_t max(uintmax_t a, uintmax_t b) {
     return (a > b) ? a : b;
 }
 
+/**
+ 
+ @brief Counts the trailing zero bits of a nonzero integer
+ 
+ */
+uint8_t trailing_zeros(uintmax_t source) {
+    
+    uint8_t count = 0;
+    
+#if defined(__GNUC__) || defined(__clang__)
+    if (sizeof(uintmax_t) == sizeof(unsigned long long)) return (uint8_t) __builtin_ctzll(source);
+#endif
+    
+    while ((source & 1) == 0) {
+        source >>= 1;
+        count++;
+    }
+    
+    return count;
+    
+}
+
 /**
  
  @brief Computes the GCD of two integers
  
  @details
  This function computes the greatest common divisor of two integers
- using the iterative Euclidean algorithm.
+ using the binary GCD algorithm, which only needs shifts and
+ subtractions instead of divisions.
  
  @param[in] a The first integer.
  @param[in] b The second integer.
@@ -48,58 +71,32 @@ uintmax_t max(uintmax_t a, uintmax_t b) {
  - The greatest common divisor.
  
  */
-uintmax_t euclidean_gcd(uintmax_t a, uintmax_t b) {
+uintmax_t binary_gcd(uintmax_t a, uintmax_t b) {
     
+    uint8_t shift;
     uintmax_t t;
     
-    while (b != 0) {
-        t = b;
-        b = a % b;
-        a = t;
-    }
-    
-    return a;
+    if (a == 0) return b;
+    if (b == 0) return a;
     
-}
-
-expression* prime_factors(uintmax_t source) {
-    
-    uintmax_t factor = 2;
-    expression* factors = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
-    
-    if (source % factor == 0) {
-        append_child(factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
-                                             new_literal(1, factor, 1),
-                                             new_literal(1, 0, 1)));
-    }
-    
-    while (source % factor == 0) {
-        factors->children[factors->child_count - 1]->children[1]->value.numeric.numerator++;
-        source /= factor;
-    }
+    shift = trailing_zeros(a | b);
+    a >>= trailing_zeros(a);
     
-    for (factor = 3; factor <= sqrt(source); factor += 2) {
+    do {
         
-        if (source % factor == 0) {
-            append_child(factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
-                                                 new_literal(1, factor, 1),
-                                                 new_literal(1, 0, 1)));
-        }
+        b >>= trailing_zeros(b);
         
-        while (source % factor == 0) {
-            factors->children[factors->child_count - 1]->children[1]->value.numeric.numerator++;
-            source /= factor;
+        if (a > b) {
+            t = b;
+            b = a;
+            a = t;
         }
         
-    }
-    
-    if (source > 2) {
-        append_child(factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
-                                             new_literal(1, source, 1),
-                                             new_literal(1, 1, 1)));
-    }
+        b -= a;
+        
+    } while (b != 0);
     
-    return factors;
+    return a << shift;
     
 }
 
@@ -121,49 +118,205 @@ uintmax_t* binomial_coefficients(uint8_t n) {
     
 }
 
+/**
+ 
+ @brief Adds two integers
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the sum doesn't fit into a
+ @c uintmax_t. The result is left unchanged in that case.
+ 
+ */
 uint8_t addition(uintmax_t* result, uintmax_t a, uintmax_t b) {
-    if (((double) a + (double) b) < uintmax_max_value()) {
-        *result = a + b;
-        return RETS_SUCCESS;
-    } else {
-        return RETS_ERROR;
-    }
+    
+    uintmax_t sum;
+    
+#if defined(__GNUC__) || defined(__clang__)
+    if (__builtin_add_overflow(a, b, &sum)) return RETS_ERROR;
+#else
+    if (a > (uintmax_t) -1 - b) return RETS_ERROR;
+    sum = a + b;
+#endif
+    
+    *result = sum;
+    
+    return RETS_SUCCESS;
+    
 }
 
+/**
+ 
+ @brief Multiplies two integers
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the product doesn't fit into a
+ @c uintmax_t. The result is left unchanged in that case.
+ 
+ */
 uint8_t multiplication(uintmax_t* result, uintmax_t a, uintmax_t b) {
-    if (((double) a * (double) b) < uintmax_max_value()) {
-        *result = a * b;
-        return RETS_SUCCESS;
-    } else {
-        return RETS_ERROR;
-    }
+    
+    uintmax_t product;
+    
+#if defined(__GNUC__) || defined(__clang__)
+    if (__builtin_mul_overflow(a, b, &product)) return RETS_ERROR;
+#else
+    if (b != 0 && a > (uintmax_t) -1 / b) return RETS_ERROR;
+    product = a * b;
+#endif
+    
+    *result = product;
+    
+    return RETS_SUCCESS;
+    
 }
 
+/**
+ 
+ @brief Raises an integer to a power
+ 
+ @details
+ This function uses exponentiation by squaring, so it needs at most two
+ multiplications per bit of the exponent.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the power doesn't fit into a
+ @c uintmax_t.
+ 
+ */
 uint8_t int_power(uintmax_t* result, uintmax_t base, uintmax_t exponent) {
-    *result = 1;
-    if (pow(base, exponent) < uintmax_max_value()) {
-        for ( ; exponent > 0; exponent--) *result *= base;
-        return RETS_SUCCESS;
-    } else {
-        return RETS_ERROR;
+    
+    uintmax_t temp_result = 1;
+    
+    while (true) {
+        
+        if (exponent & 1) {
+            ERROR_CHECK(multiplication(&temp_result, temp_result, base));
+        }
+        
+        exponent >>= 1;
+        if (exponent == 0) break;
+        
+        ERROR_CHECK(multiplication(&base, base, base));
+        
     }
+    
+    *result = temp_result;
+    
+    return RETS_SUCCESS;
+    
 }
 
-void int_root(uintmax_t* factor, uintmax_t* remainder, uintmax_t base, uintmax_t degree) {
-    
-    uint8_t i;
-    uintmax_t temp_result;
-    expression* factors = prime_factors(base);
-    
-    for (i = 0; i < factors->child_count; i++) {
-        while (factors->children[i]->children[1]->value.numeric.numerator >= degree) {
-            factors->children[i]->children[1]->value.numeric.numerator -= degree;
-            *factor *= factors->children[i]->children[0]->value.numeric.numerator;
-            int_power(&temp_result, factors->children[i]->children[0]->value.numeric.numerator, degree);
-            *remainder /= temp_result;
-        }
+/**
+ 
+ @brief Adds two signed rationals with native integers
+ 
+ @details
+ This function uses Henrici's algorithm: with <tt>g = gcd(b, d)</tt>,
+ the sum of <tt>a / b</tt> and <tt>c / d</tt> is
+ <tt>t / g'</tt> over <tt>(b / g) * (d / g')</tt>, where
+ <tt>t = a * (d / g) + c * (b / g)</tt> and <tt>g' = gcd(t, g)</tt>.
+ The intermediates stay smaller than with a common denominator of
+ <tt>b * d</tt>, and the result is in lowest terms if both operands are.
+ If available, the cross terms are computed with 128-bit integers.
+ 
+ @param[out] result The sum.
+ @param[out] result_sign The sign of the sum (1 if the sum is zero).
+ @param[in] a The first operand.
+ @param[in] a_sign The sign of the first operand.
+ @param[in] b The second operand.
+ @param[in] b_sign The sign of the second operand.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the sum doesn't fit into native
+ integers.
+ 
+ */
+uint8_t rational_addition(numeric_value* result, int8_t* result_sign, const numeric_value* a, int8_t a_sign, const numeric_value* b, int8_t b_sign) {
+    
+    uintmax_t gcd = binary_gcd(a->denominator, b->denominator);
+    uintmax_t a_cofactor = b->denominator / gcd;
+    uintmax_t b_cofactor = a->denominator / gcd;
+    uintmax_t numerator_gcd;
+    
+#ifdef MATH_WIDE_INTERMEDIATES
+    
+    uintwide_t temp_1 = (uintwide_t) a->numerator * a_cofactor;
+    uintwide_t temp_2 = (uintwide_t) b->numerator * b_cofactor;
+    uintwide_t sum;
+    
+    if (a_sign == b_sign) {
+        if (__builtin_add_overflow(temp_1, temp_2, &sum)) return RETS_ERROR;
+        *result_sign = a_sign;
+    } else if (temp_1 > temp_2) {
+        sum = temp_1 - temp_2;
+        *result_sign = a_sign;
+    } else {
+        sum = temp_2 - temp_1;
+        *result_sign = b_sign;
+    }
+    
+    numerator_gcd = binary_gcd((uintmax_t) (sum % gcd), gcd);
+    sum /= numerator_gcd;
+    
+    if (sum > (uintmax_t) -1) return RETS_ERROR;
+    result->numerator = (uintmax_t) sum;
+    
+#else
+    
+    uintmax_t temp_1;
+    uintmax_t temp_2;
+    
+    ERROR_CHECK(multiplication(&temp_1, a->numerator, a_cofactor));
+    ERROR_CHECK(multiplication(&temp_2, b->numerator, b_cofactor));
+    
+    if (a_sign == b_sign) {
+        ERROR_CHECK(addition(&temp_1, temp_1, temp_2));
+        *result_sign = a_sign;
+    } else if (temp_1 > temp_2) {
+        temp_1 -= temp_2;
+        *result_sign = a_sign;
+    } else {
+        temp_1 = temp_2 - temp_1;
+        *result_sign = b_sign;
     }
     
-    free_expression(factors, false);
+    numerator_gcd = binary_gcd(temp_1, gcd);
+    result->numerator = temp_1 / numerator_gcd;
+    
+#endif
+    
+    if (result->numerator == 0) *result_sign = 1;
+    
+    return multiplication(&result->denominator, b_cofactor, b->denominator / numerator_gcd);
+    
+}
+
+/**
+ 
+ @brief Multiplies two rationals with native integers
+ 
+ @details
+ This function uses Henrici's algorithm: the numerator of each operand
+ is reduced with the denominator of the other one before multiplying,
+ so the result is in lowest terms if both operands are.
+ 
+ @param[out] result The product.
+ @param[in] a The first operand.
+ @param[in] b The second operand.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the product doesn't fit into
+ native integers.
+ 
+ */
+uint8_t rational_multiplication(numeric_value* result, const numeric_value* a, const numeric_value* b) {
+    
+    uintmax_t gcd_1 = binary_gcd(a->numerator, b->denominator);
+    uintmax_t gcd_2 = binary_gcd(b->numerator, a->denominator);
+    
+    ERROR_CHECK(multiplication(&result->numerator, a->numerator / gcd_1, b->numerator / gcd_2));
+    ERROR_CHECK(multiplication(&result->denominator, a->denominator / gcd_2, b->denominator / gcd_1));
+    
+    return RETS_SUCCESS;
     
 }
@@ -28,14 +28,20 @@
 
 #include "symbolic4.h"
 
+#if defined(__SIZEOF_INT128__) && UINTMAX_MAX == UINT64_MAX
+#define MATH_WIDE_INTERMEDIATES
+typedef unsigned __int128 uintwide_t; ///< An integer twice as wide as @c uintmax_t
+#endif
+
 uintmax_t min(uintmax_t a, uintmax_t b);
 uintmax_t max(uintmax_t a, uintmax_t b);
-uintmax_t euclidean_gcd(uintmax_t a, uintmax_t b);
-expression* prime_factors(uintmax_t source);
+uint8_t trailing_zeros(uintmax_t source);
+uintmax_t binary_gcd(uintmax_t a, uintmax_t b);
 uintmax_t* binomial_coefficients(uint8_t n);
 uint8_t addition(uintmax_t* result, uintmax_t a, uintmax_t b);
 uint8_t multiplication(uintmax_t* result, uintmax_t a, uintmax_t b);
 uint8_t int_power(uintmax_t* result, uintmax_t base, uintmax_t exponent);
-void int_root(uintmax_t* factor, uintmax_t* remainder, uintmax_t base, uintmax_t degree);
+uint8_t rational_addition(numeric_value* result, int8_t* result_sign, const numeric_value* a, int8_t a_sign, const numeric_value* b, int8_t b_sign);
+uint8_t rational_multiplication(numeric_value* result, const numeric_value* a, const numeric_value* b);
 
 #endif /* math_foundation_h */
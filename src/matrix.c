@@ -70,10 +70,10 @@ expression* new_sub_matrix(expression* matrix, uint8_t rows, uint8_t colums) {
 
 void sylvester_matrix(expression** matrix, expression* a, expression* b) {
     
-    uint8_t i, j;
+    uint16_t i, j;
     expression* result;
-    uint8_t a_degree = a->child_count - 1;
-    uint8_t b_degree = b->child_count - 1;
+    uint16_t a_degree = a->child_count - 1;
+    uint16_t b_degree = b->child_count - 1;
     uint8_t size = a_degree + b_degree;
     
     result = new_matrix(size, size);
@@ -96,9 +96,9 @@ void sylvester_matrix(expression** matrix, expression* a, expression* b) {
 
 void gauss_determinant(expression** determinant, const expression* matrix) {
     
-    uint8_t i, j;
+    uint16_t i, j;
     uint8_t factor = 1;
-    uint8_t max = 0;
+    uint16_t max = 0;
     expression* sub_matrix;
     expression* f;
     expression* new_row = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
@@ -111,13 +111,13 @@ void gauss_determinant(expression** determinant, const expression* matrix) {
     }
     
     for (i = 0; i < matrix->child_count; i++) {
-        if (!expressions_are_equivalent(matrix->children[i]->children[0], new_literal(1, 0, 1), false)) {
+        if (!is_equivalent(matrix->children[i]->children[0], &literal_zero)) {
             max = i;
             break;
         }
     }
     
-    if (expressions_are_equivalent(matrix->children[max]->children[0], new_literal(1, 0, 1), false)) {
+    if (is_equivalent(matrix->children[max]->children[0], &literal_zero)) {
         
         *determinant = new_literal(1, 0, 1);
         return;
@@ -189,13 +189,13 @@ void calculate_resultant(expression** result, expression* a, expression* b) {
     
     if (a->child_count == 1) {
         if (expression_is_numerical(a->children[0])) {
-            if (expressions_are_identical(a->children[0], new_literal(1, 0, 1), false)) {
+            if (is_zero(a->children[0])) {
                 *result = new_literal(1, 0, 1);
                 return;
             } else {
                 if (b->child_count == 0) {
                     if (expression_is_numerical(b->children[0])) {
-                        if (!expressions_are_identical(b->children[0], new_literal(1, 0, 1), false)) {
+                        if (!is_zero(b->children[0])) {
                             *result = new_literal(1, 1, 1);
                             return;
                         }
@@ -203,13 +203,13 @@ void calculate_resultant(expression** result, expression* a, expression* b) {
                 }
             }
         } else {
-            if (expressions_are_identical(a->children[0], new_literal(1, 0, 1), false)) {
+            if (is_zero(a->children[0])) {
                 *result = new_literal(1, 0, 1);
                 return;
             } else {
                 if (b->child_count == 0) {
                     if (expression_is_numerical(b->children[0])) {
-                        if (!expressions_are_identical(b->children[0], new_literal(1, 0, 1), false)) {
+                        if (!is_zero(b->children[0])) {
                             *result = new_literal(1, 1, 1);
                             return;
                         }
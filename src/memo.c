@@ -0,0 +1,204 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+size_t simplify_memo_count_nodes(const expression* source, size_t limit);
+
+simplify_memo* new_simplify_memo(void) {
+    simplify_memo* memo = calloc(1, sizeof(simplify_memo));
+    if (memo == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    return memo;
+}
+
+void free_simplify_memo(simplify_memo* memo) {
+    if (memo == NULL) return;
+    clear_simplify_memo(memo);
+    free(memo);
+}
+
+/**
+ 
+ @brief Removes all entries of a memo table
+ 
+ @param[in,out] memo The memo table.
+ 
+ */
+void clear_simplify_memo(simplify_memo* memo) {
+    
+    size_t i;
+    
+    for (i = 0; i < memo->entry_count; i++) {
+        release_interned_expression(memo->entries[i].input);
+        release_interned_expression(memo->entries[i].output);
+    }
+    
+    memset(memo->buckets, 0, sizeof(memo->buckets));
+    memo->entry_count = 0;
+    memo->hand = 0;
+    
+}
+
+/**
+ 
+ @brief Counts the nodes of an expression, but stops after @c limit
+ 
+ @param[in] source The expression.
+ @param[in] limit The maximum count of interest.
+ 
+ @return
+ - The number of nodes, or a number greater than @c limit.
+ 
+ */
+size_t simplify_memo_count_nodes(const expression* source, size_t limit) {
+    
+    uint16_t i;
+    size_t count = 1;
+    
+    for (i = 0; i < source->child_count && count <= limit; i++) {
+        if (source->children[i] == NULL) continue;
+        count += simplify_memo_count_nodes(source->children[i], limit - count);
+    }
+    
+    return count;
+    
+}
+
+/**
+ 
+ @brief Checks if the simplification of an expression should be
+ memoized
+ 
+ @details
+ Small expressions are simplified faster than they are hashed and
+ copied, and very large ones are unlikely to reappear, so only
+ expressions with between @c SIMPLIFY_MEMO_MIN_SIZE and
+ @c SIMPLIFY_MEMO_MAX_SIZE nodes are memoized.
+ 
+ @param[in] source The expression to be simplified.
+ 
+ @return
+ - @c true if the memo table should be used.
+ 
+ */
+bool simplify_memo_is_applicable(const expression* source) {
+    
+    size_t count;
+    
+    if (current_context->simplify_memo == NULL || source->child_count == 0) return false;
+    
+    count = simplify_memo_count_nodes(source, SIMPLIFY_MEMO_MAX_SIZE);
+    
+    return count >= SIMPLIFY_MEMO_MIN_SIZE && count <= SIMPLIFY_MEMO_MAX_SIZE;
+    
+}
+
+/**
+ 
+ @brief Replaces an expression with its memoized simplification
+ 
+ @details
+ The expression is looked up in the expression table of the context.
+ If it has never been interned, it can't be in the memo table either.
+ Otherwise the entry is found by the address of the interned node.
+ All entries are dropped if the contents of the default priorities
+ changed since they were computed.
+ 
+ @param[in,out] source The expression to be simplified.
+ 
+ @return
+ - @c true on a hit, @c false otherwise.
+ 
+ */
+bool simplify_memo_lookup(expression* source) {
+    
+    simplify_memo* memo = current_context->simplify_memo;
+    simplify_memo_entry* entry;
+    expression* input;
+    expression* parent = source->parent;
+    
+    if (memo->priorities_epoch != current_context->priorities_epoch) {
+        clear_simplify_memo(memo);
+        memo->priorities_epoch = current_context->priorities_epoch;
+    }
+    
+    if ((input = find_interned_expression(source)) != NULL) {
+        for (entry = memo->buckets[interned_expression_hash(input) % SIMPLIFY_MEMO_BUCKET_COUNT]; entry != NULL; entry = entry->next) {
+            if (entry->input == input) {
+                replace_expression(source, copy_expression(entry->output));
+                source->parent = parent;
+                memo->hits++;
+                return true;
+            }
+        }
+    }
+    
+    memo->misses++;
+    
+    return false;
+    
+}
+
+/**
+ 
+ @brief Stores the simplification of an expression
+ 
+ @details
+ Input and output are stored as interned DAGs, so subtrees shared by
+ several entries are stored only once. When the table is full, the
+ oldest entry is replaced.
+ 
+ @param[in] input The interned expression before simplification. The
+ reference is owned by the table afterwards.
+ @param[in] output The simplified expression.
+ 
+ */
+void simplify_memo_insert(expression* input, const expression* output) {
+    
+    simplify_memo* memo = current_context->simplify_memo;
+    simplify_memo_entry* entry;
+    simplify_memo_entry** link;
+    
+    if (memo->entry_count < SIMPLIFY_MEMO_CAPACITY) {
+        entry = &memo->entries[memo->entry_count++];
+    } else {
+        
+        entry = &memo->entries[memo->hand];
+        memo->hand = (memo->hand + 1) % SIMPLIFY_MEMO_CAPACITY;
+        
+        for (link = &memo->buckets[interned_expression_hash(entry->input) % SIMPLIFY_MEMO_BUCKET_COUNT]; *link != entry; link = &(*link)->next);
+        *link = entry->next;
+        
+        release_interned_expression(entry->input);
+        release_interned_expression(entry->output);
+        
+    }
+    
+    entry->input = input;
+    entry->output = intern_expression(output);
+    entry->next = memo->buckets[interned_expression_hash(input) % SIMPLIFY_MEMO_BUCKET_COUNT];
+    memo->buckets[interned_expression_hash(input) % SIMPLIFY_MEMO_BUCKET_COUNT] = entry;
+    
+}
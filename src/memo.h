@@ -0,0 +1,54 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef memo_h
+#define memo_h
+
+#include "symbolic4.h"
+
+typedef struct simplify_memo_entry {
+    struct simplify_memo_entry* next;
+    expression* input; ///< Interned (see @c intern_expression())
+    expression* output; ///< Interned (see @c intern_expression())
+} simplify_memo_entry;
+
+typedef struct simplify_memo {
+    simplify_memo_entry* buckets[SIMPLIFY_MEMO_BUCKET_COUNT];
+    simplify_memo_entry entries[SIMPLIFY_MEMO_CAPACITY];
+    size_t entry_count;
+    size_t hand;
+    uint32_t priorities_epoch; ///< The epoch of the default priorities the entries were computed with (see @c update_priorities_epoch())
+    uintmax_t hits;
+    uintmax_t misses;
+} simplify_memo;
+
+simplify_memo* new_simplify_memo(void);
+void free_simplify_memo(simplify_memo* memo);
+void clear_simplify_memo(simplify_memo* memo);
+bool simplify_memo_is_applicable(const expression* source);
+bool simplify_memo_lookup(expression* source);
+void simplify_memo_insert(expression* input, const expression* output);
+
+#endif /* memo_h */
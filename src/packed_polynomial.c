@@ -0,0 +1,996 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+void set_coefficient_zero(packed_coefficient* source);
+void free_coefficient(packed_coefficient* source);
+void copy_coefficient(packed_coefficient* result, const packed_coefficient* source);
+void replace_coefficient(packed_coefficient* result, const packed_coefficient* source);
+bool coefficient_is_zero(const packed_coefficient* source);
+bool coefficient_is_big(const packed_coefficient* source);
+return_status add_big_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b);
+return_status add_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b);
+return_status multiply_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b);
+return_status divide_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b);
+void trim_packed_polynomial(packed_polynomial* source);
+return_status packed_polynomial_euclidean_gcd(packed_polynomial** gcd, const packed_polynomial* a, const packed_polynomial* b);
+return_status make_primitive_packed_polynomial(packed_polynomial* source);
+int16_t get_modular_gcd(uintmax_t** result, uintmax_t* a, int16_t a_degree, uintmax_t* b, int16_t b_degree, uintmax_t modulus);
+uintmax_t coefficient_modulo(const packed_coefficient* source, bignum_limb modulus);
+return_status packed_polynomial_modular_gcd(packed_polynomial** gcd, const packed_polynomial* a, const packed_polynomial* b);
+
+void set_coefficient_zero(packed_coefficient* source) {
+    source->sign = 1;
+    source->value.numerator = 0;
+    source->value.denominator = 1;
+    source->value.big_numerator = NULL;
+    source->value.big_denominator = NULL;
+}
+
+void free_coefficient(packed_coefficient* source) {
+    free_bignum(source->value.big_numerator);
+    free_bignum(source->value.big_denominator);
+    set_coefficient_zero(source);
+}
+
+void copy_coefficient(packed_coefficient* result, const packed_coefficient* source) {
+    *result = *source;
+    result->value.big_numerator = copy_bignum(source->value.big_numerator);
+    result->value.big_denominator = copy_bignum(source->value.big_denominator);
+}
+
+/**
+ 
+ @brief Frees a coefficient and takes over another one
+ 
+ @details
+ The bignums of @c source are moved, not copied, so @c source mustn't
+ be used afterwards.
+ 
+ */
+void replace_coefficient(packed_coefficient* result, const packed_coefficient* source) {
+    free_coefficient(result);
+    *result = *source;
+}
+
+bool coefficient_is_zero(const packed_coefficient* source) {
+    return source->value.numerator == 0 && source->value.big_numerator == NULL;
+}
+
+bool coefficient_is_big(const packed_coefficient* source) {
+    return source->value.big_numerator != NULL || source->value.big_denominator != NULL;
+}
+
+/**
+ 
+ @brief Adds two coefficients with bignums
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the sum exceeds
+ @c BIGNUM_MAX_LIMBS.
+ 
+ */
+return_status add_big_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b) {
+    
+    bignum* a_denominator = numeric_part_to_bignum(a->value.denominator, a->value.big_denominator);
+    bignum* b_denominator = numeric_part_to_bignum(b->value.denominator, b->value.big_denominator);
+    bignum* a_numerator = numeric_part_to_bignum(a->value.numerator, a->value.big_numerator);
+    bignum* b_numerator = numeric_part_to_bignum(b->value.numerator, b->value.big_numerator);
+    bignum* temp_1 = bignum_multiply(a_numerator, b_denominator);
+    bignum* temp_2 = bignum_multiply(b_numerator, a_denominator);
+    bignum* numerator = NULL;
+    
+    result->sign = a->sign;
+    
+    if (temp_1 != NULL && temp_2 != NULL) {
+        if (a->sign == b->sign) {
+            numerator = bignum_add(temp_1, temp_2);
+        } else if (bignum_compare(temp_1, temp_2) > 0) {
+            numerator = bignum_subtract(temp_1, temp_2);
+        } else {
+            numerator = bignum_subtract(temp_2, temp_1);
+            result->sign = b->sign;
+        }
+    }
+    
+    free_bignum(temp_1);
+    free_bignum(temp_2);
+    free_bignum(a_numerator);
+    free_bignum(b_numerator);
+    
+    if (!set_big_numeric_value(&result->value, numerator, bignum_multiply(a_denominator, b_denominator))) {
+        free_bignum(a_denominator);
+        free_bignum(b_denominator);
+        return RETS_ERROR;
+    }
+    
+    free_bignum(a_denominator);
+    free_bignum(b_denominator);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Adds two coefficients
+ 
+ @details
+ Native integers are used as long as the sum fits into them (see
+ @c rational_addition()). @c result may be one of the operands.
+ 
+ */
+return_status add_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b) {
+    
+    packed_coefficient temp;
+    
+    set_coefficient_zero(&temp);
+    
+    if (coefficient_is_big(a) || coefficient_is_big(b) ||
+        rational_addition(&temp.value, &temp.sign, &a->value, a->sign, &b->value, b->sign) == RETS_ERROR) {
+        ERROR_CHECK(add_big_coefficients(&temp, a, b));
+    }
+    
+    if (coefficient_is_zero(&temp)) set_coefficient_zero(&temp);
+    replace_coefficient(result, &temp);
+    
+    return RETS_SUCCESS;
+    
+}
+
+return_status multiply_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b) {
+    
+    packed_coefficient temp;
+    bignum* a_part;
+    bignum* b_part;
+    bignum* numerator;
+    
+    set_coefficient_zero(&temp);
+    
+    if (coefficient_is_big(a) || coefficient_is_big(b) ||
+        rational_multiplication(&temp.value, &a->value, &b->value) == RETS_ERROR) {
+        
+        a_part = numeric_part_to_bignum(a->value.numerator, a->value.big_numerator);
+        b_part = numeric_part_to_bignum(b->value.numerator, b->value.big_numerator);
+        numerator = bignum_multiply(a_part, b_part);
+        
+        free_bignum(a_part);
+        free_bignum(b_part);
+        
+        a_part = numeric_part_to_bignum(a->value.denominator, a->value.big_denominator);
+        b_part = numeric_part_to_bignum(b->value.denominator, b->value.big_denominator);
+        
+        if (!set_big_numeric_value(&temp.value, numerator, bignum_multiply(a_part, b_part))) {
+            free_bignum(a_part);
+            free_bignum(b_part);
+            return RETS_ERROR;
+        }
+        
+        free_bignum(a_part);
+        free_bignum(b_part);
+        
+    }
+    
+    temp.sign = a->sign * b->sign;
+    if (coefficient_is_zero(&temp)) set_coefficient_zero(&temp);
+    replace_coefficient(result, &temp);
+    
+    return RETS_SUCCESS;
+    
+}
+
+return_status divide_coefficients(packed_coefficient* result, const packed_coefficient* a, const packed_coefficient* b) {
+    
+    packed_coefficient reciprocal = *b;
+    
+    if (coefficient_is_zero(b)) return RETS_ERROR;
+    
+    reciprocal.value.numerator = b->value.denominator;
+    reciprocal.value.denominator = b->value.numerator;
+    reciprocal.value.big_numerator = b->value.big_denominator;
+    reciprocal.value.big_denominator = b->value.big_numerator;
+    
+    return multiply_coefficients(result, a, &reciprocal);
+    
+}
+
+/**
+ 
+ @brief Lowers the degree of a polynomial until its leading coefficient
+ isn't zero
+ 
+ */
+void trim_packed_polynomial(packed_polynomial* source) {
+    while (source->degree >= 0 && coefficient_is_zero(&source->coefficients[source->degree])) source->degree--;
+}
+
+/**
+ 
+ @brief Allocates a new packed polynomial
+ 
+ @details
+ All coefficients are initialized to zero. The degree is only an upper
+ bound until the polynomial is trimmed.
+ 
+ @param[in] variable The variable, which is copied.
+ @param[in] degree The number of coefficients minus one.
+ 
+ @return
+ - The polynomial.
+ 
+ */
+packed_polynomial* new_packed_polynomial(const expression* variable, int16_t degree) {
+    
+    int16_t i;
+    packed_polynomial* result = smart_alloc(1, sizeof(packed_polynomial) + (degree + 1) * sizeof(packed_coefficient));
+    
+    result->variable = copy_expression(variable);
+    result->degree = degree;
+    
+    for (i = 0; i <= degree; i++) {
+        set_coefficient_zero(&result->coefficients[i]);
+    }
+    
+    return result;
+    
+}
+
+packed_polynomial* copy_packed_polynomial(const packed_polynomial* source) {
+    
+    int16_t i;
+    packed_polynomial* result = new_packed_polynomial(source->variable, source->degree);
+    
+    for (i = 0; i <= source->degree; i++) {
+        copy_coefficient(&result->coefficients[i], &source->coefficients[i]);
+    }
+    
+    return result;
+    
+}
+
+void free_packed_polynomial(packed_polynomial* source) {
+    
+    int16_t i;
+    
+    if (source == NULL) return;
+    
+    for (i = 0; i <= source->degree; i++) {
+        free_coefficient(&source->coefficients[i]);
+    }
+    
+    free_expression(source->variable, false);
+    smart_free(source);
+    
+}
+
+/**
+ 
+ @brief Converts a sparse polynomial into a packed polynomial
+ 
+ @details
+ The conversion fails if an exponent isn't a non-negative integer of
+ at most @c PACKED_POLYNOMIAL_MAX_DEGREE, if a coefficient isn't a
+ literal or if the terms aren't powers of the same symbol.
+ 
+ @param[out] result The packed polynomial.
+ @param[in] source The @c EXPI_POLYNOMIAL_SPARSE expression.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ */
+return_status sparse_polynomial_to_packed_polynomial(packed_polynomial** result, const expression* source) {
+    
+    uint16_t i;
+    int16_t degree = -1;
+    const expression* power;
+    const expression* coefficient;
+    packed_coefficient term;
+    
+    *result = NULL;
+    
+    if (source->identifier != EXPI_POLYNOMIAL_SPARSE || source->child_count == 0) return RETS_ERROR;
+    if (source->children[0]->children[2] == NULL || source->children[0]->children[2]->identifier != EXPI_SYMBOL) return RETS_ERROR;
+    
+    for (i = 0; i < source->child_count; i++) {
+        
+        power = source->children[i]->children[0];
+        coefficient = source->children[i]->children[1];
+        
+        if (power->identifier != EXPI_LITERAL || literal_is_big(power) ||
+            power->value.numeric.denominator != 1 || (power->sign == -1 && power->value.numeric.numerator != 0) ||
+            power->value.numeric.numerator > PACKED_POLYNOMIAL_MAX_DEGREE) return RETS_ERROR;
+        
+        if (coefficient->identifier != EXPI_LITERAL || (coefficient->value.numeric.denominator == 0 && coefficient->value.numeric.big_denominator == NULL)) return RETS_ERROR;
+        
+        if (!expressions_are_identical(source->children[i]->children[2], source->children[0]->children[2], true)) return RETS_ERROR;
+        
+        if ((int16_t) power->value.numeric.numerator > degree) degree = (int16_t) power->value.numeric.numerator;
+        
+    }
+    
+    *result = new_packed_polynomial(source->children[0]->children[2], degree);
+    
+    for (i = 0; i < source->child_count; i++) {
+        
+        power = source->children[i]->children[0];
+        coefficient = source->children[i]->children[1];
+        
+        term.sign = coefficient->sign;
+        term.value = coefficient->value.numeric;
+        
+        if (add_coefficients(&(*result)->coefficients[power->value.numeric.numerator], &(*result)->coefficients[power->value.numeric.numerator], &term) == RETS_ERROR) {
+            free_packed_polynomial(*result);
+            *result = NULL;
+            return RETS_ERROR;
+        }
+        
+    }
+    
+    trim_packed_polynomial(*result);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Converts a packed polynomial into a sparse polynomial
+ 
+ @details
+ The terms are sorted by descending exponents and terms with a zero
+ coefficient are omitted (see @c sort_sparse_polynomial()).
+ 
+ @param[in] source The packed polynomial.
+ 
+ @return
+ - The @c EXPI_POLYNOMIAL_SPARSE expression, or the literal 0 for the
+ zero polynomial.
+ 
+ */
+expression* packed_polynomial_to_sparse_polynomial(const packed_polynomial* source) {
+    
+    int16_t i;
+    expression* result;
+    expression* coefficient;
+    
+    if (source->degree < 0) return new_literal(1, 0, 1);
+    
+    result = new_expression(EXPT_STRUCTURE, EXPI_POLYNOMIAL_SPARSE, 0);
+    
+    for (i = source->degree; i >= 0; i--) {
+        
+        if (coefficient_is_zero(&source->coefficients[i])) continue;
+        
+        coefficient = new_literal(source->coefficients[i].sign, source->coefficients[i].value.numerator, source->coefficients[i].value.denominator);
+        coefficient->value.numeric.big_numerator = copy_bignum(source->coefficients[i].value.big_numerator);
+        coefficient->value.numeric.big_denominator = copy_bignum(source->coefficients[i].value.big_denominator);
+        
+        append_child(result, new_expression(EXPT_STRUCTURE, EXPI_LIST, 3,
+                                            new_literal(1, i, 1),
+                                            coefficient,
+                                            copy_expression(source->variable)));
+        
+    }
+    
+    return result;
+    
+}
+
+return_status packed_polynomial_add(packed_polynomial** result, const packed_polynomial* a, const packed_polynomial* b) {
+    
+    int16_t i;
+    
+    *result = copy_packed_polynomial((a->degree >= b->degree) ? a : b);
+    
+    for (i = 0; i <= a->degree && i <= b->degree; i++) {
+        if (add_coefficients(&(*result)->coefficients[i], &a->coefficients[i], &b->coefficients[i]) == RETS_ERROR) {
+            free_packed_polynomial(*result);
+            *result = NULL;
+            return RETS_ERROR;
+        }
+    }
+    
+    trim_packed_polynomial(*result);
+    
+    return RETS_SUCCESS;
+    
+}
+
+return_status packed_polynomial_multiply(packed_polynomial** result, const packed_polynomial* a, const packed_polynomial* b) {
+    
+    int16_t i, j;
+    packed_coefficient product;
+    
+    if (a->degree < 0 || b->degree < 0) {
+        *result = new_packed_polynomial(a->variable, -1);
+        return RETS_SUCCESS;
+    }
+    
+    if (a->degree + b->degree > PACKED_POLYNOMIAL_MAX_DEGREE) {
+        *result = NULL;
+        return RETS_ERROR;
+    }
+    
+    *result = new_packed_polynomial(a->variable, a->degree + b->degree);
+    set_coefficient_zero(&product);
+    
+    for (i = 0; i <= a->degree; i++) {
+        if (coefficient_is_zero(&a->coefficients[i])) continue;
+        for (j = 0; j <= b->degree; j++) {
+            if (multiply_coefficients(&product, &a->coefficients[i], &b->coefficients[j]) == RETS_ERROR ||
+                add_coefficients(&(*result)->coefficients[i + j], &(*result)->coefficients[i + j], &product) == RETS_ERROR) {
+                free_coefficient(&product);
+                free_packed_polynomial(*result);
+                *result = NULL;
+                return RETS_ERROR;
+            }
+        }
+    }
+    
+    free_coefficient(&product);
+    trim_packed_polynomial(*result);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Divides two packed polynomials with remainder
+ 
+ @details
+ This function uses long division in place on a copy of the dividend,
+ so the quotient is computed without any recursion.
+ 
+ @param[out] quotient The quotient (may be @c NULL).
+ @param[out] remainder The remainder (may be @c NULL).
+ @param[in] a The dividend.
+ @param[in] b The divisor, which mustn't be zero.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the divisor is zero or a
+ coefficient overflows.
+ 
+ */
+return_status packed_polynomial_divide(packed_polynomial** quotient, packed_polynomial** remainder, const packed_polynomial* a, const packed_polynomial* b) {
+    
+    int16_t i, j;
+    packed_coefficient factor;
+    packed_coefficient product;
+    packed_polynomial* temp_quotient;
+    packed_polynomial* temp_remainder;
+    
+    if (b->degree < 0) return RETS_ERROR;
+    
+    temp_quotient = new_packed_polynomial(a->variable, (a->degree >= b->degree) ? a->degree - b->degree : -1);
+    temp_remainder = copy_packed_polynomial(a);
+    set_coefficient_zero(&factor);
+    set_coefficient_zero(&product);
+    
+    for (i = temp_quotient->degree; i >= 0; i--) {
+        
+        if (divide_coefficients(&temp_quotient->coefficients[i], &temp_remainder->coefficients[i + b->degree], &b->coefficients[b->degree]) == RETS_ERROR) break;
+        
+        free_coefficient(&temp_remainder->coefficients[i + b->degree]);
+        
+        if (coefficient_is_zero(&temp_quotient->coefficients[i])) continue;
+        
+        free_coefficient(&factor);
+        copy_coefficient(&factor, &temp_quotient->coefficients[i]);
+        factor.sign *= -1;
+        
+        for (j = 0; j < b->degree; j++) {
+            if (multiply_coefficients(&product, &factor, &b->coefficients[j]) == RETS_ERROR ||
+                add_coefficients(&temp_remainder->coefficients[i + j], &temp_remainder->coefficients[i + j], &product) == RETS_ERROR) break;
+        }
+        
+        if (j < b->degree) break;
+        
+    }
+    
+    free_coefficient(&factor);
+    free_coefficient(&product);
+    
+    if (i >= 0) {
+        free_packed_polynomial(temp_quotient);
+        free_packed_polynomial(temp_remainder);
+        return RETS_ERROR;
+    }
+    
+    trim_packed_polynomial(temp_quotient);
+    trim_packed_polynomial(temp_remainder);
+    
+    if (quotient != NULL) {
+        *quotient = temp_quotient;
+    } else {
+        free_packed_polynomial(temp_quotient);
+    }
+    
+    if (remainder != NULL) {
+        *remainder = temp_remainder;
+    } else {
+        free_packed_polynomial(temp_remainder);
+    }
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Divides a packed polynomial by its leading coefficient
+ 
+ @details
+ The zero polynomial is left unchanged.
+ 
+ */
+return_status packed_polynomial_make_monic(packed_polynomial* source) {
+    
+    int16_t i;
+    packed_coefficient leading_coefficient;
+    
+    if (source->degree < 0) return RETS_SUCCESS;
+    
+    copy_coefficient(&leading_coefficient, &source->coefficients[source->degree]);
+    
+    for (i = 0; i <= source->degree; i++) {
+        if (divide_coefficients(&source->coefficients[i], &source->coefficients[i], &leading_coefficient) == RETS_ERROR) {
+            free_coefficient(&leading_coefficient);
+            return RETS_ERROR;
+        }
+    }
+    
+    free_coefficient(&leading_coefficient);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Computes the monic gcd of two packed polynomials with the
+ Euclidean algorithm
+ 
+ @details
+ Every remainder is made monic, which keeps the coefficients from
+ growing as fast as with plain remainders.
+ 
+ */
+return_status packed_polynomial_euclidean_gcd(packed_polynomial** gcd, const packed_polynomial* a, const packed_polynomial* b) {
+    
+    packed_polynomial* dividend = copy_packed_polynomial((a->degree >= b->degree) ? a : b);
+    packed_polynomial* divisor = copy_packed_polynomial((a->degree >= b->degree) ? b : a);
+    packed_polynomial* remainder;
+    
+    *gcd = NULL;
+    
+    while (divisor->degree >= 0) {
+        
+        if (packed_polynomial_make_monic(divisor) == RETS_ERROR ||
+            packed_polynomial_divide(NULL, &remainder, dividend, divisor) == RETS_ERROR) {
+            free_packed_polynomial(dividend);
+            free_packed_polynomial(divisor);
+            return RETS_ERROR;
+        }
+        
+        free_packed_polynomial(dividend);
+        dividend = divisor;
+        divisor = remainder;
+        
+    }
+    
+    free_packed_polynomial(divisor);
+    
+    if (packed_polynomial_make_monic(dividend) == RETS_ERROR) {
+        free_packed_polynomial(dividend);
+        return RETS_ERROR;
+    }
+    
+    *gcd = dividend;
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Scales a packed polynomial to integer coefficients without a
+ common factor
+ 
+ @details
+ The polynomial is made monic and multiplied by the least common
+ multiple of the denominators, so its leading coefficient is that
+ multiple.
+ 
+ */
+return_status make_primitive_packed_polynomial(packed_polynomial* source) {
+    
+    int16_t i;
+    bignum* multiple = new_bignum(1);
+    bignum* denominator;
+    bignum* gcd;
+    bignum* quotient;
+    bignum* temp;
+    packed_coefficient factor;
+    
+    ERROR_CHECK(packed_polynomial_make_monic(source));
+    
+    for (i = 0; i <= source->degree && multiple != NULL; i++) {
+        if (source->coefficients[i].value.denominator == 1) continue;
+        denominator = numeric_part_to_bignum(source->coefficients[i].value.denominator, source->coefficients[i].value.big_denominator);
+        gcd = bignum_gcd(multiple, denominator);
+        bignum_divide(&quotient, NULL, denominator, gcd);
+        temp = bignum_multiply(multiple, quotient);
+        free_bignum(multiple);
+        free_bignum(denominator);
+        free_bignum(gcd);
+        free_bignum(quotient);
+        multiple = temp;
+    }
+    
+    set_coefficient_zero(&factor);
+    
+    if (!set_big_numeric_value(&factor.value, multiple, new_bignum(1))) return RETS_ERROR;
+    
+    for (i = 0; i <= source->degree; i++) {
+        if (multiply_coefficients(&source->coefficients[i], &source->coefficients[i], &factor) == RETS_ERROR) {
+            free_coefficient(&factor);
+            return RETS_ERROR;
+        }
+    }
+    
+    free_coefficient(&factor);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Computes the monic gcd of two polynomials modulo a prime
+ 
+ @details
+ Both coefficient arrays are overwritten.
+ 
+ @param[out] result The coefficients of the gcd (either @c a or @c b).
+ @param[in] a The coefficients of the first polynomial.
+ @param[in] a_degree The degree of the first polynomial.
+ @param[in] b The coefficients of the second polynomial.
+ @param[in] b_degree The degree of the second polynomial.
+ @param[in] modulus The prime.
+ 
+ @return
+ - The degree of the gcd.
+ 
+ */
+int16_t get_modular_gcd(uintmax_t** result, uintmax_t* a, int16_t a_degree, uintmax_t* b, int16_t b_degree, uintmax_t modulus) {
+    
+    int16_t i;
+    int16_t temp_degree;
+    uintmax_t inverse;
+    uintmax_t factor;
+    uintmax_t* temp;
+    
+    while (b_degree >= 0) {
+        
+        inverse = power_modulo(b[b_degree], modulus - 2, modulus);
+        
+        while (a_degree >= b_degree) {
+            factor = multiply_modulo(a[a_degree], inverse, modulus);
+            for (i = 0; i <= b_degree; i++) {
+                a[a_degree - b_degree + i] = (a[a_degree - b_degree + i] + modulus - multiply_modulo(factor, b[i], modulus)) % modulus;
+            }
+            while (a_degree >= 0 && a[a_degree] == 0) a_degree--;
+        }
+        
+        temp = a;
+        a = b;
+        b = temp;
+        temp_degree = a_degree;
+        a_degree = b_degree;
+        b_degree = temp_degree;
+        
+    }
+    
+    inverse = power_modulo(a[a_degree], modulus - 2, modulus);
+    
+    for (i = 0; i <= a_degree; i++) {
+        a[i] = multiply_modulo(a[i], inverse, modulus);
+    }
+    
+    *result = a;
+    
+    return a_degree;
+    
+}
+
+uintmax_t coefficient_modulo(const packed_coefficient* source, bignum_limb modulus) {
+    
+    uintmax_t result;
+    
+    if (source->value.big_numerator != NULL) {
+        result = bignum_remainder_by_limb(source->value.big_numerator, modulus);
+    } else {
+        result = source->value.numerator % modulus;
+    }
+    
+    return (source->sign == -1 && result != 0) ? modulus - result : result;
+    
+}
+
+/**
+ 
+ @brief Computes the monic gcd of two non-constant packed polynomials
+ with the modular algorithm
+ 
+ @details
+ The primitive integer parts of the operands are reduced modulo
+ primes which fit into a limb, and the gcds of the images are scaled
+ to the gcd of the leading coefficients and combined with the Chinese
+ remainder theorem. Primes for which the image has a higher degree than
+ another one are unlucky and skipped. As soon as a further prime
+ doesn't change the symmetric representation of the combination (a
+ negative coefficient -v is stored as M - v and moves to M * p - v),
+ it is made monic and verified by trial division.
+ 
+ Unlike the Euclidean algorithm, no intermediate coefficients grow
+ beyond the size of the gcd.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the combination exceeds
+ @c BIGNUM_MAX_LIMBS.
+ 
+ */
+return_status packed_polynomial_modular_gcd(packed_polynomial** gcd, const packed_polynomial* a, const packed_polynomial* b) {
+    
+    int16_t i;
+    int16_t degree = -1;
+    int16_t image_degree;
+    bool changed;
+    bignum_limb modulus = (bignum_limb) -1;
+    uintmax_t leading_residue;
+    uintmax_t difference;
+    uintmax_t correction;
+    uintmax_t* a_image = smart_alloc(a->degree + 1, sizeof(uintmax_t));
+    uintmax_t* b_image = smart_alloc(b->degree + 1, sizeof(uintmax_t));
+    uintmax_t* image;
+    bignum** combination = smart_alloc(min(a->degree, b->degree) + 1, sizeof(bignum*));
+    bignum* product;
+    bignum* leading_gcd;
+    bignum* sum;
+    bignum* temp;
+    packed_polynomial* a_primitive = copy_packed_polynomial(a);
+    packed_polynomial* b_primitive = copy_packed_polynomial(b);
+    packed_polynomial* candidate = NULL;
+    packed_polynomial* remainder;
+    return_status status = RETS_ERROR;
+    
+    *gcd = NULL;
+    
+    if (make_primitive_packed_polynomial(a_primitive) == RETS_ERROR || make_primitive_packed_polynomial(b_primitive) == RETS_ERROR) {
+        free_packed_polynomial(a_primitive);
+        free_packed_polynomial(b_primitive);
+        return RETS_ERROR;
+    }
+    
+    temp = numeric_part_to_bignum(a_primitive->coefficients[a_primitive->degree].value.numerator, a_primitive->coefficients[a_primitive->degree].value.big_numerator);
+    product = numeric_part_to_bignum(b_primitive->coefficients[b_primitive->degree].value.numerator, b_primitive->coefficients[b_primitive->degree].value.big_numerator);
+    leading_gcd = bignum_gcd(temp, product);
+    free_bignum(temp);
+    free_bignum(product);
+    product = new_bignum(1);
+    
+    while (product != NULL) {
+        
+        do {
+            modulus -= 2;
+        } while (!is_prime(modulus));
+        
+        if (coefficient_modulo(&a_primitive->coefficients[a_primitive->degree], modulus) == 0 ||
+            coefficient_modulo(&b_primitive->coefficients[b_primitive->degree], modulus) == 0) continue;
+        
+        for (i = 0; i <= a_primitive->degree; i++) {
+            a_image[i] = coefficient_modulo(&a_primitive->coefficients[i], modulus);
+        }
+        for (i = 0; i <= b_primitive->degree; i++) {
+            b_image[i] = coefficient_modulo(&b_primitive->coefficients[i], modulus);
+        }
+        
+        image_degree = get_modular_gcd(&image, a_image, a_primitive->degree, b_image, b_primitive->degree, modulus);
+        leading_residue = bignum_remainder_by_limb(leading_gcd, modulus);
+        
+        if (image_degree == 0) {
+            *gcd = new_packed_polynomial(a->variable, 0);
+            (*gcd)->coefficients[0].value.numerator = 1;
+            status = RETS_SUCCESS;
+            break;
+        }
+        
+        if (degree != -1 && image_degree > degree) continue;
+        
+        if (degree == -1 || image_degree < degree) {
+            
+            for (i = 0; i <= degree; i++) {
+                free_bignum(combination[i]);
+            }
+            free_bignum(product);
+            
+            degree = image_degree;
+            product = new_bignum(modulus);
+            
+            for (i = 0; i <= degree; i++) {
+                combination[i] = new_bignum(multiply_modulo(image[i], leading_residue, modulus));
+            }
+            
+            continue;
+            
+        }
+        
+        changed = false;
+        correction = power_modulo(bignum_remainder_by_limb(product, modulus), modulus - 2, modulus);
+        
+        for (i = 0; i <= degree && product != NULL; i++) {
+            
+            difference = (multiply_modulo(image[i], leading_residue, modulus) + modulus - bignum_remainder_by_limb(combination[i], modulus)) % modulus;
+            difference = multiply_modulo(difference, correction, modulus);
+            
+            if (difference == 0) continue;
+            
+            if (difference == modulus - 1) {
+                temp = bignum_multiply_add(combination[i], 2, 0);
+                if (temp == NULL || bignum_compare(temp, product) <= 0) changed = true;
+                free_bignum(temp);
+            } else {
+                changed = true;
+            }
+            
+            temp = bignum_multiply_add(product, (bignum_limb) difference, 0);
+            sum = (temp != NULL) ? bignum_add(combination[i], temp) : NULL;
+            free_bignum(temp);
+            
+            if (sum == NULL) {
+                free_bignum(product);
+                product = NULL;
+                break;
+            }
+            
+            free_bignum(combination[i]);
+            combination[i] = sum;
+            
+        }
+        
+        if (product == NULL) break;
+        
+        temp = bignum_multiply_add(product, modulus, 0);
+        free_bignum(product);
+        product = temp;
+        
+        if (product != NULL && !changed) {
+            
+            candidate = new_packed_polynomial(a->variable, degree);
+            
+            for (i = 0; i <= degree; i++) {
+                temp = bignum_multiply_add(combination[i], 2, 0);
+                if (temp != NULL && bignum_compare(temp, product) > 0) {
+                    candidate->coefficients[i].sign = -1;
+                    set_big_numeric_value(&candidate->coefficients[i].value, bignum_subtract(product, combination[i]), new_bignum(1));
+                } else {
+                    set_big_numeric_value(&candidate->coefficients[i].value, copy_bignum(combination[i]), new_bignum(1));
+                }
+                free_bignum(temp);
+            }
+            
+            trim_packed_polynomial(candidate);
+            
+            if (packed_polynomial_make_monic(candidate) == RETS_SUCCESS &&
+                packed_polynomial_divide(NULL, &remainder, a, candidate) == RETS_SUCCESS) {
+                
+                if (remainder->degree < 0) {
+                    free_packed_polynomial(remainder);
+                    if (packed_polynomial_divide(NULL, &remainder, b, candidate) == RETS_SUCCESS && remainder->degree < 0) {
+                        *gcd = candidate;
+                        candidate = NULL;
+                        status = RETS_SUCCESS;
+                    }
+                }
+                
+                free_packed_polynomial(remainder);
+                
+            }
+            
+            free_packed_polynomial(candidate);
+            if (status == RETS_SUCCESS) break;
+            
+        }
+        
+    }
+    
+    for (i = 0; i <= degree; i++) {
+        free_bignum(combination[i]);
+    }
+    
+    free_bignum(product);
+    free_bignum(leading_gcd);
+    free_packed_polynomial(a_primitive);
+    free_packed_polynomial(b_primitive);
+    smart_free(combination);
+    smart_free(b_image);
+    smart_free(a_image);
+    
+    return status;
+    
+}
+
+/**
+ 
+ @brief Computes the monic greatest common divisor of two packed
+ polynomials
+ 
+ @details
+ Non-constant operands are handled by the modular algorithm (see
+ @c packed_polynomial_modular_gcd()), and by the Euclidean algorithm if
+ that fails.
+ 
+ @param[out] gcd The monic gcd (the zero polynomial if both operands
+ are zero).
+ @param[in] a The first operand.
+ @param[in] b The second operand.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if a coefficient overflows.
+ 
+ */
+return_status packed_polynomial_gcd(packed_polynomial** gcd, const packed_polynomial* a, const packed_polynomial* b) {
+    
+    if (a->degree > 0 && b->degree > 0 && packed_polynomial_modular_gcd(gcd, a, b) == RETS_SUCCESS) return RETS_SUCCESS;
+    
+    return packed_polynomial_euclidean_gcd(gcd, a, b);
+    
+}
+
+return_status packed_polynomial_derivative(packed_polynomial** result, const packed_polynomial* source) {
+    
+    int16_t i;
+    packed_coefficient power;
+    
+    *result = new_packed_polynomial(source->variable, (source->degree > 0) ? source->degree - 1 : -1);
+    set_coefficient_zero(&power);
+    
+    for (i = 1; i <= source->degree; i++) {
+        power.value.numerator = i;
+        if (multiply_coefficients(&(*result)->coefficients[i - 1], &source->coefficients[i], &power) == RETS_ERROR) {
+            free_packed_polynomial(*result);
+            *result = NULL;
+            return RETS_ERROR;
+        }
+    }
+    
+    trim_packed_polynomial(*result);
+    
+    return RETS_SUCCESS;
+    
+}
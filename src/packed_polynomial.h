@@ -0,0 +1,80 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef packed_polynomial_h
+#define packed_polynomial_h
+
+#include "symbolic4.h"
+
+/// The highest degree of a packed polynomial
+#define PACKED_POLYNOMIAL_MAX_DEGREE 1024
+
+/**
+ 
+ @brief A rational coefficient
+ 
+ @details
+ The fraction is kept in lowest terms and only uses bignums if it
+ doesn't fit into native integers (see @c numeric_value). The bignums
+ are owned by the coefficient. Zero is stored as 0/1 with sign 1.
+ 
+ */
+typedef struct packed_coefficient {
+    int8_t sign;
+    numeric_value value;
+} packed_coefficient;
+
+/**
+ 
+ @brief A univariate polynomial with rational coefficients
+ 
+ @details
+ Unlike @c EXPI_POLYNOMIAL_SPARSE and @c EXPI_POLYNOMIAL_DENSE
+ expressions, the coefficients are stored in one contiguous array and
+ the arithmetic works on them directly without simplifying expression
+ trees. Every operation returns @c RETS_ERROR if a coefficient exceeds
+ @c BIGNUM_MAX_LIMBS, so that callers can fall back to the expression
+ representation.
+ 
+ */
+typedef struct packed_polynomial {
+    expression* variable; ///< The variable, which is owned by the polynomial
+    int16_t degree; ///< The degree (-1 for the zero polynomial)
+    packed_coefficient coefficients[]; ///< The coefficients, lowest power first
+} packed_polynomial;
+
+packed_polynomial* new_packed_polynomial(const expression* variable, int16_t degree);
+packed_polynomial* copy_packed_polynomial(const packed_polynomial* source);
+void free_packed_polynomial(packed_polynomial* source);
+return_status sparse_polynomial_to_packed_polynomial(packed_polynomial** result, const expression* source);
+expression* packed_polynomial_to_sparse_polynomial(const packed_polynomial* source);
+return_status packed_polynomial_add(packed_polynomial** result, const packed_polynomial* a, const packed_polynomial* b);
+return_status packed_polynomial_multiply(packed_polynomial** result, const packed_polynomial* a, const packed_polynomial* b);
+return_status packed_polynomial_divide(packed_polynomial** quotient, packed_polynomial** remainder, const packed_polynomial* a, const packed_polynomial* b);
+return_status packed_polynomial_make_monic(packed_polynomial* source);
+return_status packed_polynomial_gcd(packed_polynomial** gcd, const packed_polynomial* a, const packed_polynomial* b);
+return_status packed_polynomial_derivative(packed_polynomial** result, const packed_polynomial* source);
+
+#endif /* packed_polynomial_h */
@@ -151,11 +151,13 @@ void append_multiplication_if_necessary(expression* tokens) {
 
 uint8_t tokenize_buffer(expression* tokens, char* buffer) {
     
-    uint8_t i, j;
+    uint8_t i;
+    size_t j;
     char* lowercase_buffer = string_to_lower(buffer);
     char* lowercase_keyword = NULL;
     char* keyword_occurrence = NULL;
-    uint8_t keyword_occurrence_position;
+    size_t keyword_occurrence_position;
+    char symbol_name[2] = {'\0', '\0'};
     
     /* search for pi */
     while ((keyword_occurrence = strstr(lowercase_buffer, "pi")) != NULL) {
@@ -182,8 +184,8 @@ uint8_t tokenize_buffer(expression* tokens, char* buffer) {
     for (j = 0; j < keyword_occurrence_position; j++) {
         if (lowercase_buffer[j] != '~') {
             append_multiplication_if_necessary(tokens);
-            append_child(tokens, new_symbol(EXPI_SYMBOL, &buffer[j]));
-            tokens->children[tokens->child_count - 1]->value.symbolic[1] = '\0';
+            symbol_name[0] = buffer[j];
+            append_child(tokens, new_symbol(EXPI_SYMBOL, symbol_name));
         }
     }
     
@@ -198,9 +200,62 @@ uint8_t tokenize_buffer(expression* tokens, char* buffer) {
     
 }
 
+/**
+ 
+ @brief Converts a decimal number with too many digits for a
+ @c uintmax_t to a literal
+ 
+ @param[out] result The literal.
+ @param[in] source The digits, optionally with a decimal point.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the number exceeds
+ @c BIGNUM_MAX_LIMBS.
+ 
+ */
+uint8_t string_to_big_literal(expression** result, const char* source) {
+    
+    size_t i;
+    bool is_fraction = false;
+    bignum* numerator = new_bignum(0);
+    bignum* denominator = new_bignum(1);
+    bignum* temp;
+    
+    for (i = 0; isdigit(source[i]) || source[i] == '.'; i++) {
+        
+        if (source[i] == '.') {
+            is_fraction = true;
+            continue;
+        }
+        
+        temp = bignum_multiply_add(numerator, 10, source[i] - '0');
+        free_bignum(numerator);
+        numerator = temp;
+        
+        if (is_fraction && numerator != NULL) {
+            temp = bignum_multiply_add(denominator, 10, 0);
+            free_bignum(denominator);
+            denominator = temp;
+        }
+        
+        if (numerator == NULL || denominator == NULL) {
+            free_bignum(numerator);
+            free_bignum(denominator);
+            return set_error(ERRD_SYSTEM, ERRI_MAX_INT_VALUE_EXCEEDED, "");
+        }
+        
+    }
+    
+    *result = new_big_literal(1, numerator, denominator);
+    
+    return RETS_SUCCESS;
+    
+}
+
 uint8_t string_to_literal(expression** result, const char* source) {
     
-    uint8_t i = 0;
+    size_t i = 0;
+    uint8_t digits = 0;
     int8_t sign = 1;
     uintmax_t a = 0;
     uintmax_t b = 0;
@@ -214,7 +269,7 @@ uint8_t string_to_literal(expression** result, const char* source) {
     
     for ( ; isdigit(source[i]); i++) {
         a = 10 * a + (source[i] - '0');
-//        if (a > pow(2, sizeof(uintmax_t) * 8) / 10) return set_error(ERRD_SYSTEM, ERRI_MAX_INT_VALUE_EXCEEDED, "");
+        digits++;
     }
     
     if (source[i] == '.') {
@@ -222,12 +277,18 @@ uint8_t string_to_literal(expression** result, const char* source) {
         for (i = i + 1; isdigit(source[i]); i++) {
             b = 10 * b + (source[i] - '0');
             c *= 10;
+            digits++;
         }
         
         if (source[i] == '.') return set_error(ERRD_PARSER, ERRI_SYNTAX, "");
         
     }
     
+    /* Any number with at most this many digits fits into a uintmax_t */
+    if (digits > sizeof(uintmax_t) * 8 * 3 / 10) {
+        return string_to_big_literal(result, source + ((sign == -1) ? 1 : 0));
+    }
+    
     literal = new_literal(1, b, c);
     simplify(literal, false);
     literal->value.numeric.numerator += a * literal->value.numeric.denominator;
@@ -238,7 +299,7 @@ uint8_t string_to_literal(expression** result, const char* source) {
     
 }
 
-uint8_t tokenize_value_expression(expression* tokens, uint8_t* index, const char* source) {
+uint8_t tokenize_value_expression(expression* tokens, size_t* index, const char* source) {
     
     expression_identifier identifier = get_value_identifier(source[*index]);
     expression* literal;
@@ -246,6 +307,7 @@ uint8_t tokenize_value_expression(expression* tokens, uint8_t* index, const char
     uint8_t buffer_position = 0;
     
     while (get_value_identifier(source[*index]) == identifier) {
+        if (buffer_position == sizeof(buffer) - 1) return set_error(ERRD_PARSER, ERRI_MAX_INT_VALUE_EXCEEDED, "");
         buffer[buffer_position++] = source[(*index)++];
     }
     
@@ -292,7 +354,7 @@ void tokenize_control_expression(expression* tokens, char source) {
 
 uint8_t tokenize(expression* tokens, const char* query) {
     
-    uint8_t i;
+    size_t i;
     
     for (i = 0; query[i] != '\0'; i++) {
         
@@ -312,6 +374,8 @@ uint8_t tokenize(expression* tokens, const char* query) {
                 return set_error(ERRD_PARSER, ERRI_UNEXPECTED_CHARACTER, "");
         }
         
+        if (current_context->error.identifier == ERRI_MAX_CHILD_COUNT_EXCEEDED) return RETS_ERROR;
+        
     }
     
     return RETS_SUCCESS;
@@ -320,10 +384,12 @@ uint8_t tokenize(expression* tokens, const char* query) {
 
 uint8_t validate(expression* tokens) {
     
-    uint8_t i;
-    int8_t open_parentheses = 0;
+    uint16_t i;
+    int32_t open_parentheses = 0;
     expression* tuple[2];
     
+    if (tokens->child_count == 0) return set_error(ERRD_SYNTAX, ERRI_SYNTAX, "");
+    
     tuple[1] = tokens->children[0];
     
     for (i = 0; i < tokens->child_count; i++) {
@@ -374,8 +440,8 @@ uint8_t validate(expression* tokens) {
 
 void merge_expressions_with_operator(expression* output_stack, expression* operator_stack) {
     
-    uint8_t i;
-    uint8_t child_count = 0;
+    uint16_t i;
+    uint16_t child_count = 0;
     
     switch (operator_stack->children[operator_stack->child_count - 1]->type) {
         case EXPT_OPERATION:
@@ -408,7 +474,7 @@ void merge_expressions_with_operator(expression* output_stack, expression* opera
     
 }
 
-void parse_control_expression(expression* tokens, uint8_t* index, expression* output_stack, expression* operator_stack) {
+void parse_control_expression(expression* tokens, uint16_t* index, expression* output_stack, expression* operator_stack) {
     
     switch (tokens->children[*index]->identifier) {
             
@@ -450,7 +516,7 @@ void parse_control_expression(expression* tokens, uint8_t* index, expression* ou
 
 void parse(expression* tokens) {
     
-    uint8_t i;
+    uint16_t i;
     expression* output_stack = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
     expression* operator_stack = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
     
@@ -492,7 +558,8 @@ void parse(expression* tokens) {
         merge_expressions_with_operator(output_stack, operator_stack);
     }
     
-    *tokens = *copy_expression(output_stack->children[0]);
+    tokens->child_count = 0;
+    replace_expression(tokens, copy_expression(output_stack->children[0]));
     
     free_expression(output_stack, false);
     free_expression(operator_stack, false);
@@ -28,6 +28,7 @@
 
 #include "symbolic4.h"
 
+uint8_t string_to_big_literal(expression** result, const char* source);
 uint8_t string_to_literal(expression** result, const char* source);
 uint8_t tokenize(expression* tokens, const char* query);
 uint8_t validate(expression* tokens);
@@ -29,6 +29,7 @@ return_status expression_to_sparse_polynomial(expression* source, const expressi
 void sparse_polynomial_to_expression(expression* source);
 return_status sparse_polynomial_to_dense_polynomial(expression* source);
 void dense_polynomial_to_sparse_polynomial(expression* source);
+return_status sparse_polynomials_to_packed_polynomials(packed_polynomial** a_result, packed_polynomial** b_result, const expression* a, const expression* b);
 
 void any_expression_to_expression(expression* source) {
     if (source->identifier == EXPI_POLYNOMIAL_SPARSE) {
@@ -42,7 +43,7 @@ void any_expression_to_expression(expression* source) {
 }
 
 void any_expression_to_expression_recursive(expression* source) {
-    uint8_t i;
+    uint16_t i;
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == NULL) continue;
         any_expression_to_expression_recursive(source->children[i]);
@@ -81,7 +82,7 @@ return_status any_expression_to_dense_polynomial(expression* source, const expre
 
 return_status validate_sparse_polynomial(expression* source, bool allow_decimal_exponents, bool allow_negative_exponents, bool allow_arbitrary_base) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp_base = NULL;
     
     for (i = 0; i < source->child_count; i++) {
@@ -96,9 +97,16 @@ return_status validate_sparse_polynomial(expression* source, bool allow_decimal_
     for (i = 0; i < source->child_count; i++) {
         
         if (source->children[i]->children[2] == NULL) {
+            invalidate_summary(source->children[i]);
             source->children[i]->children[2] = copy_expression(temp_base);
         }
         
+        if (source->children[i]->children[0]->identifier == EXPI_LITERAL &&
+            literal_is_big(source->children[i]->children[0])) {
+            free_expression(temp_base, false);
+            return RETS_ERROR;
+        }
+        
         if (source->children[i]->children[0]->identifier == EXPI_LITERAL &&
             source->children[i]->children[0]->value.numeric.denominator != 1 &&
             !allow_decimal_exponents) {
@@ -133,35 +141,42 @@ return_status validate_sparse_polynomial(expression* source, bool allow_decimal_
 
 void sort_sparse_polynomial(expression* source) {
     
-    uint8_t i, j;
-    uint8_t hightest_exponent_index = 0;
+    uint16_t i, j;
+    uint16_t hightest_exponent_index = 0;
     double hightest_exponent_value;
+    double* exponents = smart_alloc(source->child_count + 1, sizeof(double));
     expression* result = new_expression(EXPT_STRUCTURE, EXPI_POLYNOMIAL_SPARSE, 0);
     
+    for (i = 0; i < source->child_count; i++) {
+        exponents[i] = literal_to_double(source->children[i]->children[0]);
+    }
+    
     for (i = 0; i < source->child_count; i++) {
         
         hightest_exponent_value = -1000000;
         
         for (j = 0; j < source->child_count; j++) {
             if (source->children[j] == NULL) continue;
-            if (literal_to_double(source->children[j]->children[0]) >= hightest_exponent_value) {
+            if (exponents[j] >= hightest_exponent_value) {
                 hightest_exponent_index = j;
-                hightest_exponent_value = literal_to_double(source->children[j]->children[0]);
+                hightest_exponent_value = exponents[j];
             }
         }
         
         append_child(result, source->children[hightest_exponent_index]);
+        invalidate_summary(source);
         source->children[hightest_exponent_index] = NULL;
         
     }
     
+    smart_free(exponents);
     replace_expression(source, result);
     
 }
 
 void expression_to_sparse_polynomial_term(expression* source, const expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result;
     
     if (count_occurrences(source, copy_expression(variable), false) == 0) {
@@ -184,6 +199,7 @@ void expression_to_sparse_polynomial_term(expression* source, const expression*
             if (source->children[i] == NULL) continue;
             if (count_occurrences(source->children[i], copy_expression(variable), false) == 0) {
                 append_child(result->children[1], source->children[i]);
+                invalidate_summary(source);
                 source->children[i] = NULL;
             }
         }
@@ -207,7 +223,7 @@ void expression_to_sparse_polynomial_term(expression* source, const expression*
 
 return_status expression_to_sparse_polynomial(expression* source, const expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp_source = copy_expression(source);
     expression* temp_variable;
     expression* result;
@@ -252,7 +268,7 @@ return_status expression_to_sparse_polynomial(expression* source, const expressi
 
 void sparse_polynomial_to_expression(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
     
     for (i = 0; i < source->child_count; i++) {
@@ -270,7 +286,7 @@ void sparse_polynomial_to_expression(expression* source) {
 
 return_status sparse_polynomial_to_dense_polynomial(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result = new_expression(EXPT_STRUCTURE, EXPI_POLYNOMIAL_DENSE, 2,
                                         copy_expression(source->children[0]->children[2]),
                                         new_expression(EXPT_STRUCTURE, EXPI_LIST, 0));
@@ -299,7 +315,7 @@ return_status sparse_polynomial_to_dense_polynomial(expression* source) {
 
 void dense_polynomial_to_sparse_polynomial(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result = new_expression(EXPT_STRUCTURE, EXPI_POLYNOMIAL_SPARSE, 0);
     
     for (i = 0; i < source->children[1]->child_count; i++) {
@@ -382,7 +398,7 @@ void quadratic_formula(expression** result, expression* a, expression* b, expres
 
 return_status polysolve_quadratic(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp_source = copy_expression(source->children[0]);
     expression* temp;
     expression* result;
@@ -405,7 +421,7 @@ return_status polysolve_quadratic(expression* source) {
     simplify(temp, true);
     
     if (temp->sign != 1) return RETS_ERROR;
-    if (literal_to_double(temp) != 2) return RETS_ERROR;
+    if (!literal_equals(temp, 2)) return RETS_ERROR;
     
     free_expression(temp, true);
     
@@ -464,6 +480,35 @@ return_status polysolve(expression* source, expression* variable) {
     
 }
 
+/**
+ 
+ @brief Converts two sparse polynomials into packed polynomials in the
+ same variable
+ 
+ @details
+ On failure, both results are @c NULL and the callers fall back to
+ operating on the expressions.
+ 
+ */
+return_status sparse_polynomials_to_packed_polynomials(packed_polynomial** a_result, packed_polynomial** b_result, const expression* a, const expression* b) {
+    
+    *b_result = NULL;
+    
+    if (sparse_polynomial_to_packed_polynomial(a_result, a) == RETS_SUCCESS &&
+        sparse_polynomial_to_packed_polynomial(b_result, b) == RETS_SUCCESS &&
+        expressions_are_identical((*a_result)->variable, (*b_result)->variable, true)) {
+        return RETS_SUCCESS;
+    }
+    
+    free_packed_polynomial(*a_result);
+    free_packed_polynomial(*b_result);
+    *a_result = NULL;
+    *b_result = NULL;
+    
+    return RETS_ERROR;
+    
+}
+
 uint8_t poly_div(expression** quotient, expression** remainder, const expression* a, const expression* b, int8_t degree) {
     
     expression* symbol;
@@ -477,6 +522,10 @@ uint8_t poly_div(expression** quotient, expression** remainder, const expression
     expression* result;
     expression* temp_quotient;
     expression* temp_remainder;
+    packed_polynomial* a_packed;
+    packed_polynomial* b_packed;
+    packed_polynomial* packed_quotient;
+    packed_polynomial* packed_remainder;
     
     symbol = get_symbol(a);
     
@@ -491,6 +540,24 @@ uint8_t poly_div(expression** quotient, expression** remainder, const expression
         return RETS_ERROR;
     }
     
+    if (degree == -1 && sparse_polynomials_to_packed_polynomials(&a_packed, &b_packed, a_temp, b_temp) == RETS_SUCCESS) {
+        
+        if (packed_polynomial_divide(&packed_quotient, &packed_remainder, a_packed, b_packed) == RETS_SUCCESS) {
+            if (quotient != NULL) *quotient = packed_polynomial_to_sparse_polynomial(packed_quotient);
+            if (remainder != NULL) *remainder = packed_polynomial_to_sparse_polynomial(packed_remainder);
+            free_packed_polynomial(packed_quotient);
+            free_packed_polynomial(packed_remainder);
+            free_packed_polynomial(a_packed);
+            free_packed_polynomial(b_packed);
+            free_expressions(3, symbol, a_temp, b_temp);
+            return RETS_SUCCESS;
+        }
+        
+        free_packed_polynomial(a_packed);
+        free_packed_polynomial(b_packed);
+        
+    }
+    
     a_degree = (degree == -1) ? a_temp->children[0]->children[0]->value.numeric.numerator : degree;
     b_degree = b_temp->children[0]->children[0]->value.numeric.numerator;
     
@@ -526,7 +593,7 @@ uint8_t poly_div(expression** quotient, expression** remainder, const expression
         return RETS_ERROR;
     }
     
-    if (expressions_are_equivalent(result, new_literal(1, 0, 1), false)) {
+    if (is_equivalent(result, &literal_zero)) {
         
         if (quotient != NULL) *quotient = copy_expression(monomial);
         if (remainder != NULL) *remainder = new_literal(1, 0, 1);
@@ -569,7 +636,7 @@ bool poly_is_square_free(expression* source) {
     
     free_expression(temp_source, true);
     
-    if (expressions_are_equivalent(gcd, new_literal(1, 1, 1), false)) {
+    if (is_equivalent(gcd, &literal_one)) {
         return true;
     } else {
         return false;
@@ -579,11 +646,21 @@ bool poly_is_square_free(expression* source) {
 
 void make_monic(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result;
+    packed_polynomial* packed;
     
     any_expression_to_sparse_polynomial(source, NULL);
     
+    if (sparse_polynomial_to_packed_polynomial(&packed, source) == RETS_SUCCESS && packed->degree >= 0 &&
+        packed_polynomial_make_monic(packed) == RETS_SUCCESS) {
+        replace_expression(source, packed_polynomial_to_sparse_polynomial(packed));
+        free_packed_polynomial(packed);
+        return;
+    }
+    
+    free_packed_polynomial(packed);
+    
     result = new_expression(EXPT_STRUCTURE, EXPI_POLYNOMIAL_SPARSE, 0);
     
     for (i = 0; i < source->child_count; i++) {
@@ -608,13 +685,16 @@ uint8_t poly_gcd(expression** gcd, const expression* a, const expression* b) {
     expression* temp;
     expression* quotient;
     expression* remainder;
+    packed_polynomial* a_packed;
+    packed_polynomial* b_packed;
+    packed_polynomial* packed_gcd;
     
-    if (expressions_are_equivalent(a, new_literal(1, 0, 1), false)) {
+    if (is_equivalent(a, &literal_zero)) {
         *gcd = copy_expression(b);
         return RETS_SUCCESS;
     }
     
-    if (expressions_are_equivalent(b, new_literal(1, 0, 1), false)) {
+    if (is_equivalent(b, &literal_zero)) {
         *gcd = copy_expression(a);
         return RETS_SUCCESS;
     }
@@ -638,6 +718,22 @@ uint8_t poly_gcd(expression** gcd, const expression* a, const expression* b) {
     sort_sparse_polynomial(a_temp);
     sort_sparse_polynomial(b_temp);
     
+    if (sparse_polynomials_to_packed_polynomials(&a_packed, &b_packed, a_temp, b_temp) == RETS_SUCCESS) {
+        
+        if (packed_polynomial_gcd(&packed_gcd, a_packed, b_packed) == RETS_SUCCESS) {
+            *gcd = packed_polynomial_to_sparse_polynomial(packed_gcd);
+            free_packed_polynomial(packed_gcd);
+            free_packed_polynomial(a_packed);
+            free_packed_polynomial(b_packed);
+            free_expressions(3, symbol, a_temp, b_temp);
+            return RETS_SUCCESS;
+        }
+        
+        free_packed_polynomial(a_packed);
+        free_packed_polynomial(b_packed);
+        
+    }
+    
     if (expression_is_greater_than(b_temp->children[0]->children[0], a_temp->children[0]->children[0], true)) {
         temp = a_temp;
         a_temp = b_temp;
@@ -646,7 +742,7 @@ uint8_t poly_gcd(expression** gcd, const expression* a, const expression* b) {
     
     poly_div(&quotient, &remainder, a_temp, b_temp, -1);
     
-    if (expressions_are_equivalent(remainder, new_literal(1, 0, 1), false)) {
+    if (is_equivalent(remainder, &literal_zero)) {
         *gcd = copy_expression(b_temp);
     } else {
         poly_gcd(gcd, b_temp, remainder);
@@ -665,8 +761,26 @@ void poly_log_gcd(expression** gcd, const expression* source) {
     expression* symbol = get_symbol(source);
     expression* a = copy_expression(source);
     expression* a_derivative;
+    packed_polynomial* a_packed;
+    packed_polynomial* packed_derivative = NULL;
+    packed_polynomial* packed_gcd;
     
     any_expression_to_sparse_polynomial(a, symbol);
+    
+    if (sparse_polynomial_to_packed_polynomial(&a_packed, a) == RETS_SUCCESS &&
+        packed_polynomial_derivative(&packed_derivative, a_packed) == RETS_SUCCESS && packed_derivative->degree >= 0 &&
+        packed_polynomial_gcd(&packed_gcd, a_packed, packed_derivative) == RETS_SUCCESS) {
+        *gcd = packed_polynomial_to_sparse_polynomial(packed_gcd);
+        free_packed_polynomial(packed_gcd);
+        free_packed_polynomial(packed_derivative);
+        free_packed_polynomial(a_packed);
+        free_expressions(2, symbol, a);
+        return;
+    }
+    
+    free_packed_polynomial(packed_derivative);
+    free_packed_polynomial(a_packed);
+    
     derivative(&a_derivative, copy_expression(a), copy_expression(symbol), false);
     
     any_expression_to_sparse_polynomial(a_derivative, symbol);
@@ -695,7 +809,7 @@ uint8_t factor_square_free(expression** factors, const expression* source) {
     derivative(&b, a, symbol, true);
     poly_log_gcd(&c, a);
     
-    if (expressions_are_equivalent(c, new_literal(1, 1, 1), false)) {
+    if (is_equivalent(c, &literal_one)) {
         
         w = copy_expression(a);
         
@@ -710,12 +824,12 @@ uint8_t factor_square_free(expression** factors, const expression* source) {
                            temp);
         simplify(z, true);
         
-        while (!expressions_are_equivalent(z, new_literal(1, 0, 1), false)) {
+        while (!is_equivalent(z, &literal_zero)) {
             
             free_expression(g, false);
             poly_gcd(&g, w, z);
             
-            if (!expressions_are_equivalent(g, new_literal(1, 1, 1), false)) {
+            if (!is_equivalent(g, &literal_one)) {
                 append_child(*factors, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
                                                       copy_expression(g),
                                                       new_literal(1, i, 1)));
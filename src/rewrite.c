@@ -0,0 +1,392 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief The special values of the inverse trigonometric functions
+ 
+ @details
+ Patterns have to be written in normalized form, since they are
+ compared structurally with simplified arguments. Each value of
+ @c trigonometric_values appears with both signs.
+ 
+ */
+const rewrite_rule rewrite_rules[] = {
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_LITERAL(1, 0, 1)}, {REWRITE_LITERAL(1, 0, 1)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_SCALED_ROOT(-1, 1, 4, 2), REWRITE_SCALED_ROOT(1, 1, 4, 6)}, {REWRITE_PI_TIMES(1, 1, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_SCALED_ROOT(1, 1, 4, 2), REWRITE_SCALED_ROOT(-1, 1, 4, 6)}, {REWRITE_PI_TIMES(-1, 1, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 4), REWRITE_SCALED_ROOT(1, 1, 4, 5)}, {REWRITE_PI_TIMES(1, 1, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 4), REWRITE_SCALED_ROOT(-1, 1, 4, 5)}, {REWRITE_PI_TIMES(-1, 1, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_HALF, REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 2), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 1, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 6)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_LITERAL(-1, 1, 2)}, {REWRITE_PI_TIMES(-1, 1, 6)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 1, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_SCALED_ROOT(1, 1, 2, 2)}, {REWRITE_PI_TIMES(1, 1, 4)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_SCALED_ROOT(-1, 1, 2, 2)}, {REWRITE_PI_TIMES(-1, 1, 4)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 4), REWRITE_SCALED_ROOT(1, 1, 4, 5)}, {REWRITE_PI_TIMES(1, 3, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 4), REWRITE_SCALED_ROOT(-1, 1, 4, 5)}, {REWRITE_PI_TIMES(-1, 3, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_SCALED_ROOT(1, 1, 2, 3)}, {REWRITE_PI_TIMES(1, 1, 3)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_SCALED_ROOT(-1, 1, 2, 3)}, {REWRITE_PI_TIMES(-1, 1, 3)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_HALF, REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(2), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 3, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 2), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(2), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 3, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 2, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 2, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_SCALED_ROOT(1, 1, 4, 2), REWRITE_SCALED_ROOT(1, 1, 4, 6)}, {REWRITE_PI_TIMES(1, 5, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_ADDITION, REWRITE_SCALED_ROOT(-1, 1, 4, 2), REWRITE_SCALED_ROOT(-1, 1, 4, 6)}, {REWRITE_PI_TIMES(-1, 5, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_LITERAL(1, 1, 1)}, {REWRITE_PI_TIMES(1, 1, 2)}},
+    {{REWRITE_FUNCTION(EXPI_ARCSIN), REWRITE_LITERAL(-1, 1, 1)}, {REWRITE_PI_TIMES(-1, 1, 2)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_LITERAL(1, 0, 1)}, {REWRITE_PI_TIMES(1, 1, 2)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_SCALED_ROOT(-1, 1, 4, 2), REWRITE_SCALED_ROOT(1, 1, 4, 6)}, {REWRITE_PI_TIMES(1, 5, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_SCALED_ROOT(1, 1, 4, 2), REWRITE_SCALED_ROOT(-1, 1, 4, 6)}, {REWRITE_PI_TIMES(1, 7, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 4), REWRITE_SCALED_ROOT(1, 1, 4, 5)}, {REWRITE_PI_TIMES(1, 2, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 4), REWRITE_SCALED_ROOT(-1, 1, 4, 5)}, {REWRITE_PI_TIMES(1, 3, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_HALF, REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 3, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 2), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 5, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 3)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_LITERAL(-1, 1, 2)}, {REWRITE_PI_TIMES(1, 2, 3)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 3, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 7, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_SCALED_ROOT(1, 1, 2, 2)}, {REWRITE_PI_TIMES(1, 1, 4)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_SCALED_ROOT(-1, 1, 2, 2)}, {REWRITE_PI_TIMES(1, 3, 4)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 4), REWRITE_SCALED_ROOT(1, 1, 4, 5)}, {REWRITE_PI_TIMES(1, 1, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 4), REWRITE_SCALED_ROOT(-1, 1, 4, 5)}, {REWRITE_PI_TIMES(1, 4, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_SCALED_ROOT(1, 1, 2, 3)}, {REWRITE_PI_TIMES(1, 1, 6)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_SCALED_ROOT(-1, 1, 2, 3)}, {REWRITE_PI_TIMES(1, 5, 6)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_HALF, REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(2), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 2), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(2), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 7, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 9, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_SCALED_ROOT(1, 1, 4, 2), REWRITE_SCALED_ROOT(1, 1, 4, 6)}, {REWRITE_PI_TIMES(1, 1, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_ADDITION, REWRITE_SCALED_ROOT(-1, 1, 4, 2), REWRITE_SCALED_ROOT(-1, 1, 4, 6)}, {REWRITE_PI_TIMES(1, 11, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_LITERAL(1, 1, 1)}, {REWRITE_LITERAL(1, 0, 1)}},
+    {{REWRITE_FUNCTION(EXPI_ARCCOS), REWRITE_LITERAL(-1, 1, 1)}, {REWRITE_PI}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_LITERAL(1, 0, 1)}, {REWRITE_LITERAL(1, 0, 1)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 3)}, {REWRITE_PI_TIMES(1, 1, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(-1, 2, 1), REWRITE_ROOT(3)}, {REWRITE_PI_TIMES(-1, 1, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 5), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 25, 1), REWRITE_SCALED_ROOT(-1, 10, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 5), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 25, 1), REWRITE_SCALED_ROOT(-1, 10, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 1, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 1), REWRITE_ROOT(2)}, {REWRITE_PI_TIMES(1, 1, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2)}, {REWRITE_PI_TIMES(-1, 1, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_SCALED_ROOT(1, 1, 3, 3)}, {REWRITE_PI_TIMES(1, 1, 6)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_SCALED_ROOT(-1, 1, 3, 3)}, {REWRITE_PI_TIMES(-1, 1, 6)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 5, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 1, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 1), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 5, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 1, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_LITERAL(1, 1, 1)}, {REWRITE_PI_TIMES(1, 1, 4)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_LITERAL(-1, 1, 1)}, {REWRITE_PI_TIMES(-1, 1, 4)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 5), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 25, 1), REWRITE_SCALED_ROOT(1, 10, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 3, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 5), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 25, 1), REWRITE_SCALED_ROOT(1, 10, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 3, 10)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ROOT(3)}, {REWRITE_PI_TIMES(1, 1, 3)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_SCALED_ROOT(-1, 1, 1, 3)}, {REWRITE_PI_TIMES(-1, 1, 3)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 1), REWRITE_ROOT(2)}, {REWRITE_PI_TIMES(1, 3, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2)}, {REWRITE_PI_TIMES(-1, 3, 8)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 5, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(1, 2, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_MULTIPLICATION, REWRITE_LITERAL(-1, 1, 1), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 5, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}, {REWRITE_PI_TIMES(-1, 2, 5)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(3)}, {REWRITE_PI_TIMES(1, 5, 12)}},
+    {{REWRITE_FUNCTION(EXPI_ARCTAN), REWRITE_ADDITION, REWRITE_LITERAL(-1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 3)}, {REWRITE_PI_TIMES(-1, 5, 12)}}
+};
+
+#define REWRITE_RULE_COUNT (sizeof(rewrite_rules) / sizeof(rewrite_rule))
+
+bool rewrite_keys_are_equal(const rewrite_key* a, const rewrite_key* b);
+void get_rewrite_key(rewrite_key* result, const expression* source);
+int16_t find_rewrite_node(const rewrite_index* index, int16_t first, const rewrite_key* key);
+int16_t insert_rewrite_node(rewrite_index* index, int16_t parent, const rewrite_key* key);
+int16_t match_rewrite_subtree(const rewrite_index* index, int16_t first, const expression* source);
+expression* build_expression_from_keys(const rewrite_key* keys, uint8_t* position);
+
+bool rewrite_keys_are_equal(const rewrite_key* a, const rewrite_key* b) {
+    return a->type == b->type &&
+           a->identifier == b->identifier &&
+           a->sign == b->sign &&
+           a->child_count == b->child_count &&
+           a->numerator == b->numerator &&
+           a->denominator == b->denominator;
+}
+
+/**
+ 
+ @brief Computes the key of a single node
+ 
+ @details
+ Zero is keyed with a positive sign. Big literals hold @c UINTMAX_MAX
+ in their native fields and thus never match a pattern.
+ 
+ */
+void get_rewrite_key(rewrite_key* result, const expression* source) {
+    
+    result->type = source->type;
+    result->identifier = source->identifier;
+    result->sign = source->sign;
+    result->child_count = source->child_count;
+    result->numerator = 0;
+    result->denominator = 0;
+    
+    if (source->identifier == EXPI_LITERAL) {
+        result->numerator = source->value.numeric.numerator;
+        result->denominator = source->value.numeric.denominator;
+        if (result->numerator == 0) result->sign = 1;
+    } else if (source->identifier == EXPI_SYMBOL || source->identifier == EXPI_VARIABLE) {
+        result->numerator = source->value.symbol;
+    }
+    
+}
+
+int16_t find_rewrite_node(const rewrite_index* index, int16_t first, const rewrite_key* key) {
+    
+    int16_t i;
+    
+    for (i = first; i >= 0; i = index->nodes[i].next_sibling) {
+        if (rewrite_keys_are_equal(&index->nodes[i].key, key)) return i;
+    }
+    
+    return -1;
+    
+}
+
+/**
+ 
+ @brief Returns the child of a node with the given key, inserting it
+ if necessary
+ 
+ @details
+ A parent of -1 denotes the roots of the identifier of the key. The
+ parent is passed as an index, since inserting may move the nodes.
+ 
+ */
+int16_t insert_rewrite_node(rewrite_index* index, int16_t parent, const rewrite_key* key) {
+    
+    int16_t result;
+    int16_t* first = (parent < 0) ? &index->roots[key->identifier] : &index->nodes[parent].first_child;
+    
+    result = find_rewrite_node(index, *first, key);
+    if (result >= 0) return result;
+    
+    if (index->node_count == index->node_capacity) {
+        index->node_capacity = (index->node_capacity == 0) ? 64 : 2 * index->node_capacity;
+        index->nodes = realloc(index->nodes, index->node_capacity * sizeof(rewrite_node));
+        if (index->nodes == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+        first = (parent < 0) ? &index->roots[key->identifier] : &index->nodes[parent].first_child;
+    }
+    
+    result = (int16_t) index->node_count++;
+    index->nodes[result].key = *key;
+    index->nodes[result].first_child = -1;
+    index->nodes[result].next_sibling = *first;
+    index->nodes[result].replacement = -1;
+    *first = result;
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Allocates a context's rewrite rules and compiles them into a
+ discrimination tree
+ 
+ @warning
+ - If the memory allocation fails, @c set_handle_unrecoverable_error() is
+ called.
+ 
+ @return
+ - The compiled rules.
+ 
+ @see
+ - free_rewrite_index()
+ 
+ */
+rewrite_index* new_rewrite_index(void) {
+    
+    uint16_t i;
+    rewrite_index* index = calloc(1, sizeof(rewrite_index));
+    
+    if (index == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    for (i = 0; i <= EXPI_PARSE; i++) index->roots[i] = -1;
+    
+    for (i = 0; i < REWRITE_RULE_COUNT; i++) {
+        add_rewrite_rule(index, rewrite_rules[i].pattern, rewrite_rules[i].replacement);
+    }
+    
+    return index;
+    
+}
+
+void free_rewrite_index(rewrite_index* index) {
+    if (index == NULL) return;
+    free(index->nodes);
+    free(index->replacements);
+    free(index);
+}
+
+/**
+ 
+ @brief Inserts a rule into the discrimination tree
+ 
+ @details
+ The keys of the pattern are inserted along a path of the tree. A
+ rule with the same pattern as an earlier one is ignored.
+ 
+ @param[in,out] index The compiled rules.
+ @param[in] pattern The pattern in normalized form (the first key
+ determines the root).
+ @param[in] replacement The replacement.
+ 
+ */
+void add_rewrite_rule(rewrite_index* index, const rewrite_key* pattern, const rewrite_key* replacement) {
+    
+    uint8_t i;
+    uint8_t count = count_rewrite_keys(pattern);
+    int16_t node = -1;
+    
+    for (i = 0; i < count; i++) node = insert_rewrite_node(index, node, &pattern[i]);
+    
+    if (index->nodes[node].replacement >= 0) return;
+    
+    count = count_rewrite_keys(replacement);
+    
+    if (index->replacement_count + count > index->replacement_capacity) {
+        index->replacement_capacity = (index->replacement_capacity == 0) ? 128 : 2 * index->replacement_capacity;
+        index->replacements = realloc(index->replacements, index->replacement_capacity * sizeof(rewrite_key));
+        if (index->replacements == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    }
+    
+    index->nodes[node].replacement = (int16_t) index->replacement_count;
+    memcpy(&index->replacements[index->replacement_count], replacement, count * sizeof(rewrite_key));
+    index->replacement_count += count;
+    
+}
+
+/**
+ 
+ @brief Returns the number of keys of the subtree which starts with
+ the first key
+ 
+ */
+uint8_t count_rewrite_keys(const rewrite_key* keys) {
+    
+    uint8_t i;
+    uint16_t remaining = 1;
+    
+    for (i = 0; remaining > 0; i++) remaining += keys[i].child_count - 1;
+    
+    return i;
+    
+}
+
+expression* build_expression_from_keys(const rewrite_key* keys, uint8_t* position) {
+    
+    uint8_t i;
+    const rewrite_key* key = &keys[(*position)++];
+    expression* result;
+    
+    if (key->identifier == EXPI_LITERAL) return new_literal(key->sign, key->numerator, key->denominator);
+    
+    result = new_expression_with_capacity(key->type, key->identifier, key->child_count);
+    
+    if (key->identifier == EXPI_SYMBOL || key->identifier == EXPI_VARIABLE) {
+        result->value.symbol = (uint32_t) key->numerator;
+    } else {
+        for (i = 0; i < key->child_count; i++) append_child(result, build_expression_from_keys(keys, position));
+    }
+    
+    return result;
+    
+}
+
+/**
+ 
+ @brief Builds the expression spelled by a preorder sequence of keys
+ 
+ */
+expression* new_expression_from_keys(const rewrite_key* keys) {
+    uint8_t position = 0;
+    return build_expression_from_keys(keys, &position);
+}
+
+/**
+ 
+ @brief Follows the keys of a subtree in preorder through the
+ discrimination tree
+ 
+ @param[in] index The compiled rules.
+ @param[in] first The first candidate for the root of the subtree.
+ @param[in] source The subtree.
+ 
+ @return
+ - The node reached after the last key of the subtree or -1 if no
+ pattern continues with the subtree.
+ 
+ */
+int16_t match_rewrite_subtree(const rewrite_index* index, int16_t first, const expression* source) {
+    
+    uint16_t i;
+    int16_t node;
+    rewrite_key key;
+    
+    if (source == NULL) return -1;
+    
+    get_rewrite_key(&key, source);
+    node = find_rewrite_node(index, first, &key);
+    
+    for (i = 0; i < source->child_count && node >= 0; i++) {
+        node = match_rewrite_subtree(index, index->nodes[node].first_child, source->children[i]);
+    }
+    
+    return node;
+    
+}
+
+/**
+ 
+ @brief Rewrites an expression with the rule whose pattern matches it
+ 
+ @details
+ The children of @c source have to be normalized. All rules are
+ matched in a single traversal of @c source, without any further
+ simplification. Sets @c changed of the current context if the
+ expression was rewritten.
+ 
+ @param[in,out] source The expression.
+ 
+ */
+void apply_rewrite_rules(expression* source) {
+    
+    int16_t node;
+    rewrite_index* index = current_context->rewrite_index;
+    
+    if (index->roots[source->identifier] < 0) return;
+    
+    node = match_rewrite_subtree(index, index->roots[source->identifier], source);
+    if (node < 0 || index->nodes[node].replacement < 0) return;
+    
+    replace_expression(source, new_expression_from_keys(&index->replacements[index->nodes[node].replacement]));
+    current_context->changed = true;
+    
+}
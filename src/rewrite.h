@@ -0,0 +1,117 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef rewrite_h
+#define rewrite_h
+
+#include "symbolic4.h"
+
+#define REWRITE_LITERAL(sign, numerator, denominator) {EXPT_VALUE, EXPI_LITERAL, sign, 0, numerator, denominator}
+#define REWRITE_PI {EXPT_VALUE, EXPI_SYMBOL, 1, 0, SYMBOL_PI, 0}
+#define REWRITE_OPERATION(identifier, child_count) {EXPT_OPERATION, identifier, 1, child_count, 0, 0}
+#define REWRITE_FUNCTION(identifier) {EXPT_FUNCTION, identifier, 1, 1, 0, 0}
+#define REWRITE_ADDITION REWRITE_OPERATION(EXPI_ADDITION, 2)
+#define REWRITE_MULTIPLICATION REWRITE_OPERATION(EXPI_MULTIPLICATION, 2)
+#define REWRITE_EXPONENTATION REWRITE_OPERATION(EXPI_EXPONENTATION, 2)
+#define REWRITE_HALF REWRITE_LITERAL(1, 1, 2)
+
+/// <tt>(sign * numerator / denominator) * pi</tt>
+#define REWRITE_PI_TIMES(sign, numerator, denominator) REWRITE_MULTIPLICATION, REWRITE_LITERAL(sign, numerator, denominator), REWRITE_PI
+/// <tt>radicand ^ (1 / 2)</tt>
+#define REWRITE_ROOT(radicand) REWRITE_EXPONENTATION, REWRITE_LITERAL(1, radicand, 1), REWRITE_HALF
+/// <tt>(sign * numerator / denominator) * radicand ^ (1 / 2)</tt>
+#define REWRITE_SCALED_ROOT(sign, numerator, denominator, radicand) REWRITE_MULTIPLICATION, REWRITE_LITERAL(sign, numerator, denominator), REWRITE_ROOT(radicand)
+
+/**
+ 
+ @brief One node of a pattern or replacement in preorder
+ 
+ @details
+ The child count makes a preorder sequence of keys self-delimiting.
+ 
+ */
+typedef struct rewrite_key {
+    expression_type type;
+    expression_identifier identifier;
+    int8_t sign;
+    uint8_t child_count;
+    uintmax_t numerator; ///< The numerator of a literal or the id of a symbol
+    uintmax_t denominator;
+} rewrite_key;
+
+/**
+ 
+ @brief A rewrite rule
+ 
+ @details
+ The pattern is matched against the normalized form of an expression.
+ 
+ */
+typedef struct rewrite_rule {
+    rewrite_key pattern[REWRITE_MAX_KEYS];
+    rewrite_key replacement[REWRITE_MAX_KEYS];
+} rewrite_rule;
+
+/**
+ 
+ @brief A node of the discrimination tree
+ 
+ */
+typedef struct rewrite_node {
+    rewrite_key key;
+    int16_t first_child;
+    int16_t next_sibling;
+    int16_t replacement; ///< The offset of the replacement of the pattern which ends at this node (-1 for none)
+} rewrite_node;
+
+/**
+ 
+ @brief The rewrite rules of a context compiled into a discrimination
+ tree
+ 
+ @details
+ Every path from a root to a node with a replacement spells the
+ pattern of a rule in preorder, so an expression is matched against
+ all rules in a single traversal.
+ 
+ */
+typedef struct rewrite_index {
+    rewrite_node* nodes;
+    uint16_t node_count;
+    uint16_t node_capacity;
+    rewrite_key* replacements; ///< The keys of all replacements, one after another
+    uint16_t replacement_count;
+    uint16_t replacement_capacity;
+    int16_t roots[EXPI_PARSE + 1]; ///< The first root for each identifier (-1 if no rule applies)
+} rewrite_index;
+
+rewrite_index* new_rewrite_index(void);
+void free_rewrite_index(rewrite_index* index);
+void add_rewrite_rule(rewrite_index* index, const rewrite_key* pattern, const rewrite_key* replacement);
+uint8_t count_rewrite_keys(const rewrite_key* keys);
+expression* new_expression_from_keys(const rewrite_key* keys);
+void apply_rewrite_rules(expression* source);
+
+#endif /* rewrite_h */
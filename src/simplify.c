@@ -25,24 +25,37 @@
 
 #include "symbolic4.h"
 
-bool changed = false;
+#define APPROXIMATE_OPERATORS (SUMMARY_OPERATOR_BIT(EXPI_ADDITION) | SUMMARY_OPERATOR_BIT(EXPI_MULTIPLICATION) | SUMMARY_OPERATOR_BIT(EXPI_EXPONENTATION) | SUMMARY_OPERATOR_BIT(EXPI_LN) | SUMMARY_OPERATOR_BIT(EXPI_LOG) | SUMMARY_OPERATOR_BIT(EXPI_SIN) | SUMMARY_OPERATOR_BIT(EXPI_COS) | SUMMARY_OPERATOR_BIT(EXPI_TAN) | SUMMARY_OPERATOR_BIT(EXPI_ARCSIN) | SUMMARY_OPERATOR_BIT(EXPI_ARCCOS) | SUMMARY_OPERATOR_BIT(EXPI_ARCTAN))
 
 void simplify_literal(expression* source);
+bool expression_is_normalized(const expression* source);
+uint8_t simplify_node(expression* source, bool recursive);
+uint8_t simplify_memoized(expression* source, bool recursive);
+uint8_t simplify_subtree(expression* source, bool recursive, bool is_memoized);
 
 void merge_additions_multiplications(expression* source);
+uint8_t native_numeric_addition(expression** result, const expression* a, const expression* b);
+expression* big_numeric_addition(const expression* a, const expression* b);
 uint8_t numeric_addition(expression** result, expression* a, expression* b, bool persistent);
-uint8_t symbolic_addition(expression** result, expression* a, expression* b, bool persistent);
+uint8_t term_factor_start(const expression* source);
+uint32_t term_key_hash(const expression* source);
+bool term_keys_are_equal(const expression* a, const expression* b);
+void collect_like_terms(expression* source);
 void evaluate_addition(expression* source);
 void simplify_addition(expression* source);
 
+expression* big_numeric_multiplication(const expression* a, const expression* b);
 uint8_t numeric_multiplication(expression** result, expression* a, expression* b, bool persistent);
-uint8_t symbolic_multiplication(expression** result, expression* a, expression* b, bool persistent);
+expression* power_base(const expression* source);
+void collect_like_bases(expression* source);
 void evaluate_multiplication(expression* source);
 uint8_t expand_multiplication(expression* source);
 void simplify_multiplication(expression* source);
 
 uint8_t expand_exponentation_base(expression* source);
 uint8_t expand_exponentation_exponent(expression* source);
+uint8_t big_numeric_part_power(bignum** factor, bignum** remainder, uintmax_t value, const bignum* big_value, uintmax_t numerator, uintmax_t degree);
+uint8_t big_numeric_exponentation(expression** factor, expression** remainder, const expression* base, const expression* exponent);
 uint8_t numeric_exponentation(expression* source);
 uint8_t symbolic_exponentation(expression* source);
 return_status evaluate_exponentation(expression* source);
@@ -50,15 +63,16 @@ return_status simplify_exponentation(expression* source);
 
 void simplify_literal(expression* source) {
     uintmax_t gcd;
-    if (source->identifier != EXPI_LITERAL) return;
-    gcd = euclidean_gcd(source->value.numeric.numerator, source->value.numeric.denominator);
+    if (source->identifier != EXPI_LITERAL || literal_is_big(source)) return;
+    gcd = binary_gcd(source->value.numeric.numerator, source->value.numeric.denominator);
+    invalidate_summary(source);
     source->value.numeric.numerator /= gcd;
     source->value.numeric.denominator /= gcd;
 }
 
 void merge_additions_multiplications(expression* source) {
     
-    uint8_t i, j;
+    uint16_t i, j;
     expression_identifier identifier;
     expression* result;
     
@@ -88,45 +102,83 @@ void merge_additions_multiplications(expression* source) {
     
     replace_expression(source, result);
     
-    changed = true;
+    current_context->changed = true;
     
 }
 
-uint8_t numeric_addition(expression** result, expression* a, expression* b, bool persistent) {
+/**
+ 
+ @brief Adds two literals with native integers
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if the sum doesn't fit into a
+ @c uintmax_t (see @c rational_addition()).
+ 
+ */
+uint8_t native_numeric_addition(expression** result, const expression* a, const expression* b) {
     
-    numeric_value a_value;
-    numeric_value b_value;
-    uintmax_t temp_1;
-    uintmax_t temp_2;
-    uintmax_t temp_3;
+    numeric_value value;
+    int8_t sign;
     
-    if (a->identifier != EXPI_LITERAL || b->identifier != EXPI_LITERAL) return RETS_UNCHANGED;
+    ERROR_CHECK(rational_addition(&value, &sign, &a->value.numeric, a->sign, &b->value.numeric, b->sign));
     
-    a_value = a->value.numeric;
-    b_value = b->value.numeric;
+    *result = new_literal(sign, value.numerator, value.denominator);
     
-    if ((a->sign == 1 && b->sign == 1) || (a->sign == -1 && b->sign == -1)) {
-        
-        if (multiplication(&temp_1, a_value.numerator, b_value.denominator) == RETS_ERROR) return RETS_UNCHANGED;
-        if (multiplication(&temp_2, a_value.denominator, b_value.numerator) == RETS_ERROR) return RETS_UNCHANGED;
-        if (addition(&temp_1, temp_1, temp_2) == RETS_ERROR) return RETS_UNCHANGED;
-        
-        if (multiplication(&temp_2, a_value.denominator, b_value.denominator) == RETS_ERROR) return RETS_UNCHANGED;
-        
-        *result = new_literal(a->sign, temp_1, temp_2);
-        
-    } else {
-        
-        if (multiplication(&temp_1, a_value.numerator, b_value.denominator) == RETS_ERROR) return RETS_UNCHANGED;
-        if (multiplication(&temp_2, a_value.denominator, b_value.numerator) == RETS_ERROR) return RETS_UNCHANGED;
-        if (multiplication(&temp_3, a_value.denominator, b_value.denominator) == RETS_ERROR) return RETS_UNCHANGED;
-        
-        if (temp_1 > temp_2) {
-            *result = new_literal(a->sign, temp_1 - temp_2, temp_3);
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Adds two literals with bignums
+ 
+ @return
+ - The sum, or @c NULL if it exceeds @c BIGNUM_MAX_LIMBS.
+ 
+ */
+expression* big_numeric_addition(const expression* a, const expression* b) {
+    
+    int8_t sign = a->sign;
+    bignum* a_denominator = numeric_part_to_bignum(a->value.numeric.denominator, a->value.numeric.big_denominator);
+    bignum* b_denominator = numeric_part_to_bignum(b->value.numeric.denominator, b->value.numeric.big_denominator);
+    bignum* a_numerator = numeric_part_to_bignum(a->value.numeric.numerator, a->value.numeric.big_numerator);
+    bignum* b_numerator = numeric_part_to_bignum(b->value.numeric.numerator, b->value.numeric.big_numerator);
+    bignum* temp_1 = bignum_multiply(a_numerator, b_denominator);
+    bignum* temp_2 = bignum_multiply(b_numerator, a_denominator);
+    bignum* temp_3 = bignum_multiply(a_denominator, b_denominator);
+    bignum* numerator = NULL;
+    
+    free_bignum(a_denominator);
+    free_bignum(b_denominator);
+    free_bignum(a_numerator);
+    free_bignum(b_numerator);
+    
+    if (temp_1 != NULL && temp_2 != NULL) {
+        if (a->sign == b->sign) {
+            numerator = bignum_add(temp_1, temp_2);
+        } else if (bignum_compare(temp_1, temp_2) > 0) {
+            numerator = bignum_subtract(temp_1, temp_2);
         } else {
-            *result = new_literal(b->sign, temp_2 - temp_1, temp_3);
+            numerator = bignum_subtract(temp_2, temp_1);
+            sign = b->sign;
         }
-        
+    }
+    
+    if (numerator != NULL && numerator->length == 0) sign = 1;
+    
+    free_bignum(temp_1);
+    free_bignum(temp_2);
+    
+    return new_big_literal(sign, numerator, temp_3);
+    
+}
+
+uint8_t numeric_addition(expression** result, expression* a, expression* b, bool persistent) {
+    
+    if (a->identifier != EXPI_LITERAL || b->identifier != EXPI_LITERAL) return RETS_UNCHANGED;
+    
+    if (literal_is_big(a) || literal_is_big(b) || native_numeric_addition(result, a, b) == RETS_ERROR) {
+        if ((*result = big_numeric_addition(a, b)) == NULL) return RETS_UNCHANGED;
     }
     
     simplify_literal(*result);
@@ -136,96 +188,182 @@ uint8_t numeric_addition(expression** result, expression* a, expression* b, bool
         free_expression(b, false);
     }
     
-    changed = true;
+    current_context->changed = true;
     
     return RETS_CHANGED;
     
 }
 
-uint8_t symbolic_addition(expression** result, expression* a, expression* b, bool persistent) {
+uint8_t term_factor_start(const expression* source) {
+    return (source->identifier == EXPI_MULTIPLICATION && source->child_count > 1 && source->children[0]->identifier == EXPI_LITERAL) ? 1 : 0;
+}
+
+/**
+ 
+ @brief Hashes the non-numeric part of a term of an addition
+ 
+ @details
+ The key of a multiplication consists of its sign and its children
+ without the leading literal, every other term is its own key. Thus
+ 2 * x * y, x * y and -3 * x * y have the same key, just like 5 * x and
+ x.
+ 
+ */
+uint32_t term_key_hash(const expression* source) {
     
-    expression* a_temp;
-    expression* b_temp;
-    expression* a_factor;
-    expression* b_factor;
-    expression* temp;
+    uint16_t i;
+    uint32_t hash = 2166136261u;
     
-    if (a->identifier == EXPI_MULTIPLICATION && a->children[0]->identifier == EXPI_LITERAL) {
-        a_factor = copy_expression(a->children[0]);
-        a_temp = copy_expression(a);
-        remove_child_at_index(a_temp, 0);
-        simplify(a_temp, false);
-    } else {
-        a_temp = copy_expression(a);
-        a_factor = new_literal(1, 1, 1);
+    if (source->identifier != EXPI_MULTIPLICATION) return (((hash ^ 1) * 16777619u) ^ expression_hash(source)) * 16777619u;
+    
+    hash = (hash ^ (uint8_t) source->sign) * 16777619u;
+    
+    for (i = term_factor_start(source); i < source->child_count; i++) {
+        hash = (hash ^ expression_hash(source->children[i])) * 16777619u;
     }
     
-    if (b->identifier == EXPI_MULTIPLICATION && b->children[0]->identifier == EXPI_LITERAL) {
-        b_factor = copy_expression(b->children[0]);
-        b_temp = copy_expression(b);
-        remove_child_at_index(b_temp, 0);
-        simplify(b_temp, false);
-    } else {
-        b_temp = copy_expression(b);
-        b_factor = new_literal(1, 1, 1);
+    return hash;
+    
+}
+
+bool term_keys_are_equal(const expression* a, const expression* b) {
+    
+    uint16_t i;
+    uint8_t a_start = term_factor_start(a);
+    uint8_t b_start = term_factor_start(b);
+    uint16_t a_count = (a->identifier == EXPI_MULTIPLICATION) ? a->child_count - a_start : 1;
+    uint16_t b_count = (b->identifier == EXPI_MULTIPLICATION) ? b->child_count - b_start : 1;
+    int8_t a_sign = (a->identifier == EXPI_MULTIPLICATION) ? a->sign : 1;
+    int8_t b_sign = (b->identifier == EXPI_MULTIPLICATION) ? b->sign : 1;
+    
+    if (a_count != b_count || a_sign != b_sign) return false;
+    
+    for (i = 0; i < a_count; i++) {
+        if (!expressions_are_identical((a->identifier == EXPI_MULTIPLICATION) ? a->children[a_start + i] : a,
+                                       (b->identifier == EXPI_MULTIPLICATION) ? b->children[b_start + i] : (expression*) b,
+                                       true)) return false;
     }
     
-    if (expressions_are_identical(a_temp, b_temp, true)) {
-        numeric_addition(&temp, a_factor, b_factor, false);
-        *result = new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                 temp,
-                                 a_temp);
-        free_expression(b_temp, false);
-        changed = true;
-        return RETS_CHANGED;
-    } else {
-        free_expression(a_temp, false);
-        free_expression(b_temp, false);
-        free_expression(a_factor, false);
-        free_expression(b_factor, false);
-        return RETS_UNCHANGED;
+    return true;
+    
+}
+
+/**
+ 
+ @brief Collects like terms of an addition
+ 
+ @details
+ The terms are grouped by a hash of their non-numeric part (see
+ @c term_key_hash()) and the numeric coefficients of every group are
+ summed up, so an addition with n terms is collected in O(n) instead
+ of comparing every pair of terms. The collected terms replace the
+ first term of their group, the other ones are set to @c NULL.
+ 
+ @param[in,out] source The addition.
+ 
+ */
+void collect_like_terms(expression* source) {
+    
+    uint16_t i, j;
+    uint16_t head;
+    uint32_t slot;
+    uint32_t mask = 1;
+    uint16_t* table;
+    expression** sums;
+    expression* coefficient;
+    expression* temp;
+    expression* result;
+    
+    while (mask < 2 * (uint32_t) source->child_count) mask *= 2;
+    
+    table = smart_alloc(mask, sizeof(uint16_t));
+    sums = smart_alloc(source->child_count, sizeof(expression*));
+    mask--;
+    
+    for (i = 0; i < source->child_count; i++) {
+        
+        if (source->children[i] == NULL || source->children[i]->identifier == EXPI_LITERAL) continue;
+        
+        for (slot = term_key_hash(source->children[i]) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+            if (term_keys_are_equal(source->children[table[slot] - 1], source->children[i])) break;
+        }
+        
+        if (table[slot] == 0) {
+            table[slot] = i + 1;
+            continue;
+        }
+        
+        head = table[slot] - 1;
+        
+        if (sums[head] == NULL) {
+            sums[head] = term_factor_start(source->children[head]) ? copy_expression(source->children[head]->children[0]) : new_literal(1, 1, 1);
+        }
+        
+        coefficient = term_factor_start(source->children[i]) ? copy_expression(source->children[i]->children[0]) : new_literal(1, 1, 1);
+        
+        if (numeric_addition(&temp, sums[head], coefficient, true) == RETS_CHANGED) {
+            replace_expression(sums[head], temp);
+            free_expression(source->children[i], false);
+            source->children[i] = NULL;
+        }
+        
+        free_expression(coefficient, false);
+        
     }
     
+    for (i = 0; i < source->child_count; i++) {
+        
+        if (sums[i] == NULL) continue;
+        
+        if (source->children[i]->identifier == EXPI_MULTIPLICATION) {
+            result = new_expression_with_capacity(EXPT_OPERATION, EXPI_MULTIPLICATION, source->children[i]->child_count + 1);
+            append_child(result, sums[i]);
+            for (j = term_factor_start(source->children[i]); j < source->children[i]->child_count; j++) {
+                append_child(result, copy_expression(source->children[i]->children[j]));
+            }
+            result->sign = source->children[i]->sign;
+        } else {
+            result = new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
+                                    sums[i],
+                                    copy_expression(source->children[i]));
+        }
+        
+        replace_expression(source->children[i], result);
+        
+    }
+    
+    smart_free(table);
+    smart_free(sums);
+    
 }
 
 void evaluate_addition(expression* source) {
     
-    uint8_t i, j;
+    uint16_t i;
+    uint16_t literal_index = 0;
+    bool has_literal = false;
     expression* temp_result;
     expression* result;
     
     for (i = 0; i < source->child_count; i++) {
         
-        if (source->children[i] == NULL) continue;
+        if (source->children[i] == NULL || source->children[i]->identifier != EXPI_LITERAL) continue;
         
-        if (source->children[i]->identifier == EXPI_LITERAL && literal_to_double(source->children[i]) == 0) {
+        if (literal_equals(source->children[i], 0)) {
+            free_expression(source->children[i], false);
+            source->children[i] = NULL;
+        } else if (!has_literal) {
+            literal_index = i;
+            has_literal = true;
+        } else if (numeric_addition(&temp_result, source->children[literal_index], source->children[i], true) == RETS_CHANGED) {
+            replace_expression(source->children[literal_index], temp_result);
             free_expression(source->children[i], false);
             source->children[i] = NULL;
-        }
-        
-        for (j = i + 1; j < source->child_count; j++) {
-            
-            if (source->children[i] == NULL) continue;
-            if (source->children[j] == NULL) continue;
-            
-            if (numeric_addition(&temp_result, source->children[i], source->children[j], true) == RETS_CHANGED) {
-                replace_expression(source->children[i], temp_result);
-                free_expression(source->children[j], false);
-                source->children[j] = NULL;
-                continue;
-            }
-            
-            if (symbolic_addition(&temp_result, source->children[i], source->children[j], true) == RETS_CHANGED) {
-                replace_expression(source->children[i], temp_result);
-                free_expression(source->children[j], false);
-                source->children[j] = NULL;
-                continue;
-            }
-            
         }
         
     }
     
+    collect_like_terms(source);
     remove_null_children(source);
     
     switch (source->child_count) {
@@ -250,25 +388,51 @@ void simplify_subtraction(expression* source) {
                                               new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
                                                              new_literal(-1, 1, 1),
                                                              copy_expression(source->children[1]))));
-    changed = true;
+    current_context->changed = true;
+}
+
+/**
+ 
+ @brief Multiplies two literals with bignums
+ 
+ @return
+ - The product, or @c NULL if it exceeds @c BIGNUM_MAX_LIMBS.
+ 
+ */
+expression* big_numeric_multiplication(const expression* a, const expression* b) {
+    
+    bignum* a_part = numeric_part_to_bignum(a->value.numeric.numerator, a->value.numeric.big_numerator);
+    bignum* b_part = numeric_part_to_bignum(b->value.numeric.numerator, b->value.numeric.big_numerator);
+    bignum* numerator = bignum_multiply(a_part, b_part);
+    bignum* denominator;
+    
+    free_bignum(a_part);
+    free_bignum(b_part);
+    
+    a_part = numeric_part_to_bignum(a->value.numeric.denominator, a->value.numeric.big_denominator);
+    b_part = numeric_part_to_bignum(b->value.numeric.denominator, b->value.numeric.big_denominator);
+    denominator = bignum_multiply(a_part, b_part);
+    
+    free_bignum(a_part);
+    free_bignum(b_part);
+    
+    return new_big_literal(a->sign * b->sign, numerator, denominator);
+    
 }
 
 uint8_t numeric_multiplication(expression** result, expression* a, expression* b, bool persistent) {
     
-    numeric_value a_value;
-    numeric_value b_value;
-    uintmax_t temp_1;
-    uintmax_t temp_2;
+    numeric_value value;
     
     if (a->identifier != EXPI_LITERAL || b->identifier != EXPI_LITERAL) return RETS_UNCHANGED;
     
-    a_value = a->value.numeric;
-    b_value = b->value.numeric;
-    
-    if (multiplication(&temp_1, a_value.numerator, b_value.numerator) == RETS_ERROR) return RETS_UNCHANGED;
-    if (multiplication(&temp_2, b_value.denominator, a_value.denominator) == RETS_ERROR) return RETS_UNCHANGED;
+    if (literal_is_big(a) || literal_is_big(b) ||
+        rational_multiplication(&value, &a->value.numeric, &b->value.numeric) == RETS_ERROR) {
+        if ((*result = big_numeric_multiplication(a, b)) == NULL) return RETS_UNCHANGED;
+    } else {
+        *result = new_literal(a->sign * b->sign, value.numerator, value.denominator);
+    }
     
-    *result = new_literal(a->sign * b->sign, temp_1, temp_2);
     simplify_literal(*result);
     
     if (!persistent) {
@@ -276,98 +440,120 @@ uint8_t numeric_multiplication(expression** result, expression* a, expression* b
         free_expression(b, false);
     }
     
-    changed = true;
+    current_context->changed = true;
     
     return RETS_CHANGED;
     
 }
 
-uint8_t symbolic_multiplication(expression** result, expression* a, expression* b, bool persistent) {
-    
-    expression* a_temp;
-    expression* b_temp;
-    expression* a_exponent;
-    expression* b_exponent;
+expression* power_base(const expression* source) {
+    return (source->identifier == EXPI_EXPONENTATION && source->children[1]->identifier == EXPI_LITERAL) ? source->children[0] : (expression*) source;
+}
+
+/**
+ 
+ @brief Collects the powers of like bases in a multiplication
+ 
+ @details
+ Like @c collect_like_terms(), but the factors are grouped by the hash
+ of their base and the literal exponents of every group are summed up.
+ Factors without a literal exponent have the exponent 1.
+ 
+ @param[in,out] source The multiplication.
+ 
+ */
+void collect_like_bases(expression* source) {
+    
+    uint16_t i;
+    uint16_t head;
+    uint32_t slot;
+    uint32_t mask = 1;
+    uint16_t* table;
+    expression** sums;
+    expression* exponent;
     expression* temp;
     
-    if (a->identifier == EXPI_EXPONENTATION && a->children[1]->identifier == EXPI_LITERAL) {
-        a_temp = copy_expression(a->children[0]);
-        a_exponent = copy_expression(a->children[1]);
-    } else {
-        a_temp = copy_expression(a);
-        a_exponent = new_literal(1, 1, 1);
-    }
+    while (mask < 2 * (uint32_t) source->child_count) mask *= 2;
     
-    if (b->identifier == EXPI_EXPONENTATION && b->children[1]->identifier == EXPI_LITERAL) {
-        b_temp = copy_expression(b->children[0]);
-        b_exponent = copy_expression(b->children[1]);
-    } else {
-        b_temp = copy_expression(b);
-        b_exponent = new_literal(1, 1, 1);
+    table = smart_alloc(mask, sizeof(uint16_t));
+    sums = smart_alloc(source->child_count, sizeof(expression*));
+    mask--;
+    
+    for (i = 0; i < source->child_count; i++) {
+        
+        if (source->children[i] == NULL) continue;
+        
+        for (slot = expression_hash(power_base(source->children[i])) & mask; table[slot] != 0; slot = (slot + 1) & mask) {
+            if (expressions_are_identical(power_base(source->children[table[slot] - 1]), power_base(source->children[i]), true)) break;
+        }
+        
+        if (table[slot] == 0) {
+            table[slot] = i + 1;
+            continue;
+        }
+        
+        head = table[slot] - 1;
+        
+        if (sums[head] == NULL) {
+            sums[head] = (power_base(source->children[head]) != source->children[head]) ? copy_expression(source->children[head]->children[1]) : new_literal(1, 1, 1);
+        }
+        
+        exponent = (power_base(source->children[i]) != source->children[i]) ? copy_expression(source->children[i]->children[1]) : new_literal(1, 1, 1);
+        
+        if (numeric_addition(&temp, sums[head], exponent, true) == RETS_CHANGED) {
+            replace_expression(sums[head], temp);
+            free_expression(source->children[i], false);
+            source->children[i] = NULL;
+        }
+        
+        free_expression(exponent, false);
+        
     }
     
-    if (expressions_are_identical(a_temp, b_temp, true)) {
-        numeric_addition(&temp, a_exponent, b_exponent, false);
-        *result = new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                 a_temp,
-                                 temp);
-        free_expression(b_temp, false);
-        changed = true;
-        return RETS_CHANGED;
-    } else {
-        free_expression(a_temp, false);
-        free_expression(b_temp, false);
-        free_expression(a_exponent, false);
-        free_expression(b_exponent, false);
-        return RETS_UNCHANGED;
+    for (i = 0; i < source->child_count; i++) {
+        if (sums[i] == NULL) continue;
+        replace_expression(source->children[i], new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
+                                                               copy_expression(power_base(source->children[i])),
+                                                               sums[i]));
     }
     
+    smart_free(table);
+    smart_free(sums);
+    
 }
 
 void evaluate_multiplication(expression* source) {
     
-    uint8_t i, j;
+    uint16_t i;
+    uint16_t literal_index = 0;
+    bool has_literal = false;
     expression* temp_result;
     expression* result;
     
     for (i = 0; i < source->child_count; i++) {
         
-        if (source->children[i] == NULL) continue;
+        if (source->children[i] == NULL || source->children[i]->identifier != EXPI_LITERAL) continue;
         
-        if (source->children[i]->identifier == EXPI_LITERAL && literal_to_double(source->children[i]) == 0) {
+        if (literal_equals(source->children[i], 0)) {
             replace_expression(source, new_literal(1, 0, 1));
             return;
         }
         
-        if (source->children[i]->identifier == EXPI_LITERAL && literal_to_double(source->children[i]) == 1) {
+        if (literal_equals(source->children[i], 1)) {
+            free_expression(source->children[i], false);
+            source->children[i] = NULL;
+        } else if (!has_literal) {
+            literal_index = i;
+            has_literal = true;
+        } else if (numeric_multiplication(&temp_result, source->children[literal_index], source->children[i], true) == RETS_CHANGED) {
+            replace_expression(source->children[literal_index], temp_result);
             free_expression(source->children[i], false);
             source->children[i] = NULL;
-            continue;
-        }
-        
-        for (j = i + 1; j < source->child_count; j++) {
-            
-            if (source->children[i] == NULL) continue;
-            if (source->children[j] == NULL) continue;
-            
-            if (numeric_multiplication(&temp_result, source->children[i], source->children[j], true) == RETS_CHANGED) {
-                replace_expression(source->children[i], temp_result);
-                free_expression(source->children[j], false);
-                source->children[j] = NULL;
-                continue;
-            }
-            
-            if (symbolic_multiplication(&temp_result, source->children[i], source->children[j], true) == RETS_CHANGED) {
-                replace_expression(source->children[i], temp_result);
-                free_expression(source->children[j], false);
-                source->children[j] = NULL;
-                continue;
-            }
-            
         }
         
     }
     
+    collect_like_bases(source);
     remove_null_children(source);
     
     switch (source->child_count) {
@@ -382,7 +568,7 @@ void evaluate_multiplication(expression* source) {
 
 void expand_multiplication_addition_factors(expression* source) {
     
-    uint8_t i, j, k, l;
+    uint16_t i, j, k, l;
     expression* result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
     
     for (i = 0; i < source->child_count - 1; i++) {
@@ -404,7 +590,7 @@ void expand_multiplication_addition_factors(expression* source) {
 
 uint8_t expand_multiplication(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* single_factors;
     expression* addition_factors;
     expression* result;
@@ -451,7 +637,7 @@ uint8_t expand_multiplication(expression* source) {
     free_expression(single_factors, false);
     free_expression(addition_factors, false);
     
-    changed = true;
+    current_context->changed = true;
     
     return RETS_CHANGED;
     
@@ -472,7 +658,7 @@ void simplify_division(expression* source) {
                                                              copy_expression(source->children[1]),
                                                              new_literal(-1, 1, 1))));
     
-    changed = true;
+    current_context->changed = true;
     
 }
 
@@ -490,14 +676,14 @@ void merge_nested_exponentations(expression* source) {
                                                copy_expression(source->children[1])));
         replace_expression(source, result);
         simplify(source->children[1], true);
-        changed = true;
+        current_context->changed = true;
     }
     
 }
 
 uint8_t expand_exponentation_base(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* base = source->children[0];
     expression* exponent = source->children[1];
     expression* result;
@@ -522,7 +708,7 @@ uint8_t expand_exponentation_base(expression* source) {
         smart_free(coefficients);
         replace_expression(source, result);
         
-        changed = true;
+        current_context->changed = true;
         
         return RETS_CHANGED;
         
@@ -538,7 +724,7 @@ uint8_t expand_exponentation_base(expression* source) {
         
         replace_expression(source, result);
         
-        changed = true;
+        current_context->changed = true;
         
         return RETS_CHANGED;
         
@@ -550,7 +736,7 @@ uint8_t expand_exponentation_base(expression* source) {
 
 uint8_t expand_exponentation_exponent(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* result;
     
     if (source->children[1]->identifier != EXPI_ADDITION) return RETS_UNCHANGED;
@@ -565,7 +751,7 @@ uint8_t expand_exponentation_exponent(expression* source) {
     
     replace_expression(source, result);
     
-    changed = true;
+    current_context->changed = true;
     
     return RETS_CHANGED;
     
@@ -576,27 +762,27 @@ uint8_t remove_exponentation_identities(expression* source) {
     expression* base = source->children[0];
     expression* exponent = source->children[1];
     
-    if (exponent->identifier == EXPI_LITERAL && literal_to_double(exponent) == 0) {
+    if (literal_equals(exponent, 0)) {
         replace_expression(source, new_literal(1, 1, 1));
         return RETS_CHANGED;
     }
     
-    if (exponent->identifier == EXPI_LITERAL && literal_to_double(exponent) == 1) {
+    if (literal_equals(exponent, 1)) {
         replace_expression(source, copy_expression(base));
         return RETS_CHANGED;
     }
     
-    if (base->identifier == EXPI_LITERAL && literal_to_double(base) == 0) {
+    if (literal_equals(base, 0)) {
         replace_expression(source, new_literal(1, 0, 1));
         return RETS_CHANGED;
     }
     
-    if (base->identifier == EXPI_LITERAL && literal_to_double(base) == 1) {
+    if (literal_equals(base, 1)) {
         replace_expression(source, new_literal(1, 1, 1));
         return RETS_CHANGED;
     }
     
-    if (base->identifier == EXPI_LITERAL && literal_to_double(base) == -1 && exponent->identifier == EXPI_LITERAL && exponent->value.numeric.numerator % 2 == 1 && exponent->value.numeric.denominator == 1) {
+    if (literal_equals(base, -1) && exponent->identifier == EXPI_LITERAL && !literal_is_big(exponent) && exponent->value.numeric.numerator % 2 == 1 && exponent->value.numeric.denominator == 1) {
         replace_expression(source, new_literal(-1, 1, 1));
         return RETS_CHANGED;
     }
@@ -605,6 +791,137 @@ uint8_t remove_exponentation_identities(expression* source) {
     
 }
 
+/**
+ 
+ @brief Raises the numerator or denominator of a literal to a rational
+ power with bignums
+ 
+ @details
+ For non-integer exponents, perfect powers are detected with an integer
+ root. Otherwise, the value is factorized (see
+ @c numeric_part_prime_factors()) and the integer part of the root is
+ extracted, so that <tt>factor * remainder ^ (1 / degree)</tt> equals
+ the power afterwards.
+ 
+ @param[out] factor The integer part of the power.
+ @param[out] remainder The part remaining under the root.
+ @param[in] value The native value.
+ @param[in] big_value The big value, or @c NULL.
+ @param[in] numerator The numerator of the exponent.
+ @param[in] degree The denominator of the exponent.
+ 
+ @return
+ - @c RETS_SUCCESS, or @c RETS_ERROR if a result exceeds
+ @c BIGNUM_MAX_LIMBS or the value couldn't be factorized.
+ 
+ */
+uint8_t big_numeric_part_power(bignum** factor, bignum** remainder, uintmax_t value, const bignum* big_value, uintmax_t numerator, uintmax_t degree) {
+    
+    uint16_t i;
+    uintmax_t exponent;
+    uintmax_t native_root;
+    bignum* root;
+    bignum* prime;
+    bignum* temp_1;
+    bignum* temp_2;
+    expression* factors;
+    
+    if (degree == 1) {
+        prime = numeric_part_to_bignum(value, big_value);
+        *factor = bignum_power(prime, numerator);
+        *remainder = new_bignum(1);
+        free_bignum(prime);
+        return (*factor == NULL) ? RETS_ERROR : RETS_SUCCESS;
+    }
+    
+    if ((big_value == NULL) ? int_is_perfect_power(&native_root, value, degree) : big_is_perfect_power(&root, big_value, degree)) {
+        if (big_value == NULL) root = new_bignum(native_root);
+        *factor = bignum_power(root, numerator);
+        *remainder = new_bignum(1);
+        free_bignum(root);
+        return (*factor == NULL) ? RETS_ERROR : RETS_SUCCESS;
+    }
+    
+    if ((factors = numeric_part_prime_factors(value, big_value)) == NULL) return RETS_ERROR;
+    
+    *factor = new_bignum(1);
+    *remainder = new_bignum(1);
+    
+    for (i = 0; i < factors->child_count && *factor != NULL && *remainder != NULL; i++) {
+        
+        if (multiplication(&exponent, factors->children[i]->children[1]->value.numeric.numerator, numerator) == RETS_ERROR) break;
+        
+        prime = numeric_part_to_bignum(factors->children[i]->children[0]->value.numeric.numerator, factors->children[i]->children[0]->value.numeric.big_numerator);
+        
+        temp_1 = bignum_power(prime, exponent / degree);
+        temp_2 = (temp_1 == NULL) ? NULL : bignum_multiply(*factor, temp_1);
+        free_bignum(temp_1);
+        free_bignum(*factor);
+        *factor = temp_2;
+        
+        temp_1 = bignum_power(prime, exponent % degree);
+        temp_2 = (temp_1 == NULL || *factor == NULL) ? NULL : bignum_multiply(*remainder, temp_1);
+        free_bignum(temp_1);
+        free_bignum(*remainder);
+        *remainder = temp_2;
+        
+        free_bignum(prime);
+        
+    }
+    
+    if (i < factors->child_count) {
+        free_bignum(*factor);
+        free_bignum(*remainder);
+        free_expression(factors, false);
+        return RETS_ERROR;
+    }
+    
+    free_expression(factors, false);
+    
+    return RETS_SUCCESS;
+    
+}
+
+/**
+ 
+ @brief Evaluates a power of a literal with bignums
+ 
+ @details
+ This function is used if the base is a bignum or the power doesn't fit
+ into native integers. The result is split like in
+ @c big_numeric_part_power().
+ 
+ @param[out] factor The integer part of the power.
+ @param[out] remainder The part remaining under the root.
+ @param[in] base The positive literal base.
+ @param[in] exponent The positive literal exponent.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ */
+uint8_t big_numeric_exponentation(expression** factor, expression** remainder, const expression* base, const expression* exponent) {
+    
+    bignum* factor_numerator;
+    bignum* factor_denominator;
+    bignum* remainder_numerator;
+    bignum* remainder_denominator;
+    
+    ERROR_CHECK(big_numeric_part_power(&factor_numerator, &remainder_numerator, base->value.numeric.numerator, base->value.numeric.big_numerator, exponent->value.numeric.numerator, exponent->value.numeric.denominator));
+    
+    if (big_numeric_part_power(&factor_denominator, &remainder_denominator, base->value.numeric.denominator, base->value.numeric.big_denominator, exponent->value.numeric.numerator, exponent->value.numeric.denominator) == RETS_ERROR) {
+        free_bignum(factor_numerator);
+        free_bignum(remainder_numerator);
+        return RETS_ERROR;
+    }
+    
+    *factor = new_big_literal(1, factor_numerator, factor_denominator);
+    *remainder = new_big_literal(1, remainder_numerator, remainder_denominator);
+    
+    return RETS_SUCCESS;
+    
+}
+
 uint8_t numeric_exponentation(expression* source) {
     
     expression* base = source->children[0];
@@ -613,9 +930,9 @@ uint8_t numeric_exponentation(expression* source) {
     expression* factor;
     expression* result;
     
-    uintmax_t temp;
+    numeric_value temp;
     
-    if (base->identifier != EXPI_LITERAL || exponent->identifier != EXPI_LITERAL) return RETS_UNCHANGED;
+    if (base->identifier != EXPI_LITERAL || exponent->identifier != EXPI_LITERAL || literal_is_big(exponent)) return RETS_UNCHANGED;
     
     base_result = new_literal(1, 0, 1);
     factor = new_literal(1, 1, 1);
@@ -623,7 +940,7 @@ uint8_t numeric_exponentation(expression* source) {
     simplify_literal(base);
     simplify_literal(exponent);
     
-    if (literal_to_double(base) == -1 && exponent->value.numeric.denominator == 2) {
+    if (literal_equals(base, -1) && exponent->value.numeric.denominator == 2) {
         
         if ((exponent->value.numeric.numerator - 1) % 4 == 0) {
             replace_expression(source, new_symbol(EXPI_SYMBOL, "i"));
@@ -638,17 +955,29 @@ uint8_t numeric_exponentation(expression* source) {
     }
     
     if (exponent->sign == -1) {
-        temp = base->value.numeric.numerator;
-        base->value.numeric.numerator = base->value.numeric.denominator;
-        base->value.numeric.denominator = temp;
+        invalidate_summary(base);
+        invalidate_summary(exponent);
+        temp = base->value.numeric;
+        base->value.numeric.numerator = temp.denominator;
+        base->value.numeric.denominator = temp.numerator;
+        base->value.numeric.big_numerator = temp.big_denominator;
+        base->value.numeric.big_denominator = temp.big_numerator;
         exponent->sign = 1;
     }
     
-    if (int_power(&base_result->value.numeric.numerator, base->value.numeric.numerator, exponent->value.numeric.numerator) == RETS_ERROR) return RETS_UNCHANGED;
-    if (int_power(&base_result->value.numeric.denominator, base->value.numeric.denominator, exponent->value.numeric.numerator) == RETS_ERROR) return RETS_UNCHANGED;
-    
-    int_root(&factor->value.numeric.numerator, &base_result->value.numeric.numerator, base_result->value.numeric.numerator, exponent->value.numeric.denominator);
-    int_root(&factor->value.numeric.denominator, &base_result->value.numeric.denominator, base_result->value.numeric.denominator, exponent->value.numeric.denominator);
+    if (literal_is_big(base) ||
+        int_power(&base_result->value.numeric.numerator, base->value.numeric.numerator, exponent->value.numeric.numerator) == RETS_ERROR ||
+        int_power(&base_result->value.numeric.denominator, base->value.numeric.denominator, exponent->value.numeric.numerator) == RETS_ERROR) {
+        free_expressions(2, base_result, factor);
+        if (big_numeric_exponentation(&factor, &base_result, base, exponent) == RETS_ERROR) return RETS_UNCHANGED;
+    } else if (exponent->value.numeric.denominator == 1) {
+        factor->value.numeric = base_result->value.numeric;
+        base_result->value.numeric.numerator = 1;
+        base_result->value.numeric.denominator = 1;
+    } else {
+        int_root(&factor->value.numeric.numerator, &base_result->value.numeric.numerator, base_result->value.numeric.numerator, exponent->value.numeric.denominator);
+        int_root(&factor->value.numeric.denominator, &base_result->value.numeric.denominator, base_result->value.numeric.denominator, exponent->value.numeric.denominator);
+    }
     
     result = new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 0);
     
@@ -659,16 +988,16 @@ uint8_t numeric_exponentation(expression* source) {
 //        symbolic_exponentation(result->children[result->child_count - 1]);
     }
     
-    if (literal_to_double(factor) == literal_to_double(base_result)) {
+    if (is_equivalent(factor, base_result)) {
         append_child(result, new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
                                             copy_expression(base_result),
-                                            new_literal(1, exponent->value.numeric.numerator + exponent->value.numeric.denominator, exponent->value.numeric.denominator)));
+                                            new_literal(1, exponent->value.numeric.denominator + 1, exponent->value.numeric.denominator)));
         remove_exponentation_identities(result->children[result->child_count - 1]);
     } else {
-        if (literal_to_double(factor) != 1) append_child(result, copy_expression(factor));
-        if (literal_to_double(base_result) != 1) append_child(result, new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
+        if (!literal_equals(factor, 1)) append_child(result, copy_expression(factor));
+        if (!literal_equals(base_result, 1)) append_child(result, new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
                                                                                      copy_expression(base_result),
-                                                                                     copy_expression(exponent)));
+                                                                                     new_literal(1, 1, exponent->value.numeric.denominator)));
     }
     
     simplify_multiplication(result);
@@ -685,7 +1014,7 @@ uint8_t symbolic_exponentation(expression* source) {
     expression* base = source->children[0];
     expression* exponent = source->children[1];
     
-    if (expressions_are_identical(base, new_symbol(EXPI_SYMBOL, "i"), false) && exponent->identifier == EXPI_LITERAL) {
+    if (is_symbol(base, SYMBOL_I) && exponent->identifier == EXPI_LITERAL) {
         replace_expression(source, new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
                                                   new_literal(-1, 1, 1),
                                                   new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
@@ -701,17 +1030,17 @@ uint8_t symbolic_exponentation(expression* source) {
 
 return_status exponentation_remove_logarithms(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* base = source->children[0];
     expression* exponent = source->children[1];
     expression* temp;
     
-    if (exponent->identifier == EXPI_LN && expressions_are_identical(base, new_symbol(EXPI_SYMBOL, "e"), false)) {
+    if (exponent->identifier == EXPI_LN && is_symbol(base, SYMBOL_E)) {
         replace_expression(source, copy_expression(source->children[1]->children[0]));
         return RETS_CHANGED;
     }
     
-    if (exponent->identifier == EXPI_LOG && exponent->child_count == 1 && expressions_are_identical(base, new_literal(1, 10, 1), false)) {
+    if (exponent->identifier == EXPI_LOG && exponent->child_count == 1 && is_literal_equal(base, 1, 10, 1)) {
         replace_expression(source, copy_expression(source->children[1]->children[0]));
         return RETS_CHANGED;
     }
@@ -785,20 +1114,20 @@ void simplify_abs(expression* source) {
             result = copy_expression(source->children[0]);
             result->sign = 1;
             replace_expression(source, result);
-            changed = true;
+            current_context->changed = true;
         }
     } else if (source->children[0]->identifier == EXPI_MULTIPLICATION && source->children[0]->child_count == 2 && source->children[0]->children[0]->sign == -1 && symbol_is_constant(source->children[0]->children[1])) {
         result = copy_expression(source->children[0]);
         result->children[0]->sign = 1;
         replace_expression(source, result);
-        changed = true;
+        current_context->changed = true;
     }
     
 }
 
 uint8_t evaluate_logarithm(expression** result, expression* value, expression* base) {
     
-    if (expressions_are_identical(value, new_literal(1, 0, 1), false)) {
+    if (is_zero(value)) {
         return set_error(ERRD_MATH, ERRI_UNDEFINED_VALUE, "");
     }
     
@@ -807,9 +1136,9 @@ uint8_t evaluate_logarithm(expression** result, expression* value, expression* b
         return RETS_SUCCESS;
     }
     
-    if (expressions_are_identical(base, new_symbol(EXPI_SYMBOL, "e"), false)) {
+    if (is_symbol(base, SYMBOL_E)) {
         *result = new_expression(EXPT_FUNCTION, EXPI_LN, 1, copy_expression(value));
-    } else if (expressions_are_identical(base, new_literal(1, 10, 1), false)) {
+    } else if (is_literal_equal(base, 1, 10, 1)) {
         *result = new_expression(EXPT_FUNCTION, EXPI_LOG, 1, copy_expression(value));
     } else {
         *result = new_expression(EXPT_FUNCTION, EXPI_LOG, 2,
@@ -823,7 +1152,7 @@ uint8_t evaluate_logarithm(expression** result, expression* value, expression* b
 
 uint8_t expand_logarithm(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* factors;
     expression* result;
     
@@ -850,12 +1179,13 @@ uint8_t expand_logarithm(expression* source) {
         
     } else if (source->children[0]->identifier == EXPI_LITERAL && source->children[0]->value.numeric.denominator == 1) {
         
-        result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
-        
-        factors = prime_factors(source->children[0]->value.numeric.numerator);
+        factors = numeric_part_prime_factors(source->children[0]->value.numeric.numerator, source->children[0]->value.numeric.big_numerator);
         
+        if (factors == NULL) return RETS_UNCHANGED;
         if (factors->child_count == 1 && factors->children[0]->children[1]->value.numeric.numerator == 1) return RETS_CHANGED;
         
+        result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
+        
         for (i = 0; i < factors->child_count; i++) {
             append_child(result, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
                                                 copy_expression(factors->children[i]->children[1]),
@@ -870,7 +1200,7 @@ uint8_t expand_logarithm(expression* source) {
     
     replace_expression(source, result);
     
-    changed = true;
+    current_context->changed = true;
     
     return RETS_CHANGED;
     
@@ -906,262 +1236,178 @@ uint8_t simplify_logarithm(expression* source) {
     
 }
 
-void simplify_sin(expression* source) {
-    
-    if (expressions_are_equivalent(source->children[0], new_literal(1, 0, 1), false)) {
-        replace_expression(source, new_literal(1, 0, 1));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 6),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_literal(1, 1, 2));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 4),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                 new_literal(1, 2, 1),
-                                                                 new_literal(1, 1, 2)),
-                                                  new_literal(1, 1, 2)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 3),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                 new_literal(1, 3, 1),
-                                                                 new_literal(1, 1, 2)),
-                                                  new_literal(1, 1, 2)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 2),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_literal(1, 1, 1));
-    } else {
-        return;
-    }
-    
-    changed = true;
-    
+/**
+ 
+ @brief Checks if an expression has been simplified in the current
+ simplify epoch
+ 
+ @details
+ A new epoch starts with every outermost call of @c simplify(), so
+ expressions modified in place between two simplifications are never
+ skipped. Copies keep the mark, which is what lets rewritten
+ expressions skip their unchanged subtrees.
+ 
+ */
+bool expression_is_normalized(const expression* source) {
+    return source->normalized == current_context->simplify_epoch;
 }
 
-void simplify_cos(expression* source) {
-    
-    if (expressions_are_equivalent(source->children[0], new_literal(1, 0, 1), false)) {
-        replace_expression(source, new_literal(1, 1, 1));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 6),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                 new_literal(1, 3, 1),
-                                                                 new_literal(1, 1, 2)),
-                                                  new_literal(1, 1, 2)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 4),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                 new_literal(1, 2, 1),
-                                                                 new_literal(1, 1, 2)),
-                                                  new_literal(1, 1, 2)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 3),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_literal(1, 1, 2));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 2),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_literal(1, 0, 1));
-    } else {
-        return;
-    }
-    
-    changed = true;
+/**
+ 
+ @brief Simplifies a node until no rule applies anymore
+ 
+ @details
+ Children are simplified first, except for those which are already
+ normalized. Whenever a rule rewrites the node, only the children the
+ rule has created (or changed) are simplified again before the rules
+ are reapplied, so the work is proportional to the size of the change
+ rather than the size of the subtree. The compiled rewrite rules
+ (see @c apply_rewrite_rules()) are tried before the rules of the
+ identifier.
+ 
+ @param[in,out] source The expression to be simplified.
+ @param[in] recursive Determines if the children are simplified
+ first. After a rule has rewritten the node, the children are always
+ simplified.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ */
+uint8_t simplify_node(expression* source, bool recursive) {
     
-}
-
-return_status simplify_tan(expression* source) {
+    uint16_t i;
     
-    if (expressions_are_equivalent(source->children[0], new_literal(1, 0, 1), false)) {
-        replace_expression(source, new_literal(1, 0, 1));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 6),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                 new_literal(1, 3, 1),
-                                                                 new_literal(1, 1, 2)),
-                                                  new_literal(1, 1, 3)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 4),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_literal(1, 1, 1));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 3),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                  new_literal(1, 3, 1),
-                                                  new_literal(1, 1, 2)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_literal(1, 1, 2),
-                                                                              new_symbol(EXPI_SYMBOL, "pi")), false)) {
-        return set_error(ERRD_MATH, ERRI_UNDEFINED_VALUE, "tan");
-    } else {
-        return RETS_SUCCESS;
-    }
+    do {
+        
+        for (i = 0; i < source->child_count && recursive; i++) {
+            if (source->children[i] == NULL || expression_is_normalized(source->children[i])) continue;
+            ERROR_CHECK(simplify_subtree(source->children[i], true, false));
+        }
+        
+        any_expression_to_expression(source);
+        invalidate_summary(source);
+        
+        current_context->changed = false;
+        
+        apply_rewrite_rules(source);
+        if (current_context->changed) continue;
+        
+        switch (source->identifier) {
+            case EXPI_LITERAL: simplify_literal(source); break;
+            case EXPI_SYMBOL: break;
+            case EXPI_VARIABLE: break;
+            case EXPI_ADDITION: simplify_addition(source); break;
+            case EXPI_SUBTRACTION: simplify_subtraction(source); break;
+            case EXPI_MULTIPLICATION: simplify_multiplication(source); break;
+            case EXPI_DIVISION: simplify_division(source); break;
+            case EXPI_EXPONENTATION: ERROR_CHECK(simplify_exponentation(source)); break;
+            case EXPI_ABS: simplify_abs(source); break;
+            case EXPI_LN:
+            case EXPI_LOG: ERROR_CHECK(simplify_logarithm(source)); break;
+            case EXPI_SIN:
+            case EXPI_COS:
+            case EXPI_TAN: ERROR_CHECK(simplify_trigonometric_function(source)); break;
+            case EXPI_POLYNOMIAL_SPARSE: break;
+            case EXPI_POLYNOMIAL_DENSE: break;
+            case EXPI_LIST: break;
+            case EXPI_MATRIX: break;
+            case EXPI_EXTENSION: break;
+            default: break;
+        }
+        
+        recursive = true;
+        
+    } while (current_context->changed);
     
-    changed = true;
+    source->normalized = current_context->simplify_epoch;
     
     return RETS_SUCCESS;
     
 }
 
-void simplify_arcsin(expression* source) {
+uint8_t simplify_memoized(expression* source, bool recursive) {
     
-    if (expressions_are_identical(source->children[0], new_literal(1, 0, 1), false)) {
-        replace_expression(source, new_literal(1, 0, 1));
-    } else if (expressions_are_identical(source->children[0], new_literal(1, 1, 2), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 6)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                                             new_literal(1, 2, 1),
-                                                                                             new_literal(1, 1, 2)),
-                                                                              new_literal(1, 1, 2)), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 4)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                                             new_literal(1, 3, 1),
-                                                                                             new_literal(1, 1, 2)),
-                                                                              new_literal(1, 1, 2)), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 3)));
-    } else if (expressions_are_identical(source->children[0], new_literal(1, 1, 1), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 2)));
-    } else {
-        return;
-    }
-    
-    changed = true;
+    expression* input;
     
-}
-
-void simplify_arccos(expression* source) {
+    if (!recursive || !simplify_memo_is_applicable(source)) return simplify_node(source, recursive);
     
-    if (expressions_are_identical(source->children[0], new_literal(1, 1, 1), false)) {
-        replace_expression(source, new_literal(1, 1, 1));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                                             new_literal(1, 3, 1),
-                                                                                             new_literal(1, 1, 2)),
-                                                                              new_literal(1, 1, 2)), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 6)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                                             new_literal(1, 2, 1),
-                                                                                             new_literal(1, 1, 2)),
-                                                                              new_literal(1, 1, 2)), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 4)));
-    } else if (expressions_are_identical(source->children[0], new_literal(1, 1, 2), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 3)));
-    } else if (expressions_are_identical(source->children[0], new_literal(1, 0, 1), false)) {
-        replace_expression(source, new_literal(1, 0, 1));
-    } else {
-        return;
+    if (simplify_memo_lookup(source)) {
+        source->normalized = current_context->simplify_epoch;
+        return RETS_SUCCESS;
     }
     
-    changed = true;
+    input = intern_expression(source);
     
-}
-
-void simplify_arctan(expression* source) {
-    
-    if (expressions_are_identical(source->children[0], new_literal(1, 0, 1), false)) {
-        replace_expression(source, new_literal(1, 0, 1));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                                              new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                                             new_literal(1, 3, 1),
-                                                                                             new_literal(1, 1, 2)),
-                                                                              new_literal(1, 1, 3)), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 6)));
-    } else if (expressions_are_identical(source->children[0], new_literal(1, 1, 1), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 4)));
-    } else if (expressions_are_equivalent(source->children[0], new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
-                                                                              new_literal(1, 3, 1),
-                                                                              new_literal(1, 1, 2)), false)) {
-        replace_expression(source, new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 2,
-                                                  new_symbol(EXPI_SYMBOL, "pi"),
-                                                  new_literal(1, 1, 3)));
-    } else {
-        return;
+    if (simplify_node(source, true) == RETS_ERROR) {
+        release_interned_expression(input);
+        return RETS_ERROR;
     }
     
-    changed = true;
+    simplify_memo_insert(input, source);
+    
+    return RETS_SUCCESS;
     
 }
 
-uint8_t simplify(expression* source, bool recursive) {
-    
-    uint8_t i;
-    
-    changed = false;
+/**
+ 
+ @brief Simplifies an expression, with or without the memo table
+ 
+ @details
+ The @c changed flag of the context is restored afterwards, so that
+ simplifications nested in a rule don't hide the changes of the rule.
+ 
+ @param[in,out] source The expression to be simplified.
+ @param[in] recursive Determines if the children are simplified first.
+ @param[in] is_memoized Determines if the memo table is consulted.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ */
+uint8_t simplify_subtree(expression* source, bool recursive, bool is_memoized) {
     
-    for (i = 0; i < source->child_count && recursive; i++) {
-        if (source->children[i] == NULL) continue;
-        ERROR_CHECK(simplify(source->children[i], true));
-    }
+    uint8_t result;
+    bool changed = current_context->changed;
     
-    any_expression_to_expression(source);
+    if (current_context->simplify_depth++ == 0 && ++current_context->simplify_epoch == 0) current_context->simplify_epoch = 1;
     
-    switch (source->identifier) {
-        case EXPI_LITERAL: simplify_literal(source); break;
-        case EXPI_SYMBOL: break;
-        case EXPI_VARIABLE: break;
-        case EXPI_ADDITION: simplify_addition(source); break;
-        case EXPI_SUBTRACTION: simplify_subtraction(source); break;
-        case EXPI_MULTIPLICATION: simplify_multiplication(source); break;
-        case EXPI_DIVISION: simplify_division(source); break;
-        case EXPI_EXPONENTATION: ERROR_CHECK(simplify_exponentation(source)); break;
-        case EXPI_ABS: simplify_abs(source); break;
-        case EXPI_LN:
-        case EXPI_LOG: ERROR_CHECK(simplify_logarithm(source)); break;
-        case EXPI_SIN: simplify_sin(source); break;
-        case EXPI_COS: simplify_cos(source); break;
-        case EXPI_TAN: ERROR_CHECK(simplify_tan(source)); break;
-        case EXPI_ARCSIN: simplify_arcsin(source); break;
-        case EXPI_ARCCOS: simplify_arccos(source); break;
-        case EXPI_ARCTAN: simplify_arctan(source); break;
-        case EXPI_POLYNOMIAL_SPARSE: break;
-        case EXPI_POLYNOMIAL_DENSE: break;
-        case EXPI_LIST: break;
-        case EXPI_MATRIX: break;
-        case EXPI_EXTENSION: break;
-        default: break;
-    }
+    result = is_memoized ? simplify_memoized(source, recursive) : simplify_node(source, recursive);
     
-    if (changed) ERROR_CHECK(simplify(source, true));
+    current_context->simplify_depth--;
+    current_context->changed = changed;
     
-    return RETS_SUCCESS;
+    return result;
     
 }
 
+/**
+ 
+ @brief Simplifies an expression
+ 
+ @details
+ Recursive simplifications of medium-sized expressions are memoized
+ in the context by their interned input (see memo.c), so
+ expressions which reappear within a query or in later queries are
+ only simplified once. The memo table is only consulted for the
+ expression passed to this function, not for each of its subtrees, so
+ its size is counted and its interned node looked up once per call.
+ 
+ @param[in,out] source The expression to be simplified.
+ @param[in] recursive Determines if the children are simplified first.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ */
+uint8_t simplify(expression* source, bool recursive) {
+    return simplify_subtree(source, recursive, true);
+}
+
 void approximate_addition(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     double result = 0;
     
     for (i = 0; i < source->child_count; i++) {
@@ -1184,7 +1430,7 @@ void approximate_addition(expression* source) {
 
 void approximate_multiplication(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     double result = 1;
     
     for (i = 0; i < source->child_count; i++) {
@@ -1266,16 +1512,19 @@ void approximate_trigonometric(expression* source) {
 
 void approximate(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
+    expression_summary summary = get_expression_summary(source);
+    
+    if ((summary.operators & APPROXIMATE_OPERATORS) == 0 && (summary.symbols & (SUMMARY_SYMBOL_BIT(SYMBOL_PI) | SUMMARY_SYMBOL_BIT(SYMBOL_E))) == 0) return;
     
     for (i = 0; i < source->child_count; i++) {
         if (source->children[i] == 0) continue;
         approximate(source->children[i]);
     }
     
-    if (expressions_are_identical(source, new_symbol(EXPI_SYMBOL, "pi"), false)) {
+    if (is_symbol(source, SYMBOL_PI)) {
         replace_expression(source, double_to_literal(M_PI));
-    } else if (expressions_are_identical(source, new_symbol(EXPI_SYMBOL, "e"), false)) {
+    } else if (is_symbol(source, SYMBOL_E)) {
         replace_expression(source, double_to_literal(M_E));
     }
     
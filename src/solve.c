@@ -25,8 +25,6 @@
 
 #include "symbolic4.h"
 
-bool isolation_changed = false;
-
 uint8_t attract_variables(expression* source, expression* variable) {
     
     if (count_occurrences(source->children[1], variable, true) > 0) {
@@ -61,14 +59,15 @@ void subtract_rhs(expression* source) {
 
 uint8_t isolate_variable_in_addition(expression* source, expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
     
     for (i = 0; i < source->children[0]->child_count; i++) {
         if (count_occurrences(source->children[0]->children[i], variable, true) == 0) {
             append_child(temp, source->children[0]->children[i]);
+            invalidate_summary(source->children[0]);
             source->children[0]->children[i] = NULL;
-            isolation_changed = true;
+            current_context->isolation_changed = true;
         }
     }
     
@@ -84,14 +83,15 @@ uint8_t isolate_variable_in_addition(expression* source, expression* variable) {
 
 uint8_t isolate_variable_in_multiplication(expression* source, expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     expression* temp = new_expression(EXPT_OPERATION, EXPI_MULTIPLICATION, 0);
     
     for (i = 0; i < source->children[0]->child_count; i++) {
         if (count_occurrences(source->children[0]->children[i], variable, true) == 0) {
             append_child(temp, source->children[0]->children[i]);
+            invalidate_summary(source->children[0]);
             source->children[0]->children[i] = NULL;
-            isolation_changed = true;
+            current_context->isolation_changed = true;
         }
     }
     
@@ -133,8 +133,8 @@ uint8_t isolate_variable_in_exponentation(expression* source, expression* variab
         
         
         
-        if (source->children[0]->children[1]->identifier == EXPI_LITERAL && source->children[0]->children[1]->value.numeric.numerator % 2 == 0 && source->children[0]->children[1]->value.numeric.denominator == 1 &&
-            !expressions_are_identical(result, new_literal(1, 0, 1), false)) {
+        if (source->children[0]->children[1]->identifier == EXPI_LITERAL && !literal_is_big(source->children[0]->children[1]) && source->children[0]->children[1]->value.numeric.numerator % 2 == 0 && source->children[0]->children[1]->value.numeric.denominator == 1 &&
+            !is_zero(result)) {
             replace_expression(source, new_expression(EXPT_STRUCTURE, EXPI_LIST, 2,
                                                       new_expression(EXPT_OPERATION, EXPI_EQUATION, 2,
                                                                      copy_expression(source->children[0]->children[0]),
@@ -156,7 +156,7 @@ uint8_t isolate_variable_in_exponentation(expression* source, expression* variab
     
     ERROR_CHECK(simplify(source, true));
     
-    isolation_changed = true;
+    current_context->isolation_changed = true;
     
     return RETS_SUCCESS;
     
@@ -172,7 +172,7 @@ uint8_t isolate_variable_in_ln(expression* source) {
     
     ERROR_CHECK(simplify(source, true));
     
-    isolation_changed = true;
+    current_context->isolation_changed = true;
     
     return RETS_SUCCESS;
     
@@ -196,7 +196,7 @@ uint8_t isolate_variable_in_log(expression* source) {
     
     ERROR_CHECK(simplify(source, true));
     
-    isolation_changed = true;
+    current_context->isolation_changed = true;
     
     return RETS_SUCCESS;
     
@@ -204,7 +204,7 @@ uint8_t isolate_variable_in_log(expression* source) {
 
 uint8_t isolate_variable_in_trigonometric_function(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* right_side;
     
     switch (source->children[0]->identifier) {
@@ -272,7 +272,7 @@ uint8_t isolate_variable_in_trigonometric_function(expression* source) {
                                                   right_side));
     }
     
-    isolation_changed = true;
+    current_context->isolation_changed = true;
     
     return RETS_SUCCESS;
     
@@ -280,8 +280,8 @@ uint8_t isolate_variable_in_trigonometric_function(expression* source) {
 
 uint8_t isolate_variable(expression* source, expression* variable) {
     
-    uint8_t i;
-    isolation_changed = false;
+    uint16_t i;
+    current_context->isolation_changed = false;
     
     if (source->identifier == EXPI_LIST) {
         
@@ -308,7 +308,7 @@ uint8_t isolate_variable(expression* source, expression* variable) {
         default: return RETS_UNCHANGED;
     }
     
-    if (isolation_changed) ERROR_CHECK(isolate_variable(source, variable));
+    if (current_context->isolation_changed) ERROR_CHECK(isolate_variable(source, variable));
     
     return RETS_SUCCESS;
     
@@ -316,12 +316,13 @@ uint8_t isolate_variable(expression* source, expression* variable) {
 
 uint8_t handle_right_side_is_zero(expression* source, expression* variable) {
     
-    uint8_t i;
+    uint16_t i;
     
     if (source->children[0]->identifier == EXPI_MULTIPLICATION) {
         for (i = 0; i < source->children[0]->child_count; i++) {
             if (source->children[0]->children[i]->identifier == EXPI_EXPONENTATION && expression_is_constant(source->children[0]->children[i]->children[1]) &&
                 source->children[0]->children[i]->children[1]->sign == -1) {
+                invalidate_summary(source->children[0]);
                 free_expression(source->children[0]->children[i], false);
                 source->children[0]->children[i] = NULL;
             }
@@ -345,7 +346,7 @@ uint8_t solve(expression* source, expression* variable) {
     
     ERROR_CHECK(attract_variables(source, variable));
     
-    if (expressions_are_identical(source->children[1], new_literal(1, 0, 1), false)) {
+    if (is_zero(source->children[1])) {
         switch (handle_right_side_is_zero(source, variable)) {
             case RETS_CHANGED: break;
             case RETS_SUCCESS: return RETS_SUCCESS;
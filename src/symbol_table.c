@@ -0,0 +1,212 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+static const char* predefined_symbol_names[] = {"pi", "e", "i"};
+
+uint32_t symbol_table_hash(const char* name);
+void symbol_table_grow(symbol_table* table);
+uint32_t symbol_table_insert(symbol_table* table, const char* name);
+uint8_t symbol_table_order_score(char letter, const char* priorities);
+
+/**
+ 
+ @brief Allocates a new symbol table
+ 
+ @details
+ The symbols of @c predefined_symbol are interned in their order, so
+ that their ids are known in advance.
+ 
+ @return
+ - The new symbol table.
+ 
+ */
+symbol_table* new_symbol_table(void) {
+    
+    uint8_t i;
+    symbol_table* table = calloc(1, sizeof(symbol_table));
+    
+    if (table == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    table->bucket_count = SYMBOL_TABLE_INITIAL_BUCKET_COUNT;
+    table->buckets = calloc(table->bucket_count, sizeof(uint32_t));
+    
+    if (table->buckets == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    for (i = 0; i < sizeof(predefined_symbol_names) / sizeof(predefined_symbol_names[0]); i++) {
+        symbol_table_insert(table, predefined_symbol_names[i]);
+    }
+    
+    return table;
+    
+}
+
+void free_symbol_table(symbol_table* table) {
+    
+    uint32_t i;
+    
+    if (table == NULL) return;
+    
+    for (i = 0; i < table->count; i++) {
+        free(table->entries[i].name);
+    }
+    
+    free(table->entries);
+    free(table->buckets);
+    free(table);
+    
+}
+
+uint32_t symbol_table_hash(const char* name) {
+    
+    uint32_t hash = 2166136261u;
+    
+    for (; *name != '\0'; name++) {
+        hash = (hash ^ (uint8_t) *name) * 16777619u;
+    }
+    
+    return hash;
+    
+}
+
+void symbol_table_grow(symbol_table* table) {
+    
+    uint32_t i, j;
+    uint32_t bucket_count = 2 * table->bucket_count;
+    uint32_t* buckets = calloc(bucket_count, sizeof(uint32_t));
+    
+    if (buckets == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    for (i = 0; i < table->count; i++) {
+        for (j = table->entries[i].hash & (bucket_count - 1); buckets[j] != 0; j = (j + 1) & (bucket_count - 1));
+        buckets[j] = i + 1;
+    }
+    
+    free(table->buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+    
+}
+
+uint32_t symbol_table_insert(symbol_table* table, const char* name) {
+    
+    uint32_t i;
+    uint32_t hash = symbol_table_hash(name);
+    symbol_table_entry* entry;
+    
+    for (i = hash & (table->bucket_count - 1); table->buckets[i] != 0; i = (i + 1) & (table->bucket_count - 1)) {
+        entry = &table->entries[table->buckets[i] - 1];
+        if (entry->hash == hash && strcmp(entry->name, name) == 0) return table->buckets[i] - 1;
+    }
+    
+    if (table->count == table->capacity) {
+        table->capacity = (table->capacity == 0) ? 64 : 2 * table->capacity;
+        table->entries = realloc(table->entries, table->capacity * sizeof(symbol_table_entry));
+        if (table->entries == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    }
+    
+    entry = &table->entries[table->count];
+    entry->name = malloc(strlen(name) + 1);
+    
+    if (entry->name == NULL) set_handle_unrecoverable_error(ERRD_SYSTEM, ERRI_MEMORY_ALLOCATION, "");
+    
+    strcpy(entry->name, name);
+    entry->hash = hash;
+    entry->letter = (name[0] != '\0' && name[1] == '\0') ? name[0] : '\0';
+    entry->order_score = (current_context != NULL) ? symbol_table_order_score(entry->letter, current_context->default_priorities) : 100;
+    
+    table->buckets[i] = ++table->count;
+    
+    if (2 * table->count > table->bucket_count) symbol_table_grow(table);
+    
+    return table->count - 1;
+    
+}
+
+/**
+ 
+ @brief Returns the id of a symbol name, adding it to the symbol table
+ of the current context if necessary
+ 
+ @param[in] name The name of the symbol.
+ 
+ @return
+ - The id of the symbol.
+ 
+ */
+uint32_t intern_symbol(const char* name) {
+    return symbol_table_insert(current_context->symbol_table, name);
+}
+
+const char* get_symbol_name(uint32_t symbol) {
+    return current_context->symbol_table->entries[symbol].name;
+}
+
+char get_symbol_letter(uint32_t symbol) {
+    return current_context->symbol_table->entries[symbol].letter;
+}
+
+uint8_t symbol_table_order_score(char letter, const char* priorities) {
+    
+    const char* occurance;
+    
+    if (letter == '\0' || priorities == NULL || (occurance = strchr(priorities, letter)) == NULL) return 100;
+    
+    return (uint8_t) (occurance - priorities);
+    
+}
+
+/**
+ 
+ @brief Returns the position of a symbol in the default priorities of
+ the current context
+ 
+ @details
+ The positions are stored per symbol and are only recomputed after
+ the contents of the default priorities have been changed.
+ 
+ @param[in] symbol The id of the symbol.
+ 
+ @return
+ - The position, or 100 if the symbol isn't contained in the default
+ priorities.
+ 
+ */
+uint8_t get_symbol_priority(uint32_t symbol) {
+    
+    uint32_t i;
+    symbol_table* table = current_context->symbol_table;
+    
+    if (table->priorities_epoch != current_context->priorities_epoch) {
+        table->priorities_epoch = current_context->priorities_epoch;
+        for (i = 0; i < table->count; i++) {
+            table->entries[i].order_score = symbol_table_order_score(table->entries[i].letter, current_context->default_priorities);
+        }
+    }
+    
+    return table->entries[symbol].order_score;
+    
+}
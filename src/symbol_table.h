@@ -0,0 +1,75 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef symbol_table_h
+#define symbol_table_h
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief Ids of the symbols which are interned by every table
+ 
+ */
+typedef enum {
+    SYMBOL_PI,
+    SYMBOL_E,
+    SYMBOL_I
+} predefined_symbol;
+
+typedef struct symbol_table_entry {
+    char* name;
+    uint32_t hash;
+    uint8_t order_score; ///< See @c get_symbol_order_score()
+    char letter; ///< The name if it consists of one character, '\0' otherwise
+} symbol_table_entry;
+
+/**
+ 
+ @brief Maps symbol names to 32-bit ids and back
+ 
+ @details
+ Symbols are stored by id in expressions, so comparing two symbols
+ takes one integer comparison and names may be of any length. The ids
+ are only valid within the context owning the table.
+ 
+ */
+typedef struct symbol_table {
+    symbol_table_entry* entries;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t* buckets; ///< Open addressing, id + 1 (0 if empty)
+    uint32_t bucket_count;
+    uint32_t priorities_epoch; ///< The epoch of the default priorities the order scores were computed for (see @c update_priorities_epoch())
+} symbol_table;
+
+symbol_table* new_symbol_table(void);
+void free_symbol_table(symbol_table* table);
+uint32_t intern_symbol(const char* name);
+const char* get_symbol_name(uint32_t symbol);
+char get_symbol_letter(uint32_t symbol);
+uint8_t get_symbol_priority(uint32_t symbol);
+
+#endif /* symbol_table_h */
@@ -25,10 +25,6 @@
 
 #include "symbolic4.h"
 
-bool use_abbrevations = true;
-bool use_spaces = true;
-char* default_priorities = "XYZABCDUVWSTPQRJKLMNOFGHEIxyzabcduvwstpqrjklmnofghei";
-
 uint8_t process_equation(expression* source);
 uint8_t process_solve(expression* source);
 uint8_t process_value(expression* source);
@@ -46,39 +42,167 @@ uint8_t process_vector_dot_product(expression* source);
 uint8_t process_vector_cross_product(expression* source);
 uint8_t process_vector_triple_product(expression* source);
 void process_approximate(expression* source);
+uint8_t symbolic4_evaluate(char* buffer, size_t buffer_length, expression* root);
+uint8_t symbolic4_query(char* buffer, size_t buffer_length, const char* query);
 
-uint8_t symbolic4(char* buffer, const char* query) {
-    
-    expression* root;
-    
-    allocated_pointers = calloc(ALLOCATED_POINTERS_LENGTH, sizeof(void*));
-    memset(allocated_pointers, 0, ALLOCATED_POINTERS_LENGTH);
-    buffer[0] = '\0';
+uint8_t symbolic4_evaluate(char* buffer, size_t buffer_length, expression* root) {
     
-    root = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
-
-    ERROR_CHECK(tokenize(root, query));
     ERROR_CHECK(validate(root));
     parse(root);
-
+    
     if (root->identifier == EXPI_PARSE) {
-        expression_to_string(buffer, root->children[0], (root->child_count == 2) ? (uint8_t) root->children[1]->value.numeric.numerator : ETSF_INFIX);
+        return expression_to_string(buffer, buffer_length, root->children[0], (root->child_count == 2) ? (uint8_t) root->children[1]->value.numeric.numerator : ETSF_INFIX);
     } else {
         ERROR_CHECK(process(root, true));
-        expression_to_string(buffer, root, ETSF_INFIX);
+        if (current_context->error.identifier == ERRI_MAX_CHILD_COUNT_EXCEEDED) return RETS_ERROR;
+        return expression_to_string(buffer, buffer_length, root, ETSF_INFIX);
+    }
+    
+}
+
+uint8_t symbolic4_query(char* buffer, size_t buffer_length, const char* query) {
+    
+    uint8_t status;
+    char* key = NULL;
+    expression* root = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
+    
+    ERROR_CHECK(tokenize(root, query));
+    
+    if (current_context->cache != NULL) {
+        key = cache_key_from_tokens(root);
+        if (cache_lookup(current_context->cache, key, buffer, buffer_length, &status)) return status;
     }
+    
+    status = symbolic4_evaluate(buffer, buffer_length, root);
+    
+    if (key != NULL && current_context->error.identifier != ERRI_BUFFER_OVERFLOW) {
+        cache_insert(current_context->cache, key, (status == RETS_SUCCESS) ? buffer : "", status, &current_context->error);
+    }
+    
+    return status;
+    
+}
+
+/**
+ 
+ @brief Evaluates a query in a context
+ 
+ @details
+ All memory of the query is taken from the arena of the context (see
+ @c smart_alloc()), which is released as a whole once the query has
+ been evaluated, even if an error occurred. Queries in different
+ contexts may be evaluated concurrently on different threads.
+ 
+ @warning
+ - The length of the result isn't bounded. Use @c symbolic4_ctx_n()
+ if the size of the buffer is known.
+ 
+ @param[in,out] context The context to evaluate the query in.
+ @param[out] buffer The buffer where the result is written into.
+ @param[in] query The query string.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ @see
+ - new_symbolic4_context()
+ - symbolic4_ctx_n()
+ 
+ */
+uint8_t symbolic4_ctx(symbolic4_context* context, char* buffer, const char* query) {
+    return symbolic4_ctx_n(context, buffer, SIZE_MAX, query);
+}
 
-    free_expression(root, false);
+/**
+ 
+ @brief Evaluates a query in a context and writes at most
+ @c buffer_length bytes of the result
+ 
+ @param[in,out] context The context to evaluate the query in.
+ @param[out] buffer The buffer where the result is written into.
+ @param[in] buffer_length The size of @c buffer in bytes.
+ @param[in] query The query string.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR. If the result doesn't fit into
+ the buffer, @c RETS_ERROR is returned and the error of the context is
+ set to @c ERRI_BUFFER_OVERFLOW. If @c context is @c NULL (see
+ @c new_symbolic4_context()), @c RETS_ERROR is returned.
+ 
+ @see
+ - symbolic4_ctx()
+ 
+ */
+uint8_t symbolic4_ctx_n(symbolic4_context* context, char* buffer, size_t buffer_length, const char* query) {
+    
+    uint8_t status;
+    symbolic4_context* previous_context = current_context;
+    
+    if (buffer_length > 0) buffer[0] = '\0';
+    if (context == NULL) return RETS_ERROR;
+    
+    current_context = context;
+    current_context->error.domain = ERRD_NULL;
+    current_context->error.identifier = ERRI_NULL;
+    update_priorities_epoch(context);
+    
+    status = symbolic4_query(buffer, buffer_length, query);
+    
+    context->allocator.is_recording = true;
     smart_free_all();
-    free(allocated_pointers);
     
-    return RETS_SUCCESS;
+    current_context = previous_context;
     
+    return status;
+    
+}
+
+/**
+ 
+ @brief Evaluates a query in the default context of the calling thread
+ 
+ @warning
+ - The length of the result isn't bounded. Use @c symbolic4_n() if the
+ size of the buffer is known.
+ 
+ @param[out] buffer The buffer where the result is written into.
+ @param[in] query The query string.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ @see
+ - symbolic4_ctx()
+ - get_default_context()
+ 
+ */
+uint8_t symbolic4(char* buffer, const char* query) {
+    return symbolic4_ctx_n(get_default_context(), buffer, SIZE_MAX, query);
+}
+
+/**
+ 
+ @brief Evaluates a query in the default context of the calling thread
+ and writes at most @c buffer_length bytes of the result
+ 
+ @param[out] buffer The buffer where the result is written into.
+ @param[in] buffer_length The size of @c buffer in bytes.
+ @param[in] query The query string.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR.
+ 
+ @see
+ - symbolic4_ctx_n()
+ 
+ */
+uint8_t symbolic4_n(char* buffer, size_t buffer_length, const char* query) {
+    return symbolic4_ctx_n(get_default_context(), buffer, buffer_length, query);
 }
 
 uint8_t process(expression* source, bool recursive) {
     
-    uint8_t i;
+    uint16_t i;
     
     for (i = 0; i < source->child_count && recursive; i++) {
         if (source->children[i] == NULL) continue;
@@ -145,7 +269,8 @@ uint8_t process_factors(expression* source) {
     
     if (source->children[0]->identifier == EXPI_LITERAL) {
         if (source->children[0]->sign == 1 && source->children[0]->value.numeric.denominator == 1) {
-            result = prime_factors(source->children[0]->value.numeric.numerator);
+            result = numeric_part_prime_factors(source->children[0]->value.numeric.numerator, source->children[0]->value.numeric.big_numerator);
+            if (result == NULL) return RETS_UNCHANGED;
         } else {
             return RETS_UNCHANGED;
         }
@@ -161,7 +286,7 @@ uint8_t process_factors(expression* source) {
 
 uint8_t process_value(expression* source) {
     
-    uint8_t i;
+    uint16_t i;
     expression* symbol;
     
     if (source->child_count < 2) {
@@ -27,17 +27,33 @@
 #define symbolic4_h
 
 #define VERSION "1.0.0"
-#define ALLOCATED_POINTERS_LENGTH 2000
+#define SMART_ALLOC_BLOCK_SIZE 65536
+#define SMART_ALLOC_CLASS_COUNT 32
+#define EXPRESSION_INLINE_CHILDREN 4
+#define EXPRESSION_MAX_CHILDREN UINT16_MAX
+#define CACHE_SHARD_COUNT 16
+#define CACHE_BUCKET_COUNT 1024
+#define SIMPLIFY_MEMO_CAPACITY 1024
+#define SIMPLIFY_MEMO_BUCKET_COUNT 2048
+#define SIMPLIFY_MEMO_MIN_SIZE 8
+#define SIMPLIFY_MEMO_MAX_SIZE 512
+#define SYMBOL_TABLE_INITIAL_BUCKET_COUNT 256
+#define HASHCONS_INITIAL_BUCKET_COUNT 1024
+#define BIGNUM_MAX_LIMBS 128
+#define BIGNUM_KARATSUBA_THRESHOLD 24
+#define FACTORIZATION_SIEVE_LIMIT 65536
+#define FACTORIZATION_SIEVE_BITS 16
+#define FACTORIZATION_CACHE_SIZE 251
+#define FACTORIZATION_MAX_PRIMES 16
+#define FACTORIZATION_RHO_BATCH 128
+#define FACTORIZATION_BIG_MAX_LIMBS 8
+#define FACTORIZATION_BIG_RHO_ITERATIONS 65536
+#define REWRITE_MAX_KEYS 16
 //#define DEBUG_MODE
 
 #ifdef _WIN32
 #elif defined(__APPLE__)
 #elif defined(__linux__)
-#define uint8_t u_int8_t
-#define uint16_t u_int16_t
-#define uint32_t u_int32_t
-#define uint64_t u_int32_t
-#define uintmax_t u_int32_t
 #elif defined(__unix__)
 #elif defined(__DOXYGEN__)
 #elif defined(_EZ80)
@@ -45,31 +61,60 @@
 #define uintmax_t uint32_t
 #endif
 
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#elif defined(_EZ80)
+#define THREAD_LOCAL
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_PTHREADS
+#endif
+
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#ifdef HAS_PTHREADS
+#include <pthread.h>
+#endif
 
 #include "foundation.h"
+#include "context.h"
+#include "symbol_table.h"
+#include "bignum.h"
 #include "expression.h"
 #include "polynomial.h"
+#include "packed_polynomial.h"
 #include "math_foundation.h"
+#include "factorization.h"
+#include "integer_root.h"
+#include "rewrite.h"
+#include "trigonometry.h"
+#include "fingerprint.h"
+#include "interval.h"
 #include "parser.h"
 #include "simplify.h"
+#include "hashcons.h"
+#include "memo.h"
 #include "solve.h"
 #include "derivative.h"
 #include "integral.h"
 #include "matrix.h"
 #include "vector.h"
-
-extern bool use_abbrevations; ///< Determines if abbrevations should be used in the result string (such as "Deriv" instead of "Derivative")
-extern bool use_spaces; ///< Determines if spaces should be used in the result string (such as "x + y * z" instead of "x+y*z")
-extern char* default_priorities;
+#include "batch.h"
+#include "cache.h"
 
 uint8_t symbolic4(char* buffer, const char* query);
+uint8_t symbolic4_n(char* buffer, size_t buffer_length, const char* query);
+uint8_t symbolic4_ctx(symbolic4_context* context, char* buffer, const char* query);
+uint8_t symbolic4_ctx_n(symbolic4_context* context, char* buffer, size_t buffer_length, const char* query);
 uint8_t process(expression* source, bool recursive);
 
 #endif /* symbolic4_h */
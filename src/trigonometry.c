@@ -0,0 +1,237 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#include "symbolic4.h"
+
+/**
+ 
+ @brief The special values of sine and tangent between 0 and pi / 2
+ 
+ @details
+ All other special values follow from symmetry and periodicity.
+ 
+ */
+const trigonometric_value trigonometric_values[] = {
+    {0, {REWRITE_LITERAL(1, 0, 1)}, {REWRITE_LITERAL(1, 0, 1)}},
+    {10, {REWRITE_ADDITION, REWRITE_SCALED_ROOT(-1, 1, 4, 2), REWRITE_SCALED_ROOT(1, 1, 4, 6)},
+        {REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 3)}},
+    {12, {REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 4), REWRITE_SCALED_ROOT(1, 1, 4, 5)},
+        {REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 5), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 25, 1), REWRITE_SCALED_ROOT(-1, 10, 1, 5), REWRITE_HALF}},
+    {15, {REWRITE_MULTIPLICATION, REWRITE_HALF, REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_SCALED_ROOT(-1, 1, 1, 2), REWRITE_HALF},
+        {REWRITE_ADDITION, REWRITE_LITERAL(-1, 1, 1), REWRITE_ROOT(2)}},
+    {20, {REWRITE_HALF}, {REWRITE_SCALED_ROOT(1, 1, 3, 3)}},
+    {24, {REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF},
+        {REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 5, 1), REWRITE_SCALED_ROOT(-1, 2, 1, 5), REWRITE_HALF}},
+    {30, {REWRITE_SCALED_ROOT(1, 1, 2, 2)}, {REWRITE_LITERAL(1, 1, 1)}},
+    {36, {REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 4), REWRITE_SCALED_ROOT(1, 1, 4, 5)},
+        {REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 5), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 25, 1), REWRITE_SCALED_ROOT(1, 10, 1, 5), REWRITE_HALF}},
+    {40, {REWRITE_SCALED_ROOT(1, 1, 2, 3)}, {REWRITE_ROOT(3)}},
+    {45, {REWRITE_MULTIPLICATION, REWRITE_HALF, REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(2), REWRITE_HALF},
+        {REWRITE_ADDITION, REWRITE_LITERAL(1, 1, 1), REWRITE_ROOT(2)}},
+    {48, {REWRITE_MULTIPLICATION, REWRITE_LITERAL(1, 1, 4), REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 10, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF},
+        {REWRITE_EXPONENTATION, REWRITE_ADDITION, REWRITE_LITERAL(1, 5, 1), REWRITE_SCALED_ROOT(1, 2, 1, 5), REWRITE_HALF}},
+    {50, {REWRITE_ADDITION, REWRITE_SCALED_ROOT(1, 1, 4, 2), REWRITE_SCALED_ROOT(1, 1, 4, 6)},
+        {REWRITE_ADDITION, REWRITE_LITERAL(1, 2, 1), REWRITE_ROOT(3)}},
+    {60, {REWRITE_LITERAL(1, 1, 1)}, {{EXPT_NULL}}}
+};
+
+/// The row of @c trigonometric_values plus one for each angle up to pi / 2 (0 if the value isn't special)
+const uint8_t trigonometric_value_rows[TRIGONOMETRY_HALF_TURN / 2 + 1] = {
+    [0] = 1, [10] = 2, [12] = 3, [15] = 4, [20] = 5, [24] = 6, [30] = 7,
+    [36] = 8, [40] = 9, [45] = 10, [48] = 11, [50] = 12, [60] = 13
+};
+
+uint8_t negate_rewrite_keys(rewrite_key* result, const rewrite_key* source);
+
+/**
+ 
+ @brief Checks if an expression is a rational multiple of pi whose
+ denominator divides @c TRIGONOMETRY_HALF_TURN
+ 
+ @details
+ Only the normalized forms @c 0, @c pi and <tt>q * pi</tt> are
+ recognized.
+ 
+ @param[out] angle The angle reduced to [0, 2 pi) in units of
+ pi / @c TRIGONOMETRY_HALF_TURN.
+ @param[in] source The expression.
+ 
+ @return
+ - Whether @c source is such a multiple.
+ 
+ */
+bool get_pi_multiple(uint16_t* angle, const expression* source) {
+    
+    const expression* factor;
+    
+    if (is_zero(source)) {
+        *angle = 0;
+        return true;
+    }
+    
+    if (is_symbol(source, SYMBOL_PI)) {
+        *angle = TRIGONOMETRY_HALF_TURN;
+        return true;
+    }
+    
+    if (source->identifier != EXPI_MULTIPLICATION || source->child_count != 2 || !is_symbol(source->children[1], SYMBOL_PI)) return false;
+    
+    factor = source->children[0];
+    
+    if (factor->identifier != EXPI_LITERAL || literal_is_big(factor)) return false;
+    if (factor->value.numeric.denominator == 0 || TRIGONOMETRY_HALF_TURN % factor->value.numeric.denominator != 0) return false;
+    
+    *angle = (uint16_t) (factor->value.numeric.numerator % (2 * factor->value.numeric.denominator) * (TRIGONOMETRY_HALF_TURN / factor->value.numeric.denominator));
+    if (factor->sign == -1 && *angle != 0) *angle = 2 * TRIGONOMETRY_HALF_TURN - *angle;
+    
+    return true;
+    
+}
+
+/**
+ 
+ @brief Writes the normalized negation of a normalized value
+ 
+ @return
+ - The number of keys written.
+ 
+ */
+uint8_t negate_rewrite_keys(rewrite_key* result, const rewrite_key* source) {
+    
+    uint8_t i;
+    uint8_t count = count_rewrite_keys(source);
+    uint8_t position = 1;
+    uint8_t source_position = 1;
+    
+    if (source[0].identifier == EXPI_LITERAL) {
+        result[0] = source[0];
+        if (result[0].numerator != 0) result[0].sign = -source[0].sign;
+        return 1;
+    }
+    
+    if (source[0].identifier == EXPI_MULTIPLICATION && source[1].identifier == EXPI_LITERAL) {
+        
+        if (source[0].child_count == 2 && source[1].sign == -1 && source[1].numerator == 1 && source[1].denominator == 1) {
+            memcpy(result, &source[2], (count - 2) * sizeof(rewrite_key));
+            return count - 2;
+        }
+        
+        memcpy(result, source, count * sizeof(rewrite_key));
+        result[1].sign = -source[1].sign;
+        
+        return count;
+        
+    }
+    
+    if (source[0].identifier == EXPI_ADDITION) {
+        
+        result[0] = source[0];
+        
+        for (i = 0; i < source[0].child_count; i++) {
+            position += negate_rewrite_keys(&result[position], &source[source_position]);
+            source_position += count_rewrite_keys(&source[source_position]);
+        }
+        
+        return position;
+        
+    }
+    
+    result[0] = (rewrite_key) REWRITE_MULTIPLICATION;
+    result[1] = (rewrite_key) REWRITE_LITERAL(-1, 1, 1);
+    memcpy(&result[2], source, count * sizeof(rewrite_key));
+    
+    return count + 2;
+    
+}
+
+/**
+ 
+ @brief Simplifies @c sin, @c cos and @c tan of special rational
+ multiples of pi
+ 
+ @details
+ The argument is reduced to [0, pi / 2] by periodicity and symmetry,
+ after which the value is looked up in @c trigonometric_values.
+ 
+ @param[in,out] source The expression.
+ 
+ @return
+ - @c RETS_SUCCESS or @c RETS_ERROR if the tangent is undefined.
+ 
+ */
+return_status simplify_trigonometric_function(expression* source) {
+    
+    uint16_t angle;
+    uint8_t row;
+    bool negative = false;
+    const rewrite_key* value;
+    rewrite_key negated_value[REWRITE_MAX_KEYS];
+    
+    if (!get_pi_multiple(&angle, source->children[0])) return RETS_SUCCESS;
+    
+    if (source->identifier == EXPI_TAN) {
+        
+        angle %= TRIGONOMETRY_HALF_TURN;
+        
+        if (angle > TRIGONOMETRY_HALF_TURN / 2) {
+            angle = TRIGONOMETRY_HALF_TURN - angle;
+            negative = true;
+        }
+        
+        row = trigonometric_value_rows[angle];
+        if (row == 0) return RETS_SUCCESS;
+        
+        value = trigonometric_values[row - 1].tangent;
+        if (value[0].type == EXPT_NULL) return set_error(ERRD_MATH, ERRI_UNDEFINED_VALUE, "tan");
+        
+    } else {
+        
+        if (source->identifier == EXPI_COS) angle = (angle + TRIGONOMETRY_HALF_TURN / 2) % (2 * TRIGONOMETRY_HALF_TURN);
+        
+        if (angle >= TRIGONOMETRY_HALF_TURN) {
+            angle -= TRIGONOMETRY_HALF_TURN;
+            negative = true;
+        }
+        
+        if (angle > TRIGONOMETRY_HALF_TURN / 2) angle = TRIGONOMETRY_HALF_TURN - angle;
+        
+        row = trigonometric_value_rows[angle];
+        if (row == 0) return RETS_SUCCESS;
+        
+        value = trigonometric_values[row - 1].sine;
+        
+    }
+    
+    if (negative) {
+        negate_rewrite_keys(negated_value, value);
+        value = negated_value;
+    }
+    
+    replace_expression(source, new_expression_from_keys(value));
+    current_context->changed = true;
+    
+    return RETS_SUCCESS;
+    
+}
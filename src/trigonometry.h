@@ -0,0 +1,52 @@
+
+/*
+ 
+ Copyright (c) 2019 Hannes Eberhard
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ 
+ */
+
+#ifndef trigonometry_h
+#define trigonometry_h
+
+#include "symbolic4.h"
+
+/// Angles are measured in units of pi / 120, so every multiple of pi whose denominator divides 120 is an integer
+#define TRIGONOMETRY_HALF_TURN 120
+
+/**
+ 
+ @brief The exact sine and tangent of an angle between 0 and pi / 2
+ 
+ @details
+ The values are written in normalized form, like the patterns of the
+ rewrite rules of the inverse functions.
+ 
+ */
+typedef struct trigonometric_value {
+    uint8_t angle; ///< In units of pi / @c TRIGONOMETRY_HALF_TURN
+    rewrite_key sine[REWRITE_MAX_KEYS];
+    rewrite_key tangent[REWRITE_MAX_KEYS]; ///< An empty tangent (@c EXPT_NULL) is undefined
+} trigonometric_value;
+
+bool get_pi_multiple(uint16_t* angle, const expression* source);
+return_status simplify_trigonometric_function(expression* source);
+
+#endif /* trigonometry_h */
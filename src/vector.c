@@ -27,7 +27,7 @@
 
 uint8_t vector_magnitude(expression** result, expression* source, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
     
     *result = new_expression(EXPT_OPERATION, EXPI_EXPONENTATION, 2,
                              new_expression(EXPT_OPERATION, EXPI_ADDITION, 0),
@@ -49,7 +49,7 @@ uint8_t vector_magnitude(expression** result, expression* source, bool persisten
 
 uint8_t vector_normalized(expression** result, expression* source, expression* magnitude, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
     expression* source_magnitude;
     expression* factor;
     
@@ -109,7 +109,7 @@ uint8_t vector_angle(expression** result, expression* source_1, expression* sour
 
 uint8_t vector_dot_product(expression** result, expression* source_1, expression* source_2, bool persistent) {
     
-    uint8_t i;
+    uint16_t i;
     
     *result = new_expression(EXPT_OPERATION, EXPI_ADDITION, 0);
     
@@ -132,7 +132,7 @@ uint8_t vector_dot_product(expression** result, expression* source_1, expression
 
 uint8_t vector_cross_product(expression** result, expression* source_1, expression* source_2, bool persistent) {
     
-    uint8_t i, j, k;
+    uint16_t i, j, k;
     
     *result = new_expression(EXPT_STRUCTURE, EXPI_LIST, 0);
     
@@ -9,7 +9,7 @@ test_data = []
 log_string = ""
 
 os.system("git pull")
-os.system("gcc -o test ../src/*.c test.c -lm")
+os.system("gcc -o test ../src/*.c test.c -lm -lpthread")
 
 contents = open('test_data.txt', 'r').read()#.replace('(', '\(').replace(')', '\)')
 
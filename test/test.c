@@ -6,7 +6,7 @@ int main(int argc, const char * argv[]) {
     
     uint8_t verbose;
     clock_t clock_reference = 0;
-    char buffer[50];
+    char buffer[256];
     uint8_t status = 0;
     
     uint8_t i;
@@ -16,14 +16,14 @@ int main(int argc, const char * argv[]) {
         return 1;
     }
     
-    verbose = (uint8_t) argv[1];
+    verbose = (uint8_t) atoi(argv[1]);
     
     if (verbose) {
         printf("%-20s ?= %-20s | ", argv[2], argv[3]);
         clock_reference = clock();
     }
     
-    status = symbolic4(buffer, (char*) argv[2]);
+    status = symbolic4_n(buffer, sizeof(buffer), (char*) argv[2]);
     
     if (verbose) {
         